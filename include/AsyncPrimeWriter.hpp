@@ -0,0 +1,178 @@
+#ifndef ASYNC_PRIME_WRITER_HPP
+#define ASYNC_PRIME_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/**
+ * @struct OutputStats
+ * @brief Throughput figures for a completed prime dump.
+ */
+struct OutputStats {
+    std::size_t primesWritten = 0;
+    std::size_t bytesWritten = 0;
+    double seconds = 0.0;
+    std::string backend;
+
+    /**
+     * @brief Get the sustained output throughput.
+     * @return Throughput in MB/s (10^6 bytes per second).
+     */
+    double throughputMBps() const {
+        return seconds > 0.0 ? static_cast<double>(bytesWritten) / seconds / 1e6 : 0.0;
+    }
+};
+
+/**
+ * @class AsyncPrimeWriter
+ * @brief Buffered asynchronous writer for newline-separated prime listings.
+ *
+ * Primes are formatted into one of several large buffers while previously
+ * filled buffers are written to disk in the background, so formatting and
+ * disk I/O overlap. When the library is built with liburing the buffers are
+ * submitted through io_uring; otherwise a dedicated writer thread issues
+ * pwrite() calls.
+ */
+class AsyncPrimeWriter {
+public:
+    /**
+     * @enum Backend
+     * @brief Selects the mechanism used to move buffers to disk.
+     */
+    enum class Backend {
+        Auto,     ///< io_uring when available, writer thread otherwise
+        IoUring,  ///< io_uring only (open() fails if unavailable)
+        Thread    ///< Background thread issuing pwrite()
+    };
+
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = 4 * 1024 * 1024;  // 4 MiB
+    static constexpr std::size_t DEFAULT_BUFFER_COUNT = 4;
+
+    /**
+     * @brief Construct a writer.
+     * @param bufferSize Size of each output buffer in bytes.
+     * @param bufferCount Number of buffers kept in flight.
+     * @param backend I/O backend to use.
+     */
+    explicit AsyncPrimeWriter(std::size_t bufferSize = DEFAULT_BUFFER_SIZE,
+                              std::size_t bufferCount = DEFAULT_BUFFER_COUNT,
+                              Backend backend = Backend::Auto);
+
+    /**
+     * @brief Destructor; flushes and closes the file if still open.
+     */
+    ~AsyncPrimeWriter();
+
+    AsyncPrimeWriter(const AsyncPrimeWriter&) = delete;
+    AsyncPrimeWriter& operator=(const AsyncPrimeWriter&) = delete;
+
+    /**
+     * @brief Create (or truncate) the output file and start the backend.
+     * @param filename The name of the file to write to.
+     * @return True if successful, false otherwise.
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief Append a prime followed by a newline.
+     * @param prime The prime to write.
+     */
+    inline void write(std::size_t prime) {
+        if (dropping) {
+            return;
+        }
+        if (fill + MAX_RECORD_SIZE > bufferSize) {
+            submitCurrent();
+        }
+        char digits[MAX_RECORD_SIZE];
+        std::size_t n = 0;
+        do {
+            digits[n++] = static_cast<char>('0' + prime % 10);
+            prime /= 10;
+        } while (prime != 0);
+        char* out = current + fill;
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = digits[n - 1 - i];
+        }
+        out[n] = '\n';
+        fill += n + 1;
+        ++stats.primesWritten;
+    }
+
+    /**
+     * @brief Flush all buffers, wait for outstanding I/O and close the file.
+     * @return True if every write succeeded, false otherwise.
+     */
+    bool close();
+
+    /**
+     * @brief Get statistics for the data written so far.
+     * @return Output statistics (complete once close() returned).
+     */
+    const OutputStats& getStats() const { return stats; }
+
+    /**
+     * @brief Check whether this build can use the io_uring backend.
+     * @return True if io_uring support was compiled in and a ring can be created.
+     */
+    static bool ioUringAvailable();
+
+private:
+    // Largest decimal representation of a 64-bit value plus the newline
+    static constexpr std::size_t MAX_RECORD_SIZE = 21;
+
+    struct PendingWrite {
+        std::size_t buffer;
+        std::size_t length;
+        std::uint64_t offset;
+        std::size_t done;
+    };
+
+    std::size_t bufferSize;
+    std::size_t bufferCount;
+    Backend requestedBackend;
+    std::vector<std::vector<char>> buffers;
+    char* current = nullptr;
+    std::size_t currentIndex = 0;
+    std::size_t fill = 0;
+    std::uint64_t fileOffset = 0;
+    int fd = -1;
+    bool failed = false;
+    bool dropping = false;   // No buffer left to format into; close() reports the failure
+    bool usingIoUring = false;
+    OutputStats stats;
+    std::chrono::steady_clock::time_point startTime;
+
+    // Writer thread backend
+    std::thread writerThread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<PendingWrite> pending;
+    std::vector<std::size_t> freeBuffers;
+    bool stopping = false;
+
+    // io_uring backend (opaque to avoid exposing liburing in the header)
+    void* ring = nullptr;
+    std::size_t inFlight = 0;
+    std::vector<PendingWrite> inflightWrites;
+
+    void flushCurrent();
+    void submitCurrent();
+    bool acquireBuffer(std::size_t& index);
+    void writerLoop();
+    bool writeFully(const char* data, std::size_t length, std::uint64_t offset);
+
+    bool startIoUring();
+    void submitIoUring(const PendingWrite& write);
+    bool reapIoUring(bool wait);
+    void stopIoUring();
+};
+
+#endif // ASYNC_PRIME_WRITER_HPP
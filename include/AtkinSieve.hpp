@@ -0,0 +1,187 @@
+#ifndef ATKIN_SIEVE_HPP
+#define ATKIN_SIEVE_HPP
+
+#include "AsyncPrimeWriter.hpp"
+#include "SieveStats.hpp"
+#include "SievingPrimes.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class AtkinSieve
+ * @brief Segmented, bit-packed implementation of the Sieve of Atkin.
+ *
+ * A number n > 3 is prime if it is square-free and the number of solutions of
+ * 4x^2 + y^2 = n (n mod 12 in {1, 5}), 3x^2 + y^2 = n (n mod 12 = 7) or
+ * 3x^2 - y^2 = n with x > y (n mod 12 = 11) is odd. The range is processed in
+ * L2-sized segments (see CacheTopology): the solutions of the quadratic forms in a
+ * segment are toggled, then the multiples of p^2 are cleared for every prime
+ * p <= sqrt(limit), each continuing from the multiple the previous segment
+ * stopped at. Bit n of the array stands for the number n, as in BitSieve.
+ */
+class AtkinSieve {
+private:
+    std::vector<uint64_t> bits;
+    std::size_t limit;
+    std::size_t segmentSize;
+    bool generated;
+    mutable SieveStats stats;
+
+    /**
+     * @brief Call a visitor with every prime up to the limit, in ascending order.
+     * @param visit Callable taking the prime.
+     */
+    template <typename Visitor>
+    void forEachPrime(Visitor visit) const;
+
+protected:
+    /**
+     * @brief Get the numbers per segment: this CPU's share of L2 in bits, the medium-prime tier boundary.
+     * @return The segment size, a multiple of 64.
+     */
+    std::size_t getSegmentSize() const { return segmentSize; }
+
+    /**
+     * @brief Get the bits array for derived classes.
+     * @return Reference to the bits array.
+     */
+    std::vector<uint64_t>& getBits() { return bits; }
+
+    /**
+     * @brief Get the bits array for derived classes (const version).
+     * @return Const reference to the bits array.
+     */
+    const std::vector<uint64_t>& getBits() const { return bits; }
+
+    /**
+     * @brief Set the generated flag for derived classes.
+     * @param val The value to set.
+     */
+    void setGenerated(bool val) { generated = val; }
+
+    /**
+     * @brief Get the phase statistics for derived classes.
+     * @return Mutable reference to the statistics.
+     */
+    SieveStats& getMutableStats() const { return stats; }
+
+    /**
+     * @brief Find the primes 5 <= p <= sqrtLimit whose squares are cleared.
+     * @param sqrtLimit Floor of sqrt(limit).
+     * @return Sieving primes in ascending order.
+     */
+    std::vector<std::size_t> findBasePrimes(std::size_t sqrtLimit);
+
+    /**
+     * @brief Toggle the bits of the solutions of the three quadratic forms in [low, high].
+     *
+     * Touches only the words covering [low, high]; callers running segments
+     * concurrently must align them to 64 numbers.
+     * @param low First number of the segment.
+     * @param high Last number of the segment (at most the limit).
+     * @return Number of bits toggled.
+     */
+    std::size_t toggleQuadraticForms(std::size_t low, std::size_t high);
+
+    /**
+     * @brief Seed the next multiple of prime^2 of every sieving prime.
+     * @param state Sieving state whose multiples become the first multiples of p^2 at or above low.
+     * @param low First number of the range about to be sieved.
+     */
+    static void seedSquares(SievingPrimes& state, std::size_t low);
+
+    /**
+     * @brief Clear the multiples of prime^2 up to high, continuing from the saved multiple.
+     * @param prime A sieving prime.
+     * @param multiple Next multiple of prime^2 to clear; left at the first one past high.
+     * @param high Last number of the segment.
+     * @return Number of multiples cleared.
+     */
+    std::size_t eliminateSquares(std::size_t prime, std::size_t& multiple, std::size_t high);
+
+    /**
+     * @brief Count the set bits in [low, high] a word at a time.
+     * @param low First number (inclusive).
+     * @param high Last number (inclusive, at most the limit).
+     * @return Number of primes in the range.
+     */
+    std::size_t countBits(std::size_t low, std::size_t high) const;
+
+public:
+    /**
+     * @brief Construct an AtkinSieve with the specified upper limit.
+     * @param n The upper limit for finding prime numbers.
+     */
+    explicit AtkinSieve(std::size_t n);
+
+    /**
+     * @brief Virtual destructor for proper polymorphic cleanup.
+     */
+    virtual ~AtkinSieve() = default;
+
+    /**
+     * @brief Generate all prime numbers up to the limit, one segment at a time.
+     */
+    virtual void generate();
+
+    /**
+     * @brief Get a vector of all prime numbers found.
+     * @return A vector containing all prime numbers up to the limit.
+     */
+    std::vector<std::size_t> getPrimes();
+
+    /**
+     * @brief Check if a specific number is prime.
+     * @param num The number to check.
+     * @return True if the number is prime, false otherwise.
+     */
+    bool isPrime(std::size_t num);
+
+    /**
+     * @brief Get the count of prime numbers found.
+     * @return The count of prime numbers up to the limit.
+     */
+    std::size_t getPrimeCount();
+
+    /**
+     * @brief Get the upper limit for this sieve.
+     * @return The upper limit.
+     */
+    std::size_t getLimit() const { return limit; }
+
+    /**
+     * @brief Check if the sieve has been generated.
+     * @return True if the sieve has been generated, false otherwise.
+     */
+    bool isGenerated() const { return generated; }
+
+    /**
+     * @brief Get per-phase timings, toggle and square-elimination counts.
+     * @return The statistics recorded so far.
+     */
+    const SieveStats& getStats() const { return stats; }
+
+    /**
+     * @brief Get the memory usage in bytes.
+     * @return The memory usage in bytes.
+     */
+    std::size_t getMemoryUsage() const;
+
+    /**
+     * @brief Print prime numbers to stdout.
+     * @param perLine Number of primes to print per line (default: 10).
+     */
+    void printPrimes(std::size_t perLine = 10) const;
+
+    /**
+     * @brief Save prime numbers to a file.
+     * @param filename The name of the file to save to.
+     * @param outputStats Optional destination for output throughput statistics.
+     * @return True if successful, false otherwise.
+     */
+    bool savePrimesToFile(const std::string& filename, OutputStats* outputStats = nullptr) const;
+};
+
+#endif // ATKIN_SIEVE_HPP
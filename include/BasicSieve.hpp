@@ -1,6 +1,8 @@
 #ifndef BASIC_SIEVE_HPP
 #define BASIC_SIEVE_HPP
 
+#include "AsyncPrimeWriter.hpp"
+#include "SieveStats.hpp"
 #include <vector>
 #include <cstddef>
 #include <string>
@@ -17,6 +19,7 @@ private:
     std::vector<bool> sieve;
     std::size_t limit;
     bool generated;
+    mutable SieveStats stats;
 
 protected:
     /**
@@ -37,6 +40,19 @@ protected:
      */
     void setGenerated(bool val) { generated = val; }
 
+    /**
+     * @brief Get the phase statistics for derived classes.
+     * @return Mutable reference to the statistics.
+     */
+    SieveStats& getMutableStats() const { return stats; }
+
+    /**
+     * @brief Sieve [2, sqrtLimit] and collect the primes used for crossing off.
+     * @param sqrtLimit Upper bound of the base range (floor of sqrt(limit)).
+     * @return Sieving primes in ascending order.
+     */
+    std::vector<std::size_t> findBasePrimes(std::size_t sqrtLimit);
+
 public:
     /**
      * @brief Construct a BasicSieve with the specified upper limit.
@@ -85,6 +101,18 @@ public:
      */
     bool isGenerated() const { return generated; }
 
+    /**
+     * @brief Get per-phase timings and crossing-off counts.
+     * @return The statistics recorded so far.
+     */
+    const SieveStats& getStats() const { return stats; }
+
+    /**
+     * @brief Get the memory usage in bytes.
+     * @return The memory usage in bytes (one bit per integer up to the limit).
+     */
+    std::size_t getMemoryUsage() const;
+
     /**
      * @brief Print prime numbers to stdout.
      * @param perLine Number of primes to print per line (default: 10).
@@ -94,9 +122,10 @@ public:
     /**
      * @brief Save prime numbers to a file.
      * @param filename The name of the file to save to.
+     * @param outputStats Optional destination for output throughput statistics.
      * @return True if successful, false otherwise.
      */
-    bool savePrimesToFile(const std::string& filename) const;
+    bool savePrimesToFile(const std::string& filename, OutputStats* outputStats = nullptr) const;
 };
 
 #endif // BASIC_SIEVE_HPP
\ No newline at end of file
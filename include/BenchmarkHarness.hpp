@@ -0,0 +1,352 @@
+#ifndef BENCHMARK_HARNESS_HPP
+#define BENCHMARK_HARNESS_HPP
+
+#include "MemoryTracker.hpp"
+#include "PerfCounters.hpp"
+#include "PrimeOracle.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct SampleSummary
+ * @brief Robust summary statistics for a set of timing samples (milliseconds).
+ */
+struct SampleSummary {
+    std::size_t count = 0;
+    double median = 0.0;
+    double mad = 0.0;       ///< Median absolute deviation from the median
+    double mean = 0.0;
+    double stddev = 0.0;
+    double min = 0.0;
+    double max = 0.0;
+    double ciLow = 0.0;     ///< Lower bound of the confidence interval for the median
+    double ciHigh = 0.0;    ///< Upper bound of the confidence interval for the median
+
+    /**
+     * @brief Summarize a set of samples.
+     *
+     * The confidence interval for the median is distribution-free: it is
+     * taken from the order statistics whose ranks bracket the median with
+     * the requested coverage under the binomial(n, 1/2) model.
+     *
+     * @param samples The samples to summarize.
+     * @param confidence Coverage of the confidence interval (e.g. 0.95).
+     * @return The summary.
+     */
+    static SampleSummary fromSamples(std::vector<double> samples, double confidence = 0.95);
+};
+
+/**
+ * @struct PhaseSample
+ * @brief Wall-clock time of each phase of a single benchmark repetition (milliseconds).
+ */
+struct PhaseSample {
+    double construct = 0.0;
+    double generate = 0.0;
+    double extract = 0.0;
+
+    double total() const { return construct + generate + extract; }
+};
+
+/**
+ * @struct EngineResult
+ * @brief All repetitions and their summaries for one engine configuration.
+ */
+struct EngineResult {
+    std::string engine;
+    std::string variant;  ///< "sequential", "parallel", or the --affinity placement of a pinned parallel run
+    std::size_t limit = 0;
+    int threads = 1;
+    std::size_t memoryBytes = 0;
+    std::size_t peakHeapBytes = 0;  ///< Highest live heap of a repetition (0 without the allocator hook)
+    std::size_t primeCount = 0;
+    std::vector<PhaseSample> samples;
+    SampleSummary construct;
+    SampleSummary generate;
+    SampleSummary extract;
+    SampleSummary total;
+    std::string perfText;  ///< Hardware counter table from the instrumented run (if enabled)
+    std::string perfJson;  ///< Hardware counters as JSON (if enabled)
+    PrimeDigest digest;        ///< Fingerprint of the prime set (if validated)
+    std::string validation;    ///< Empty if not validated, otherwise the verdict
+    bool validationFailed = false;
+
+    /**
+     * @brief Recompute the per-phase summaries from the recorded samples.
+     * @param confidence Coverage of the confidence intervals.
+     */
+    void summarize(double confidence);
+};
+
+/**
+ * @enum ScalingMode
+ * @brief How scaling metrics are derived from a set of results.
+ */
+enum class ScalingMode {
+    None,    ///< No sweep; only per-engine results are reported
+    Strong,  ///< Fixed limit, varying threads (baseline: 1 thread at the same limit)
+    Weak,    ///< Limit grows with threads (baseline: 1 thread at the base limit)
+    Size     ///< Varying limit (baseline: sequential engine at the same limit)
+};
+
+/**
+ * @struct ScalingPoint
+ * @brief Derived scaling metrics for one engine configuration.
+ */
+struct ScalingPoint {
+    std::string engine;
+    std::string variant;
+    std::size_t limit = 0;
+    int threads = 1;
+    double totalMs = 0.0;
+    double generateMs = 0.0;
+    double speedup = 1.0;        ///< Baseline time / this time (scaled by threads for weak scaling)
+    double efficiency = 1.0;     ///< speedup / threads
+    double karpFlatt = 0.0;      ///< Experimentally determined serial fraction (threads > 1 only)
+    double nsPerInteger = 0.0;   ///< Total time per integer in [0, limit]
+    double generateNsPerInteger = 0.0;
+};
+
+/**
+ * @struct BenchmarkConfig
+ * @brief Repetition and output settings shared by every measured engine.
+ */
+struct BenchmarkConfig {
+    std::size_t warmup = 2;
+    std::size_t repetitions = 10;
+    double confidence = 0.95;
+    bool extractList = true;  ///< Time getPrimes() (true) or getPrimeCount() (false)
+    std::string label;        ///< Free-form tag stored with the results (e.g. a branch name)
+    ScalingMode scaling = ScalingMode::None;
+    bool perfCounters = false;  ///< Collect hardware counters in one extra, untimed repetition
+    bool validate = false;      ///< Check counts against PrimeOracle and prime-set digests across engines
+};
+
+/**
+ * @struct HostInfo
+ * @brief Description of the machine a benchmark ran on, stored with the results.
+ */
+struct HostInfo {
+    std::string hostname;
+    std::string cpuModel;
+    std::string compiler;
+    std::string revision;
+    std::string governor;   ///< cpufreq scaling governor of cpu0 (empty if unknown)
+    std::string boost;      ///< "enabled", "disabled" or empty if unknown
+    int logicalCores = 0;
+    int physicalCores = 0;
+    int maxThreads = 0;
+    std::string timestamp;
+
+    /**
+     * @brief Collect information about the current host.
+     * @return The detected host information.
+     */
+    static HostInfo detect();
+
+    /**
+     * @brief Identify the class of machine, for selecting a comparable baseline.
+     * @return A file-name-safe slug of the CPU model and logical core count
+     *         (e.g. "intel-r-xeon-r-gold-6338-cpu-2-00ghz-128cpu").
+     */
+    std::string hostClass() const;
+};
+
+/**
+ * @class BenchmarkHarness
+ * @brief Repeated, phase-resolved timing of sieve engines with robust statistics.
+ *
+ * Each engine is run for a number of untimed warmup iterations followed by
+ * timed repetitions. Construction (allocation and initialization), generate()
+ * and result extraction are timed separately so that allocation does not
+ * hide differences in the sieving kernels.
+ */
+class BenchmarkHarness {
+private:
+    BenchmarkConfig config;
+    HostInfo host;
+    std::vector<EngineResult> results;
+    std::map<std::size_t, std::size_t> referenceResults;  // limit -> index of the first result that passed
+
+    /**
+     * @brief Check repetition counts against the oracle and the digest against the reference engine.
+     * @param result Result to annotate with the verdict.
+     * @param counts Prime count of every repetition.
+     */
+    void validateResult(EngineResult& result, const std::vector<std::size_t>& counts);
+
+    static double elapsedMs(std::chrono::steady_clock::time_point start,
+                            std::chrono::steady_clock::time_point end) {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+public:
+    /**
+     * @brief Construct a harness.
+     * @param cfg Repetition and output settings.
+     */
+    explicit BenchmarkHarness(const BenchmarkConfig& cfg)
+        : config(cfg), host(HostInfo::detect()) {}
+
+    /**
+     * @brief Benchmark one engine configuration.
+     * @tparam Sieve Engine type (must provide generate/getPrimes/getPrimeCount/getMemoryUsage).
+     * @tparam Factory Callable returning std::unique_ptr<Sieve>.
+     * @param engine Engine name used in the output.
+     * @param variant "sequential", "parallel" or a pinned placement ("physical", "compact", "scatter").
+     * @param limit Upper limit being sieved.
+     * @param threads Number of threads the engine uses.
+     * @param makeSieve Factory constructing a fresh engine.
+     * @return Reference to the stored result.
+     */
+    template <typename Sieve, typename Factory>
+    const EngineResult& run(const std::string& engine, const std::string& variant,
+                            std::size_t limit, int threads, Factory makeSieve) {
+        EngineResult result;
+        result.engine = engine;
+        result.variant = variant;
+        result.limit = limit;
+        result.threads = threads;
+        std::vector<std::size_t> counts;
+
+        for (std::size_t rep = 0; rep < config.warmup + config.repetitions; ++rep) {
+            PhaseSample sample;
+
+            std::size_t heapBefore = MemoryTracker::liveBytes();
+            MemoryTracker::resetPeak();
+
+            auto t0 = std::chrono::steady_clock::now();
+            std::unique_ptr<Sieve> sieve = makeSieve();
+            auto t1 = std::chrono::steady_clock::now();
+            sieve->generate();
+            auto t2 = std::chrono::steady_clock::now();
+            std::size_t count = 0;
+            if (config.extractList) {
+                count = sieve->getPrimes().size();
+            } else {
+                count = sieve->getPrimeCount();
+            }
+            auto t3 = std::chrono::steady_clock::now();
+
+            sample.construct = elapsedMs(t0, t1);
+            sample.generate = elapsedMs(t1, t2);
+            sample.extract = elapsedMs(t2, t3);
+            result.primeCount = count;
+            result.memoryBytes = sieve->getMemoryUsage();
+            result.peakHeapBytes = std::max(result.peakHeapBytes, MemoryTracker::peakBytes() - heapBefore);
+            counts.push_back(count);
+
+            if (rep >= config.warmup) {
+                result.samples.push_back(sample);
+            }
+        }
+
+        if (config.perfCounters) {
+            // Separate run so that counter setup never perturbs the timed samples
+            ThreadPerfCounters counters(threads);
+            counters.beginPhase("construct");
+            std::unique_ptr<Sieve> sieve = makeSieve();
+            counters.endPhase();
+            counters.beginPhase("generate");
+            sieve->generate();
+            counters.endPhase();
+            counters.beginPhase("extract");
+            if (config.extractList) {
+                sieve->getPrimes();
+            } else {
+                sieve->getPrimeCount();
+            }
+            counters.endPhase();
+            result.perfText = counters.toText();
+            result.perfJson = counters.isAvailable() ? counters.toJson() : "null";
+        }
+
+        if (config.validate) {
+            // Untimed run that materializes the list for the prime-set digest
+            std::unique_ptr<Sieve> sieve = makeSieve();
+            sieve->generate();
+            result.digest = PrimeDigest::of(sieve->getPrimes());
+            validateResult(result, counts);
+        }
+
+        result.summarize(config.confidence);
+        results.push_back(std::move(result));
+        if (config.validate && !results.back().validationFailed &&
+            referenceResults.find(limit) == referenceResults.end()) {
+            referenceResults[limit] = results.size() - 1;
+        }
+        return results.back();
+    }
+
+    /**
+     * @brief Get all results recorded so far.
+     * @return The results in the order they were measured.
+     */
+    const std::vector<EngineResult>& getResults() const { return results; }
+
+    /**
+     * @brief Get the detected host information.
+     * @return Host information.
+     */
+    const HostInfo& getHostInfo() const { return host; }
+
+    /**
+     * @brief Derive speedup, efficiency, Karp-Flatt serial fraction and ns per integer.
+     *
+     * Baselines depend on the configured ScalingMode; results without a
+     * matching baseline keep a speedup of 1.
+     *
+     * @return One scaling point per recorded result.
+     */
+    std::vector<ScalingPoint> computeScaling() const;
+
+    /**
+     * @brief Check whether any validated result disagreed with the oracle or the reference.
+     * @return True if at least one engine produced a wrong result.
+     */
+    bool hasValidationFailures() const;
+
+    /**
+     * @brief Print the validation verdict of every result.
+     * @param os The stream to print to.
+     */
+    void writeValidationReport(std::ostream& os) const;
+
+    /**
+     * @brief Print CPU frequency scaling advice when the host is not set up for stable timing.
+     * @param os The stream to print to.
+     */
+    void printFrequencyGuidance(std::ostream& os) const;
+
+    /**
+     * @brief Print a human-readable table of the results, including speedups.
+     * @param os The stream to print to.
+     */
+    void writeTable(std::ostream& os) const;
+
+    /**
+     * @brief Write the results and host information as JSON.
+     * @param os The stream to write to.
+     */
+    void writeJson(std::ostream& os) const;
+
+    /**
+     * @brief Write one CSV row per engine configuration and phase.
+     * @param os The stream to write to.
+     */
+    void writeCsv(std::ostream& os) const;
+
+    /**
+     * @brief Write the derived scaling metrics as CSV, one row per engine configuration.
+     * @param os The stream to write to.
+     */
+    void writeScalingCsv(std::ostream& os) const;
+};
+
+#endif // BENCHMARK_HARNESS_HPP
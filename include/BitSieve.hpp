@@ -1,11 +1,43 @@
 #ifndef BIT_SIEVE_HPP
 #define BIT_SIEVE_HPP
 
+#include "AsyncPrimeWriter.hpp"
+#include "SieveStats.hpp"
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <cstddef>
 #include <cstdint>
 #include <string>
 
+class TieredCrossOff;
+
+/**
+ * @struct StepBudget
+ * @brief How much work one BitSieve::generateStep() call may do.
+ *
+ * A step always sieves at least one segment and checks the time after each
+ * segment, so it can overrun the time budget by up to one segment.
+ */
+struct StepBudget {
+    std::size_t segments = 0;           ///< Most segments per step (0 for no limit)
+    std::chrono::nanoseconds time{0};   ///< Time after which the step returns (0 for no limit)
+
+    /// Budget of a number of segments
+    static StepBudget ofSegments(std::size_t segments) {
+        StepBudget budget;
+        budget.segments = segments;
+        return budget;
+    }
+
+    /// Budget of wall time
+    static StepBudget ofTime(std::chrono::nanoseconds time) {
+        StepBudget budget;
+        budget.time = time;
+        return budget;
+    }
+};
+
 /**
  * @class BitSieve
  * @brief Optimized implementation of the Sieve of Eratosthenes using bit manipulation.
@@ -20,6 +52,9 @@ private:
     std::size_t limit;
     std::size_t bitCount;
     bool generated;
+    mutable SieveStats stats;
+    std::unique_ptr<TieredCrossOff> stepper;   // Pass in progress between generateStep() calls
+    std::size_t frontier = 0;                  // Every number up to it is final
 
 protected:
     /**
@@ -45,6 +80,27 @@ protected:
      * @param val The value to set.
      */
     void setGenerated(bool val) { generated = val; }
+
+    /**
+     * @brief Get the phase statistics for derived classes.
+     * @return Mutable reference to the statistics.
+     */
+    SieveStats& getMutableStats() const { return stats; }
+
+    /**
+     * @brief Sieve [2, sqrtLimit] and collect the primes used for crossing off.
+     * @param sqrtLimit Upper bound of the base range (floor of sqrt(limit)).
+     * @return Sieving primes in ascending order.
+     */
+    std::vector<std::size_t> findBasePrimes(std::size_t sqrtLimit);
+
+    /**
+     * @brief Count the set bits in [low, high] a word at a time.
+     * @param low First index (inclusive).
+     * @param high Last index (inclusive, at most the limit).
+     * @return Number of primes in the range.
+     */
+    std::size_t countBits(std::size_t low, std::size_t high) const;
     
     /**
      * @brief Get the value of a bit at the specified index.
@@ -87,13 +143,32 @@ public:
     /**
      * @brief Virtual destructor for proper polymorphic cleanup.
      */
-    virtual ~BitSieve() = default;
+    virtual ~BitSieve();
 
     /**
      * @brief Generate all prime numbers up to the limit using bit manipulation.
+     *
+     * Finishes a pass started with generateStep() where it left off.
      */
     virtual void generate();
 
+    /**
+     * @brief Advance the sieve by a bounded amount of work and return.
+     *
+     * The first step also finds the sieving primes; later steps resume at the
+     * frontier. Lets a single-threaded event loop interleave sieving with other
+     * work, while isPrime() already answers for numbers up to getFrontier().
+     * @param budget Segments or time this step may use.
+     * @return True once the whole sieve is generated.
+     */
+    bool generateStep(const StepBudget& budget);
+
+    /**
+     * @brief Get the largest number whose primality is already final.
+     * @return The limit once generated, otherwise how far generateStep() got (0 before the first step).
+     */
+    std::size_t getFrontier() const { return generated ? limit : frontier; }
+
     /**
      * @brief Get a vector of all prime numbers found.
      * @return A vector containing all prime numbers up to the limit.
@@ -102,6 +177,8 @@ public:
 
     /**
      * @brief Check if a specific number is prime.
+     *
+     * Numbers up to getFrontier() are answered without finishing the sieve.
      * @param num The number to check.
      * @return True if the number is prime, false otherwise.
      */
@@ -125,6 +202,12 @@ public:
      */
     bool isGenerated() const { return generated; }
 
+    /**
+     * @brief Get per-phase timings and crossing-off counts.
+     * @return The statistics recorded so far.
+     */
+    const SieveStats& getStats() const { return stats; }
+
     /**
      * @brief Get the memory usage in bytes.
      * @return The memory usage in bytes.
@@ -140,9 +223,10 @@ public:
     /**
      * @brief Save prime numbers to a file.
      * @param filename The name of the file to save to.
+     * @param outputStats Optional destination for output throughput statistics.
      * @return True if successful, false otherwise.
      */
-    bool savePrimesToFile(const std::string& filename) const;
+    bool savePrimesToFile(const std::string& filename, OutputStats* outputStats = nullptr) const;
 };
 
 #endif // BIT_SIEVE_HPP
\ No newline at end of file
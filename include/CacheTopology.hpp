@@ -0,0 +1,138 @@
+#ifndef CACHE_TOPOLOGY_HPP
+#define CACHE_TOPOLOGY_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CacheLevel
+ * @brief One cache of the CPU the program runs on.
+ */
+struct CacheLevel {
+    int level = 0;
+    std::string type;           ///< "Data", "Instruction" or "Unified"
+    std::size_t sizeBytes = 0;
+    std::size_t lineBytes = 0;
+    int sharedCpus = 1;         ///< Logical CPUs sharing one instance of the cache
+};
+
+/**
+ * @class CacheTopology
+ * @brief Cache sizes of the host, and the sieve segment sizes derived from them.
+ *
+ * Caches are read from sysfs (/sys/devices/system/cpu/cpu0/cache), from
+ * CPUID leaf 4 (0x8000001D on AMD) when sysfs is unavailable, and fall back
+ * to a 32 KiB L1d / 256 KiB L2 / 8 MiB L3 host otherwise. Every engine stores
+ * one bit per sieve index, so sizes are converted to indices at 8 per byte:
+ * a block fills the L1d cache, a segment fills this CPU's share of L2.
+ */
+class CacheTopology {
+private:
+    std::vector<CacheLevel> caches;
+    std::string source = "default";
+
+    static std::atomic<std::size_t> segmentOverride;
+
+public:
+    static constexpr std::size_t DEFAULT_L1D_BYTES = 32 * 1024;
+    static constexpr std::size_t DEFAULT_L2_BYTES = 256 * 1024;
+    static constexpr std::size_t DEFAULT_L3_BYTES = 8 * 1024 * 1024;
+    static constexpr std::size_t DEFAULT_LINE_BYTES = 64;
+
+    /**
+     * @brief Read the caches of one CPU from its sysfs directory.
+     * @param cacheDir Directory holding index0, index1, ... (e.g. /sys/devices/system/cpu/cpu0/cache).
+     * @return The caches found; empty if the directory is missing.
+     */
+    static CacheTopology fromSysfs(const std::string& cacheDir);
+
+    /**
+     * @brief Read the caches with the CPUID deterministic cache parameters leaf.
+     * @return The caches found; empty on non-x86 hosts.
+     */
+    static CacheTopology fromCpuid();
+
+    /**
+     * @brief Detect the caches, trying sysfs, then CPUID, then the defaults.
+     * @return The detected topology.
+     */
+    static CacheTopology detect();
+
+    /**
+     * @brief Get the topology of this host, detected on first use.
+     * @return The shared topology.
+     */
+    static const CacheTopology& host();
+
+    /**
+     * @brief Force the segment size of every engine (the --segment-size option).
+     * @param indices Sieve indices per segment, rounded down to a multiple of 64; 0 restores the detected size.
+     */
+    static void setSegmentOverride(std::size_t indices);
+
+    /**
+     * @brief Get the detected caches, ordered by level.
+     * @return The caches.
+     */
+    const std::vector<CacheLevel>& getCaches() const { return caches; }
+
+    /**
+     * @brief Get where the sizes came from.
+     * @return "sysfs", "cpuid" or "default".
+     */
+    const std::string& getSource() const { return source; }
+
+    /**
+     * @brief Find the data (or unified) cache of a level.
+     * @param level Cache level (1, 2 or 3).
+     * @return The cache, or nullptr if the host has none.
+     */
+    const CacheLevel* find(int level) const;
+
+    /// Size of the L1 data cache in bytes
+    std::size_t l1dBytes() const;
+
+    /// Share of the L2 cache available to one logical CPU, in bytes
+    std::size_t l2BytesPerCpu() const;
+
+    /// Share of the last-level cache available to one logical CPU, in bytes
+    std::size_t l3BytesPerCpu() const;
+
+    /// Cache line size in bytes
+    std::size_t lineBytes() const;
+
+    /**
+     * @brief Sieve indices per L1-sized block (L1d bytes * 8).
+     * @return Indices, a multiple of 64.
+     */
+    std::size_t blockIndices() const;
+
+    /**
+     * @brief Sieve indices per L2-sized segment, the unit of work of the parallel engines.
+     * @return The --segment-size override if set, otherwise this CPU's L2 share * 8; a multiple of 64.
+     */
+    std::size_t segmentIndices() const;
+
+    /**
+     * @brief Smallest prime of the medium tier: primes below it hit an L1 block at least 16 times.
+     * @return The tier boundary (blocks never exceed a segment).
+     */
+    std::size_t smallPrimeLimit() const { return std::min(blockIndices(), segmentIndices()) / 16; }
+
+    /**
+     * @brief Smallest prime of the large tier: primes from here on skip whole segments.
+     * @return The tier boundary.
+     */
+    std::size_t mediumPrimeLimit() const { return segmentIndices(); }
+
+    /**
+     * @brief Format the caches and derived sizes as indented text.
+     * @return Multi-line text.
+     */
+    std::string toText() const;
+};
+
+#endif // CACHE_TOPOLOGY_HPP
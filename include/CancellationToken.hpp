@@ -0,0 +1,78 @@
+#ifndef CANCELLATION_TOKEN_HPP
+#define CANCELLATION_TOKEN_HPP
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+
+/**
+ * @class CancellationToken
+ * @brief Cooperative stop request for a running sieve: an explicit cancel or a deadline.
+ *
+ * Sieving threads poll stopRequested() between blocks, so a stop takes
+ * effect within one L2-sized block per thread.
+ */
+class CancellationToken {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    std::atomic<bool> cancelled{false};
+    Clock::time_point deadline = Clock::time_point::max();
+
+public:
+    CancellationToken() = default;
+
+    /**
+     * @brief Create a token that expires at a deadline.
+     * @param deadline Point after which sieving stops.
+     */
+    explicit CancellationToken(Clock::time_point deadline) : deadline(deadline) {}
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    /// Ask the sieve to stop at the next block boundary (any thread)
+    void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+
+    /// True once cancel() was called
+    bool isCancelled() const { return cancelled.load(std::memory_order_relaxed); }
+
+    /// True once the deadline has passed
+    bool isExpired() const {
+        return deadline != Clock::time_point::max() && Clock::now() >= deadline;
+    }
+
+    /// True if sieving should stop
+    bool stopRequested() const { return isCancelled() || isExpired(); }
+
+    /**
+     * @brief Get the deadline.
+     * @return The deadline, or Clock::time_point::max() for none.
+     */
+    Clock::time_point getDeadline() const { return deadline; }
+};
+
+/**
+ * @class SieveCancelled
+ * @brief Thrown by generate() when its CancellationToken stopped it before completion.
+ *
+ * The sieve is left partially crossed off and should be discarded.
+ */
+class SieveCancelled : public std::runtime_error {
+private:
+    bool expired;
+
+public:
+    /**
+     * @brief Create the exception.
+     * @param expired True if the deadline passed, false for an explicit cancel.
+     */
+    explicit SieveCancelled(bool expired)
+        : std::runtime_error(expired ? "sieve deadline expired" : "sieve cancelled"), expired(expired) {}
+
+    /// True if the deadline passed rather than cancel() being called
+    bool deadlineExpired() const { return expired; }
+};
+
+#endif // CANCELLATION_TOKEN_HPP
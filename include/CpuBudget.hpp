@@ -0,0 +1,119 @@
+#ifndef CPU_BUDGET_HPP
+#define CPU_BUDGET_HPP
+
+#include <string>
+#include <vector>
+
+/**
+ * @class CpuBudget
+ * @brief How many CPUs this process may actually run on, and the thread count derived from it.
+ *
+ * std::thread::hardware_concurrency() and omp_get_max_threads() report the
+ * CPUs of the node, which in a container can be far more than the process is
+ * allowed to use. The budget is the smallest of:
+ * - the logical CPUs of the host;
+ * - the CPUs in the sched_getaffinity mask (taskset, cpusets);
+ * - the cgroup CPU quota, rounded up: cpu.max on cgroup v2, or
+ *   cpu.cfs_quota_us / cpu.cfs_period_us on cgroup v1, taking the tightest
+ *   limit between the process's cgroup and the root.
+ * An explicit OMP_NUM_THREADS takes precedence over the budget, but is still
+ * reported when it oversubscribes it.
+ */
+class CpuBudget {
+private:
+    int logicalCpus = 1;
+    int affinityCpus = 0;       ///< CPUs in the affinity mask, 0 if unknown
+    double quotaCpus = 0.0;     ///< cgroup quota in CPUs, 0 if unlimited
+    std::string quotaSource;    ///< File the quota was read from
+    int ompThreads = 0;         ///< First value of OMP_NUM_THREADS, 0 if unset
+
+public:
+    /**
+     * @brief Read the tightest cgroup CPU quota of a process.
+     *
+     * Each line of the cgroup file names a hierarchy and the process's path in
+     * it; the quota files are looked up from that path up to the root of the
+     * mount, so limits set on a parent cgroup apply too.
+     * @param cgroupRoot Mount point of the cgroup file system (e.g. /sys/fs/cgroup).
+     * @param cgroupFile The process's cgroup membership (e.g. /proc/self/cgroup).
+     * @param source Receives the file holding the tightest quota.
+     * @return Quota in CPUs, or 0 if the process has no quota.
+     */
+    static double readCgroupQuota(const std::string& cgroupRoot, const std::string& cgroupFile,
+                                  std::string& source);
+
+    /**
+     * @brief Parse OMP_NUM_THREADS, whose first comma-separated value sets the outer team size.
+     * @param value The variable's value, or nullptr if unset.
+     * @return Thread count, or 0 if unset or malformed.
+     */
+    static int parseOmpNumThreads(const char* value);
+
+    /**
+     * @brief Count the CPUs in this thread's affinity mask.
+     * @return CPU count, or 0 where sched_getaffinity is unavailable.
+     */
+    static int readAffinityCpus();
+
+    /**
+     * @brief Build a budget from explicit sources.
+     * @param logical Logical CPUs of the host.
+     * @param affinity CPUs in the affinity mask (0 if unknown).
+     * @param cgroupRoot Mount point of the cgroup file system.
+     * @param cgroupFile The process's cgroup membership file.
+     * @param ompNumThreads Value of OMP_NUM_THREADS, or nullptr if unset.
+     * @return The budget.
+     */
+    static CpuBudget fromSources(int logical, int affinity, const std::string& cgroupRoot,
+                                 const std::string& cgroupFile, const char* ompNumThreads);
+
+    /**
+     * @brief Detect the budget of this process.
+     * @return The budget from hardware_concurrency, the affinity mask, /sys/fs/cgroup and OMP_NUM_THREADS.
+     */
+    static CpuBudget detect();
+
+    /**
+     * @brief Get the budget of this process, detected on first use.
+     * @return The shared budget.
+     */
+    static const CpuBudget& host();
+
+    int getLogicalCpus() const { return logicalCpus; }
+    int getAffinityCpus() const { return affinityCpus; }
+    double getQuotaCpus() const { return quotaCpus; }
+    int getOmpThreads() const { return ompThreads; }
+
+    /**
+     * @brief Get the CPUs the process can keep busy at once.
+     * @return The smallest of the logical CPUs, the affinity mask and the rounded-up quota; at least 1.
+     */
+    int availableCpus() const;
+
+    /**
+     * @brief Describe what limits availableCpus().
+     * @return E.g. "cgroup quota 4.00 CPUs", "affinity mask" or "logical CPUs".
+     */
+    std::string limitedBy() const;
+
+    /**
+     * @brief Get the thread count to use when none is requested.
+     * @return OMP_NUM_THREADS if set, otherwise availableCpus().
+     */
+    int recommendedThreads() const;
+
+    /**
+     * @brief List the problems with running a given number of threads.
+     * @param threads Thread count about to be used.
+     * @return Warnings, empty if the threads fit the budget.
+     */
+    std::vector<std::string> warnings(int threads) const;
+
+    /**
+     * @brief Format the budget as indented text.
+     * @return Multi-line text.
+     */
+    std::string toText() const;
+};
+
+#endif // CPU_BUDGET_HPP
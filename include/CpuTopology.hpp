@@ -0,0 +1,153 @@
+#ifndef CPU_TOPOLOGY_HPP
+#define CPU_TOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+
+/**
+ * @enum AffinityPolicy
+ * @brief Where the threads of a parallel engine are pinned (the --affinity option).
+ */
+enum class AffinityPolicy {
+    None,       ///< Leave placement to the OS scheduler
+    Physical,   ///< One thread per physical core, never on an SMT sibling
+    Compact,    ///< Fill the SMT siblings of a core before moving to the next core
+    Scatter     ///< Spread over cores and packages first, SMT siblings last
+};
+
+/**
+ * @struct LogicalCpu
+ * @brief One logical CPU and its place in the core/package hierarchy.
+ */
+struct LogicalCpu {
+    int cpu = 0;        ///< OS CPU number
+    int package = 0;    ///< Physical package (socket)
+    int core = 0;       ///< Core number, unique within the package
+    int sibling = 0;    ///< Position among the SMT siblings of its core (0 = first)
+};
+
+/**
+ * @class CpuTopology
+ * @brief The logical CPUs this process may run on, grouped into cores and packages.
+ *
+ * Crossing-off is bound by memory latency, and the SMT siblings of a core
+ * share its L1 and L2, so two threads on one core mostly wait for each other.
+ * The topology is read from /sys/devices/system/cpu/cpuN/topology for the CPUs
+ * in the affinity mask; without sysfs every CPU counts as its own core. A
+ * placement maps thread i of a team to a CPU according to an AffinityPolicy,
+ * and ScopedPin pins the calling thread for the duration of a parallel region.
+ */
+class CpuTopology {
+private:
+    std::vector<LogicalCpu> cpus;
+    std::string source = "default";
+
+public:
+    /**
+     * @brief Read the core and package of each allowed CPU from sysfs.
+     * @param cpuDir Directory holding cpu0, cpu1, ... (e.g. /sys/devices/system/cpu).
+     * @param allowed CPU numbers the process may run on.
+     * @return The topology; CPUs without a topology directory count as their own core.
+     */
+    static CpuTopology fromSysfs(const std::string& cpuDir, const std::vector<int>& allowed);
+
+    /**
+     * @brief List the CPUs in this thread's affinity mask.
+     * @return CPU numbers, or 0..hardware_concurrency()-1 where the mask is unavailable.
+     */
+    static std::vector<int> allowedCpus();
+
+    /**
+     * @brief Detect the topology of the CPUs this process may run on.
+     * @return The topology.
+     */
+    static CpuTopology detect();
+
+    /**
+     * @brief Get the topology of this process, detected on first use.
+     * @return The shared topology.
+     */
+    static const CpuTopology& host();
+
+    /**
+     * @brief Parse an --affinity value.
+     * @param name "none", "physical", "compact" or "scatter".
+     * @param policy Receives the policy.
+     * @return False if the name is unknown.
+     */
+    static bool parsePolicy(const std::string& name, AffinityPolicy& policy);
+
+    /**
+     * @brief Get the --affinity name of a policy.
+     * @param policy The policy.
+     * @return "none", "physical", "compact" or "scatter".
+     */
+    static const char* policyName(AffinityPolicy policy);
+
+    /**
+     * @brief Get the logical CPUs, in OS order.
+     * @return The CPUs.
+     */
+    const std::vector<LogicalCpu>& getCpus() const { return cpus; }
+
+    /**
+     * @brief Get where the topology came from.
+     * @return "sysfs" or "default".
+     */
+    const std::string& getSource() const { return source; }
+
+    /// Number of physical cores with at least one allowed CPU
+    int physicalCores() const;
+
+    /// Number of packages with at least one allowed CPU
+    int packages() const;
+
+    /// Largest number of allowed SMT siblings on one core
+    int threadsPerCore() const;
+
+    /**
+     * @brief Map each thread of a team to a CPU.
+     *
+     * With more threads than the policy has CPUs, threads wrap around, so
+     * "physical" still never uses a second SMT sibling.
+     * @param policy The placement policy.
+     * @param threads Team size.
+     * @return CPU number per thread, or an empty vector for AffinityPolicy::None.
+     */
+    std::vector<int> placement(AffinityPolicy policy, int threads) const;
+
+    /**
+     * @brief Format the topology as indented text.
+     * @return Multi-line text.
+     */
+    std::string toText() const;
+};
+
+/**
+ * @class ScopedPin
+ * @brief Pins the calling thread to one CPU and restores its previous affinity mask on destruction.
+ */
+class ScopedPin {
+private:
+    std::vector<int> saved;
+    bool pinned = false;
+
+public:
+    /**
+     * @brief Pin the calling thread.
+     * @param cpu CPU number, or a negative value to leave the thread alone.
+     */
+    explicit ScopedPin(int cpu);
+    ~ScopedPin();
+
+    ScopedPin(const ScopedPin&) = delete;
+    ScopedPin& operator=(const ScopedPin&) = delete;
+
+    /**
+     * @brief Check whether the thread was pinned.
+     * @return False if no CPU was requested or the OS refused.
+     */
+    bool isPinned() const { return pinned; }
+};
+
+#endif // CPU_TOPOLOGY_HPP
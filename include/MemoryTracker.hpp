@@ -0,0 +1,130 @@
+#ifndef MEMORY_TRACKER_HPP
+#define MEMORY_TRACKER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct PhaseMemory
+ * @brief Heap usage of one phase of a run.
+ */
+struct PhaseMemory {
+    std::string name;
+    std::size_t startBytes = 0;      ///< Live heap bytes when the phase began
+    std::size_t peakBytes = 0;       ///< Highest live heap bytes during the phase
+    std::size_t endBytes = 0;        ///< Live heap bytes when the phase ended
+    std::size_t allocatedBytes = 0;  ///< Bytes allocated during the phase (including freed ones)
+    std::size_t allocations = 0;     ///< Number of allocations during the phase
+};
+
+/**
+ * @class MemoryTracker
+ * @brief Live and peak heap accounting fed by an instrumented operator new/delete.
+ *
+ * The counters are updated by the replacement allocation functions in
+ * MemoryTrackerHook.cpp, which is linked only into the executables (not the
+ * tests), which also registers itself through markInstalled(); without it
+ * isInstalled() is false and the counts only move when fed by hand.
+ * Sizes are the allocator's usable sizes, so they include malloc rounding
+ * but not its per-block headers.
+ *
+ * An instance records a sequence of phases; the process-wide peak is reset
+ * at the start of each phase, so phases must not overlap.
+ */
+class MemoryTracker {
+private:
+    static inline std::atomic<std::size_t> live{0};
+    static inline std::atomic<std::size_t> peak{0};
+    static inline std::atomic<std::size_t> allocated{0};
+    static inline std::atomic<std::size_t> count{0};
+    static inline std::atomic<bool> hooked{false};
+
+    std::vector<PhaseMemory> phases;
+    std::size_t allocatedAtStart = 0;
+    std::size_t countAtStart = 0;
+
+public:
+    /**
+     * @brief Record an allocation (called by the allocator hook).
+     * @param bytes Usable size of the block.
+     */
+    static void recordAllocation(std::size_t bytes) {
+        std::size_t now = live.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        allocated.fetch_add(bytes, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        std::size_t highest = peak.load(std::memory_order_relaxed);
+        while (now > highest && !peak.compare_exchange_weak(highest, now, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Record a deallocation (called by the allocator hook).
+     * @param bytes Usable size of the block.
+     */
+    static void recordRelease(std::size_t bytes) {
+        live.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    static std::size_t liveBytes() { return live.load(std::memory_order_relaxed); }
+    static std::size_t peakBytes() { return peak.load(std::memory_order_relaxed); }
+    static std::size_t allocatedBytes() { return allocated.load(std::memory_order_relaxed); }
+    static std::size_t allocationCount() { return count.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Restart peak tracking from the current live size.
+     */
+    static void resetPeak() { peak.store(live.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+    /**
+     * @brief Mark the allocator hook as linked (called by MemoryTrackerHook.cpp at startup).
+     */
+    static void markInstalled() { hooked.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check whether the allocator hook is linked into this executable.
+     * @return True if MemoryTrackerHook.cpp registered itself.
+     */
+    static bool isInstalled() { return hooked.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the peak resident set size of the process from getrusage().
+     * @return Bytes (ru_maxrss), or 0 if unavailable.
+     */
+    static std::size_t maxResidentBytes();
+
+    /**
+     * @brief Start a phase.
+     * @param name Phase name (e.g. "generate").
+     */
+    void beginPhase(const std::string& name);
+
+    /**
+     * @brief End the current phase.
+     */
+    void endPhase();
+
+    const std::vector<PhaseMemory>& getPhases() const { return phases; }
+
+    /**
+     * @brief Highest live heap over all recorded phases.
+     * @return Bytes.
+     */
+    std::size_t overallPeakBytes() const;
+
+    /**
+     * @brief Format the per-phase table plus the getrusage cross-check.
+     * @return Human-readable text.
+     */
+    std::string toText() const;
+
+    /**
+     * @brief Format the phases as a JSON object.
+     * @return JSON text.
+     */
+    std::string toJson() const;
+};
+
+#endif // MEMORY_TRACKER_HPP
@@ -0,0 +1,202 @@
+#ifndef METRICS_REGISTRY_HPP
+#define METRICS_REGISTRY_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Counter
+ * @brief Monotonically increasing count; one relaxed atomic add per update.
+ */
+class Counter {
+private:
+    std::atomic<std::uint64_t> count{0};
+
+public:
+    void inc(std::uint64_t amount = 1) { count.fetch_add(amount, std::memory_order_relaxed); }
+    std::uint64_t value() const { return count.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @class Gauge
+ * @brief Value that can go up and down.
+ */
+class Gauge {
+private:
+    std::atomic<std::uint64_t> bits{0};  // Bit pattern of a double
+
+    static std::uint64_t toBits(double v) {
+        std::uint64_t b;
+        std::memcpy(&b, &v, sizeof(b));
+        return b;
+    }
+
+    static double fromBits(std::uint64_t b) {
+        double v;
+        std::memcpy(&v, &b, sizeof(v));
+        return v;
+    }
+
+public:
+    void set(double v) { bits.store(toBits(v), std::memory_order_relaxed); }
+
+    void add(double delta) {
+        std::uint64_t expected = bits.load(std::memory_order_relaxed);
+        while (!bits.compare_exchange_weak(expected, toBits(fromBits(expected) + delta),
+                                           std::memory_order_relaxed)) {
+        }
+    }
+
+    double value() const { return fromBits(bits.load(std::memory_order_relaxed)); }
+};
+
+/**
+ * @class Histogram
+ * @brief Distribution of observations over fixed cumulative buckets.
+ */
+class Histogram {
+private:
+    std::vector<double> bounds;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> buckets;  // bounds.size() + 1 (+Inf)
+    Gauge sum;
+    Counter count;
+
+public:
+    /**
+     * @brief Construct a histogram.
+     * @param upperBounds Ascending bucket upper bounds (+Inf is implicit).
+     */
+    explicit Histogram(std::vector<double> upperBounds);
+
+    /**
+     * @brief Record one observation.
+     * @param v The observed value.
+     */
+    void observe(double v) {
+        std::size_t i = 0;
+        while (i < bounds.size() && v > bounds[i]) {
+            ++i;
+        }
+        buckets[i].fetch_add(1, std::memory_order_relaxed);
+        sum.add(v);
+        count.inc();
+    }
+
+    const std::vector<double>& getBounds() const { return bounds; }
+
+    /**
+     * @brief Get the (non-cumulative) count of one bucket.
+     * @param index Bucket index; bounds.size() is the +Inf bucket.
+     * @return Observations that fell in the bucket.
+     */
+    std::uint64_t bucketCount(std::size_t index) const {
+        return buckets[index].load(std::memory_order_relaxed);
+    }
+
+    double getSum() const { return sum.value(); }
+    std::uint64_t getCount() const { return count.value(); }
+
+    /**
+     * @brief Exponential bucket bounds.
+     * @param start First upper bound.
+     * @param factor Ratio between consecutive bounds.
+     * @param count Number of bounds.
+     * @return The bounds.
+     */
+    static std::vector<double> exponentialBounds(double start, double factor, std::size_t count);
+};
+
+/**
+ * @class MetricsRegistry
+ * @brief Named counters, gauges and histograms exported in OpenMetrics text format.
+ *
+ * Metrics are created on first lookup and live as long as the registry, so
+ * call sites look them up once (e.g. into a function-local static reference)
+ * and then update them with plain atomic operations. Callback gauges are
+ * evaluated only when the registry is exported.
+ */
+class MetricsRegistry {
+private:
+    enum class Type { Counter, Gauge, Histogram, CallbackGauge };
+
+    struct Family {
+        Type type;
+        std::string help;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> callback;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, Family> families;
+
+    Family& family(const std::string& name, Type type, const std::string& help);
+
+public:
+    /**
+     * @brief Get the process-wide registry used by the engines.
+     * @return The global registry.
+     */
+    static MetricsRegistry& global();
+
+    /**
+     * @brief Get or create a counter.
+     * @param name Metric family name (exported with a "_total" suffix).
+     * @param help Description.
+     * @return Reference valid for the registry's lifetime.
+     */
+    Counter& counter(const std::string& name, const std::string& help);
+
+    /**
+     * @brief Get or create a gauge.
+     * @param name Metric name.
+     * @param help Description.
+     * @return Reference valid for the registry's lifetime.
+     */
+    Gauge& gauge(const std::string& name, const std::string& help);
+
+    /**
+     * @brief Get or create a histogram.
+     * @param name Metric family name.
+     * @param help Description.
+     * @param bounds Bucket upper bounds, used only when the histogram is created.
+     * @return Reference valid for the registry's lifetime.
+     */
+    Histogram& histogram(const std::string& name, const std::string& help, std::vector<double> bounds);
+
+    /**
+     * @brief Register a gauge whose value is computed at export time.
+     * @param name Metric name.
+     * @param help Description.
+     * @param callback Function returning the current value.
+     */
+    void callbackGauge(const std::string& name, const std::string& help, std::function<double()> callback);
+
+    /**
+     * @brief Format all metrics in OpenMetrics text format.
+     * @return Exposition text ending in "# EOF".
+     */
+    std::string toOpenMetrics() const;
+
+    /**
+     * @brief Write the OpenMetrics exposition to a file ("-" for stdout).
+     *
+     * The file is written to a temporary name and renamed into place, so a
+     * scraper (e.g. the node_exporter textfile collector) never sees a
+     * partial file.
+     * @param filename Destination path.
+     * @return True if successful, false otherwise.
+     */
+    bool writeOpenMetrics(const std::string& filename) const;
+};
+
+#endif // METRICS_REGISTRY_HPP
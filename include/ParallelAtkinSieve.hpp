@@ -0,0 +1,56 @@
+#ifndef PARALLEL_ATKIN_SIEVE_HPP
+#define PARALLEL_ATKIN_SIEVE_HPP
+
+#include "AtkinSieve.hpp"
+#include "ParallelSieveBase.hpp"
+#include <omp.h>
+
+/**
+ * @class ParallelAtkinSieve
+ * @brief Parallel implementation of AtkinSieve using OpenMP work-sharing approach.
+ *
+ * The whole range is split into word-aligned blocks. Each block is handled
+ * by one thread, which toggles the quadratic-form solutions inside it and
+ * then clears the multiples of the prime squares, so threads never write
+ * the same 64-bit word.
+ */
+class ParallelAtkinSieve : public AtkinSieve, public ParallelSieveBase {
+private:
+    /**
+     * @brief Count the primes left in a block after square elimination.
+     * @param low First number of the block.
+     * @param high Last number of the block.
+     * @return Number of primes in [low, high].
+     */
+    std::size_t countPrimesInBlock(std::size_t low, std::size_t high) const;
+
+public:
+    /**
+     * @brief Construct ParallelAtkinSieve with specified limit and thread configuration.
+     * @param n The upper limit for finding prime numbers.
+     * @param threads Number of threads to use (0 for auto-detection).
+     */
+    explicit ParallelAtkinSieve(std::size_t n, int threads = 0);
+
+    /**
+     * @brief Generate prime numbers using the parallel Sieve of Atkin.
+     *
+     * Overrides the base generate() method to process blocks with an OpenMP
+     * dynamic schedule.
+     */
+    void generate() override;
+
+    /**
+     * @brief Get performance statistics for parallel execution.
+     * @return String containing performance information.
+     */
+    std::string getPerformanceStats() const;
+
+    /**
+     * @brief Get performance statistics as a JSON object.
+     * @return JSON text with the configuration and per-phase statistics.
+     */
+    std::string getPerformanceStatsJson() const;
+};
+
+#endif // PARALLEL_ATKIN_SIEVE_HPP
@@ -3,6 +3,7 @@
 
 #include "BasicSieve.hpp"
 #include "ParallelSieveBase.hpp"
+#include "SievingPrimes.hpp"
 #include <omp.h>
 
 /**
@@ -11,22 +12,27 @@
  * 
  * This class extends BasicSieve with OpenMP parallelization for improved performance
  * on multi-core systems. Uses work-sharing approach where the range is divided
- * among threads for better cache locality.
+ * among threads in chunks of consecutive blocks; each thread carries the next
+ * multiple of every sieving prime from one block of its chunk to the next.
  */
 class ParallelBasicSieve : public BasicSieve, public ParallelSieveBase {
 private:
     /**
-     * @brief Mark multiples of a prime number in parallel.
+     * @brief Mark the multiples of a prime up to the end of one block of the sieve.
      * @param prime The prime number whose multiples to mark.
+     * @param multiple Next multiple to mark, inside or past the block; left at the first one past it.
+     * @param high Last index of the block.
+     * @return Number of multiples marked.
      */
-    void markMultiplesParallel(std::size_t prime);
+    std::size_t markMultiplesInBlock(std::size_t prime, std::size_t& multiple, std::size_t high);
     
     /**
-     * @brief Mark multiples of a prime number in parallel with chunking.
-     * @param prime The prime number whose multiples to mark.
-     * @param chunkSize Size of chunks for work distribution.
+     * @brief Count the primes left in a block after crossing off.
+     * @param low First index of the block.
+     * @param high Last index of the block.
+     * @return Number of primes in [low, high].
      */
-    void markMultiplesParallelChunked(std::size_t prime, std::size_t chunkSize);
+    std::size_t countPrimesInBlock(std::size_t low, std::size_t high) const;
 
 public:
     /**
@@ -49,6 +55,12 @@ public:
      * @return String containing performance information.
      */
     std::string getPerformanceStats() const;
+
+    /**
+     * @brief Get performance statistics as a JSON object.
+     * @return JSON text with the configuration and per-phase statistics.
+     */
+    std::string getPerformanceStatsJson() const;
 };
 
 #endif // PARALLEL_BASIC_SIEVE_HPP
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "BitSieve.hpp"
 #include "ParallelSieveBase.hpp"
+#include "SegmentPipeline.hpp"
 #include <omp.h>
 #include <atomic>
 
@@ -12,28 +13,18 @@
  * 
  * This class extends BitSieve with OpenMP parallelization for improved performance
  * on multi-core systems. Uses work-sharing approach where the bit array is divided
- * among threads for better cache locality and memory access patterns.
+ * among threads in chunks of consecutive segments, each crossed off with the
+ * tiered loops of TieredCrossOff.
  */
 class ParallelBitSieve : public BitSieve, public ParallelSieveBase {
 private:
     /**
-     * @brief Clear a bit at the specified index with thread safety.
-     * @param index The index of the bit to clear.
+     * @brief Count the primes left in a block after crossing off.
+     * @param low First index of the block.
+     * @param high Last index of the block.
+     * @return Number of primes in [low, high].
      */
-    void clearBitParallel(std::size_t index);
-    
-    /**
-     * @brief Mark multiples of a prime number in parallel.
-     * @param prime The prime number whose multiples to mark.
-     */
-    void markMultiplesParallel(std::size_t prime);
-    
-    /**
-     * @brief Mark multiples of a prime number in parallel with chunking.
-     * @param prime The prime number whose multiples to mark.
-     * @param chunkSize Size of chunks for work distribution.
-     */
-    void markMultiplesParallelChunked(std::size_t prime, std::size_t chunkSize);
+    std::size_t countPrimesInBlock(std::size_t low, std::size_t high) const;
 
 public:
     /**
@@ -52,11 +43,45 @@ public:
      */
     void generate() override;
     
+    /**
+     * @brief Generate the primes and hand each finished segment to a consumer while sieving.
+     * 
+     * Segments of TieredCrossOff::segmentSizeFor(getStats()) numbers are copied
+     * into a SegmentPipeline as soon as their chunk has crossed them off and
+     * reach the consumer in ascending order on a separate thread. Sieving
+     * stalls while inFlight segments wait for the consumer. If the sieve was
+     * already generated, the segments are passed to the consumer directly;
+     * a pass started with generateStep() is finished sequentially first.
+     * When the cancellation token stops the run, the consumer has seen a
+     * prefix of the segments and SieveCancelled is thrown.
+     * @param consumer Called with each segment in order; exceptions it throws are rethrown here.
+     * @param inFlight Segments that may wait for the consumer (0 for four per thread).
+     */
+    void generateStreaming(const SegmentPipeline::Consumer& consumer, std::size_t inFlight = 0);
+    
+    /**
+     * @brief Generate the primes and write them to a file while sieving.
+     * 
+     * Streams the finished segments of generateStreaming() into an
+     * AsyncPrimeWriter, so the listing is formatted and written while later
+     * segments are still being crossed off instead of after generate().
+     * @param filename The name of the file to write to.
+     * @param outputStats Receives the bytes written and throughput (optional).
+     * @return True if successful, false otherwise.
+     */
+    bool generateToFile(const std::string& filename, OutputStats* outputStats = nullptr);
+    
     /**
      * @brief Get performance statistics for parallel execution.
      * @return String containing performance information.
      */
     std::string getPerformanceStats() const;
+
+    /**
+     * @brief Get performance statistics as a JSON object.
+     * @return JSON text with the configuration and per-phase statistics.
+     */
+    std::string getPerformanceStatsJson() const;
 };
 
 #endif // PARALLEL_BIT_SIEVE_HPP
\ No newline at end of file
@@ -1,9 +1,16 @@
 #ifndef PARALLEL_SIEVE_BASE_HPP
 #define PARALLEL_SIEVE_BASE_HPP
 
+#include "CacheTopology.hpp"
+#include "CancellationToken.hpp"
+#include "CpuBudget.hpp"
+#include "CpuTopology.hpp"
 #include <omp.h>
-#include <thread>
 #include <algorithm>
+#include <cstddef>
+#include <string>
+
+class ProgressReporter;
 
 /**
  * @class ParallelSieveBase
@@ -16,15 +23,80 @@ class ParallelSieveBase {
 protected:
     int threadCount;
     bool useParallel;
+    ProgressReporter* progress = nullptr;
+    const CancellationToken* cancellation = nullptr;
+    AffinityPolicy affinity = AffinityPolicy::None;
+    
+    /**
+     * @brief Pin the calling OpenMP thread according to the affinity policy.
+     *
+     * Called at the top of each parallel region; the thread gets its previous
+     * affinity mask back when the returned guard goes out of scope.
+     * @return Guard holding the pin (a no-op for AffinityPolicy::None).
+     */
+    ScopedPin pinWorker() const {
+        std::vector<int> cpus = CpuTopology::host().placement(affinity, threadCount);
+        int thread = omp_get_thread_num();
+        return ScopedPin(thread < static_cast<int>(cpus.size()) ? cpus[thread] : -1);
+    }
+    
+    /**
+     * @brief Check whether the attached token asks the sieve to stop.
+     * @return True if a token is attached and was cancelled or has expired.
+     */
+    bool stopRequested() const { return cancellation && cancellation->stopRequested(); }
+    
+    /**
+     * @brief Throw SieveCancelled if any thread left its blocks unfinished.
+     * @param stopped True if a thread saw stopRequested() and stopped early.
+     */
+    void throwIfStopped(bool stopped) const {
+        if (stopped) {
+            throw SieveCancelled(!cancellation->isCancelled());
+        }
+    }
+    
+    /**
+     * @brief Get the largest block of sieve indices one thread crosses off at a time.
+     * @return One L2-sized segment of bits (CacheTopology::segmentIndices()).
+     */
+    static std::size_t getMaxBlockSize() { return CacheTopology::host().segmentIndices(); }
+    
+    /**
+     * @brief Get the size of the blocks a range is split into for the threads.
+     *
+     * Blocks are a multiple of 64 indices so that no two threads ever write
+     * to the same 64-bit word of the sieve.
+     * @param range Number of sieve indices to split.
+     * @return Block size in indices.
+     */
+    std::size_t getBlockSize(std::size_t range) const {
+        std::size_t perThread = range / static_cast<std::size_t>(threadCount) + 1;
+        std::size_t block = std::min(perThread, getMaxBlockSize());
+        return (block + 63) / 64 * 64;
+    }
     
     /**
-     * @brief Get optimal thread count based on hardware.
-     * @return Optimal number of threads for current system.
+     * @brief Get the size of the chunks of consecutive blocks handed to the threads.
+     *
+     * About four chunks per thread keep the dynamic schedule balanced, while
+     * each chunk is long enough that seeding the per-prime sieving state at
+     * its start (one division per prime) is amortised over many blocks.
+     * @param range Number of sieve indices to split.
+     * @param blockSize Block size from getBlockSize().
+     * @return Chunk size in indices, a multiple of blockSize.
+     */
+    std::size_t getChunkSize(std::size_t range, std::size_t blockSize) const {
+        std::size_t chunks = static_cast<std::size_t>(threadCount) * 4;
+        return std::max<std::size_t>(range / chunks / blockSize, 1) * blockSize;
+    }
+    
+    /**
+     * @brief Get optimal thread count based on the CPUs this process may use.
+     * @return OMP_NUM_THREADS if set, otherwise the CPUs left by the affinity mask and cgroup quota.
      */
     int getOptimalThreadCount() const {
-        int maxThreads = omp_get_max_threads();
-        int logicalCores = std::thread::hardware_concurrency();
-        return std::min(maxThreads, logicalCores);
+        return CpuBudget::host().recommendedThreads();
     }
 
 public:
@@ -65,13 +137,59 @@ public:
         useParallel = parallel;
     }
     
+    /**
+     * @brief Choose where the threads run while sieving.
+     * @param policy Placement policy; AffinityPolicy::None leaves it to the OS.
+     */
+    void setAffinityPolicy(AffinityPolicy policy) { affinity = policy; }
+    
+    /**
+     * @brief Get the placement policy.
+     * @return The policy set with setAffinityPolicy().
+     */
+    AffinityPolicy getAffinityPolicy() const { return affinity; }
+    
+    /**
+     * @brief Attach a progress reporter that receives finished blocks while sieving.
+     *
+     * With a reporter attached the block-parallel path is used even for one
+     * thread, so progress is reported for every configuration; it runs on a
+     * single thread while parallel processing is disabled.
+     * @param reporter Reporter to notify, or nullptr to detach.
+     */
+    void setProgressReporter(ProgressReporter* reporter) { progress = reporter; }
+    
+    /**
+     * @brief Get the attached progress reporter.
+     * @return The reporter, or nullptr if none is attached.
+     */
+    ProgressReporter* getProgressReporter() const { return progress; }
+    
+    /**
+     * @brief Attach a token that can stop generate() between blocks.
+     *
+     * Like a progress reporter, a token selects the block-parallel path even
+     * for one thread, without changing the number of threads it runs on. A
+     * stopped generate() throws SieveCancelled; the token must outlive the call.
+     * @param token Token to poll, or nullptr to detach.
+     */
+    void setCancellationToken(const CancellationToken* token) { cancellation = token; }
+    
     /**
      * @brief Get thread information for display.
-     * @return String containing thread information.
+     * @return The thread count, the CPUs available to it, and a line per oversubscription warning.
      */
     std::string getThreadInfo() const {
-        return "Threads: " + std::to_string(threadCount) + 
-               " (Parallel: " + (useParallel ? "Yes" : "No") + ")";
+        const CpuBudget& budget = CpuBudget::host();
+        std::string info = "Threads: " + std::to_string(threadCount) + 
+                           " (Parallel: " + (useParallel ? "Yes" : "No") +
+                           ", available CPUs: " + std::to_string(budget.availableCpus()) +
+                           ", limited by " + budget.limitedBy() +
+                           ", affinity: " + CpuTopology::policyName(affinity) + ")";
+        for (const auto& warning : budget.warnings(threadCount)) {
+            info += "\nWarning: " + warning;
+        }
+        return info;
     }
 };
 
@@ -6,50 +6,41 @@
 #include <omp.h>
 
 /**
- * @class ParallelWheelSieve
- * @brief Parallel implementation of WheelSieve using OpenMP work-sharing approach.
+ * @class ParallelModWheelSieve
+ * @brief Parallel implementation of ModWheelSieve using OpenMP work-sharing approach.
+ * @tparam Modulus Wheel modulus: 30, 210 or 2310.
  * 
- * This class extends WheelSieve with OpenMP parallelization for improved performance
- * on multi-core systems. Uses work-sharing approach where the wheel-based
- * range is divided among threads for better cache locality while preserving
- * the 2,3,5-wheel optimization.
+ * This class extends ModWheelSieve with OpenMP parallelization for improved performance
+ * on multi-core systems. Uses work-sharing approach where the wheel-indexed
+ * range is divided among threads in chunks of consecutive blocks, preserving
+ * the wheel optimization. Each thread carries the next multiple and cofactor
+ * wheel position of every sieving prime from one block of its chunk to the next.
  */
-class ParallelWheelSieve : public WheelSieve, public ParallelSieveBase {
+template <std::size_t Modulus>
+class ParallelModWheelSieve : public ModWheelSieve<Modulus>, public ParallelSieveBase {
 private:
     /**
-     * @brief Mark multiples of a prime number in parallel.
-     * @param prime The prime number whose multiples to mark.
+     * @brief Count the primes left in a block after crossing off.
+     * @param first First wheel index of the block.
+     * @param last Last wheel index of the block.
+     * @return Number of primes stored in [first, last].
      */
-    void markMultiplesParallel(std::size_t prime);
-    
-    /**
-     * @brief Get next wheel number in parallel with thread safety.
-     * @param current The current number in wheel sequence.
-     * @return Next number in wheel sequence.
-     */
-    std::size_t getNextWheelNumberParallel(std::size_t current) const;
-    
-    /**
-     * @brief Mark multiples of a prime number in parallel with chunking.
-     * @param prime The prime number whose multiples to mark.
-     * @param chunkSize Size of chunks for work distribution.
-     */
-    void markMultiplesParallelChunked(std::size_t prime, std::size_t chunkSize);
+    std::size_t countPrimesInBlock(std::size_t first, std::size_t last) const;
 
 public:
     /**
-     * @brief Construct ParallelWheelSieve with specified limit and thread configuration.
+     * @brief Construct ParallelModWheelSieve with specified limit and thread configuration.
      * @param n The upper limit for finding prime numbers.
      * @param threads Number of threads to use (0 for auto-detection).
      */
-    explicit ParallelWheelSieve(std::size_t n, int threads = 0);
+    explicit ParallelModWheelSieve(std::size_t n, int threads = 0);
     
     /**
      * @brief Generate prime numbers using parallel wheel sieve algorithm.
      * 
      * Overrides the base generate() method to implement parallel processing.
      * Uses work-sharing approach with OpenMP parallel for loops.
-     * Maintains 2,3,5-wheel optimization for improved performance.
+     * Maintains the wheel optimization for improved performance.
      */
     void generate() override;
     
@@ -58,6 +49,20 @@ public:
      * @return String containing performance information.
      */
     std::string getPerformanceStats() const;
+
+    /**
+     * @brief Get performance statistics as a JSON object.
+     * @return JSON text with the configuration and per-phase statistics.
+     */
+    std::string getPerformanceStatsJson() const;
 };
 
+extern template class ParallelModWheelSieve<30>;
+extern template class ParallelModWheelSieve<210>;
+extern template class ParallelModWheelSieve<2310>;
+
+using ParallelWheelSieve = ParallelModWheelSieve<30>;
+using ParallelWheel210Sieve = ParallelModWheelSieve<210>;
+using ParallelWheel2310Sieve = ParallelModWheelSieve<2310>;
+
 #endif // PARALLEL_WHEEL_SIEVE_HPP
\ No newline at end of file
@@ -0,0 +1,183 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Number of hardware events collected per thread.
+ */
+constexpr std::size_t PERF_EVENT_COUNT = 6;
+
+/**
+ * @struct PerfCounterSample
+ * @brief Hardware event counts for one thread (or the sum over threads).
+ *
+ * Events are, in order: cycles, instructions, L1d read misses, last-level
+ * cache misses, dTLB read misses and branch misses. Counts are scaled when
+ * the kernel had to multiplex counters.
+ */
+struct PerfCounterSample {
+    std::array<std::uint64_t, PERF_EVENT_COUNT> values{};
+    std::array<bool, PERF_EVENT_COUNT> available{};
+
+    PerfCounterSample& operator+=(const PerfCounterSample& other);
+
+    /**
+     * @brief Get instructions per cycle.
+     * @return IPC, or 0 if cycles or instructions are unavailable.
+     */
+    double ipc() const;
+};
+
+/**
+ * @class PerfCounterGroup
+ * @brief perf_event_open counters attached to a single thread.
+ */
+class PerfCounterGroup {
+private:
+    std::array<int, PERF_EVENT_COUNT> fds;
+    std::string error;
+
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+    PerfCounterGroup(PerfCounterGroup&& other) noexcept;
+    PerfCounterGroup& operator=(PerfCounterGroup&& other) noexcept;
+
+    /**
+     * @brief Open the counters (disabled) for a thread.
+     * @param tid Kernel thread id to count, or 0 for the calling thread.
+     * @return True if at least the cycle counter could be opened.
+     */
+    bool open(int tid = 0);
+
+    /**
+     * @brief Close all counters.
+     */
+    void close();
+
+    /**
+     * @brief Check whether the counters are open.
+     * @return True if open, false otherwise.
+     */
+    bool isOpen() const { return fds[0] >= 0; }
+
+    /**
+     * @brief Get the reason the counters could not be opened.
+     * @return Human-readable error, empty if open() succeeded.
+     */
+    const std::string& getError() const { return error; }
+
+    /**
+     * @brief Zero and start all counters.
+     */
+    void start();
+
+    /**
+     * @brief Stop all counters.
+     */
+    void stop();
+
+    /**
+     * @brief Read the current counter values.
+     * @return The (multiplexing-scaled) counts.
+     */
+    PerfCounterSample read() const;
+
+    /**
+     * @brief Get the display name of an event.
+     * @param index Event index in [0, PERF_EVENT_COUNT).
+     * @return The event name.
+     */
+    static const char* eventName(std::size_t index);
+};
+
+/**
+ * @class ThreadPerfCounters
+ * @brief Per-phase, per-thread hardware counters for OpenMP-parallel engines.
+ *
+ * One PerfCounterGroup is opened on each thread of the OpenMP team, so
+ * later parallel regions with the same team size are counted per thread.
+ * Idle OpenMP workers spin for a while after a region ends, which shows
+ * up as cycles with few useful instructions in serial phases.
+ */
+class ThreadPerfCounters {
+public:
+    /**
+     * @struct Phase
+     * @brief Counts recorded for one named phase.
+     */
+    struct Phase {
+        std::string name;
+        std::vector<PerfCounterSample> threads;
+
+        /**
+         * @brief Sum of the counts over all threads.
+         * @return The total sample.
+         */
+        PerfCounterSample total() const;
+    };
+
+private:
+    std::vector<PerfCounterGroup> groups;
+    std::vector<Phase> phases;
+    std::string error;
+    bool available;
+
+public:
+    /**
+     * @brief Open counters on every thread of an OpenMP team.
+     * @param threads Team size to attach to.
+     */
+    explicit ThreadPerfCounters(int threads);
+
+    /**
+     * @brief Check whether counters could be opened.
+     * @return True if counters are collected, false otherwise.
+     */
+    bool isAvailable() const { return available; }
+
+    /**
+     * @brief Get the reason counters are unavailable.
+     * @return Human-readable error, empty if available.
+     */
+    const std::string& getError() const { return error; }
+
+    /**
+     * @brief Start counting a new phase on every thread.
+     * @param name Phase name.
+     */
+    void beginPhase(const std::string& name);
+
+    /**
+     * @brief Stop counting and record the current phase.
+     */
+    void endPhase();
+
+    /**
+     * @brief Get the recorded phases.
+     * @return Phases in the order they were recorded.
+     */
+    const std::vector<Phase>& getPhases() const { return phases; }
+
+    /**
+     * @brief Format the recorded phases as a table.
+     * @return Table text, or a one-line note if counters are unavailable.
+     */
+    std::string toText() const;
+
+    /**
+     * @brief Format the recorded phases as a JSON array.
+     * @return JSON text ("[]" if counters are unavailable).
+     */
+    std::string toJson() const;
+};
+
+#endif // PERF_COUNTERS_HPP
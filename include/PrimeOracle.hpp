@@ -0,0 +1,109 @@
+#ifndef PRIME_ORACLE_HPP
+#define PRIME_ORACLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/**
+ * @struct PrimeDigest
+ * @brief Order-independent fingerprint of a set of primes.
+ *
+ * Each prime is passed through a 64-bit mixing function and the results are
+ * summed, so the digest does not depend on the order primes are produced
+ * in (e.g. by different threads or segment layouts), while any missing,
+ * extra or wrong prime changes it with overwhelming probability.
+ */
+struct PrimeDigest {
+    std::size_t count = 0;
+    std::uint64_t hash = 0;
+
+    /**
+     * @brief Add one prime to the digest.
+     * @param prime The prime.
+     */
+    void add(std::size_t prime) {
+        ++count;
+        hash += mix(static_cast<std::uint64_t>(prime));
+    }
+
+    /**
+     * @brief Add another digest (of a disjoint set of primes).
+     * @param other The digest to merge.
+     */
+    void merge(const PrimeDigest& other) {
+        count += other.count;
+        hash += other.hash;
+    }
+
+    /**
+     * @brief Build a digest from a container of primes.
+     * @param primes Any iterable container of primes.
+     * @return The digest.
+     */
+    template <typename Container>
+    static PrimeDigest of(const Container& primes) {
+        PrimeDigest digest;
+        for (auto p : primes) {
+            digest.add(static_cast<std::size_t>(p));
+        }
+        return digest;
+    }
+
+    /**
+     * @brief SplitMix64 finalizer.
+     * @param x Value to mix.
+     * @return Mixed value.
+     */
+    static std::uint64_t mix(std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    bool operator==(const PrimeDigest& other) const {
+        return count == other.count && hash == other.hash;
+    }
+
+    bool operator!=(const PrimeDigest& other) const { return !(*this == other); }
+
+    /**
+     * @brief Format the digest for display.
+     * @return e.g. "664579 primes, hash 0x1234abcd5678ef90".
+     */
+    std::string toString() const;
+};
+
+/**
+ * @class PrimeOracle
+ * @brief Known values of the prime-counting function for validating engines.
+ */
+class PrimeOracle {
+public:
+    /**
+     * @brief Look up pi(limit) in the built-in table of pi(10^k) and pi(2^k).
+     * @param limit The sieve limit.
+     * @return The number of primes <= limit, or std::nullopt if limit is not tabulated.
+     */
+    static std::optional<std::size_t> knownPrimeCount(std::size_t limit);
+
+    /**
+     * @brief Describe a tabulated limit as a power ("10^7", "2^20").
+     * @param limit The sieve limit.
+     * @return The power notation, or the decimal value if not a tabulated power.
+     */
+    static std::string describeLimit(std::size_t limit);
+
+    /**
+     * @brief Check a prime count against the table.
+     * @param limit The sieve limit.
+     * @param count The count produced by an engine.
+     * @param message Receives a human-readable verdict.
+     * @return False only if the limit is tabulated and the count differs.
+     */
+    static bool checkCount(std::size_t limit, std::size_t count, std::string& message);
+};
+
+#endif // PRIME_ORACLE_HPP
@@ -0,0 +1,267 @@
+#ifndef PRIME_TABLES_HPP
+#define PRIME_TABLES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @struct PrimeTableBuilder
+ * @brief Constexpr generators behind PrimeTables and WheelTable.
+ *
+ * Kept separate because a class cannot call its own static member functions
+ * in the initializers of its static constexpr members.
+ */
+struct PrimeTableBuilder {
+    static constexpr std::size_t SMALL_LIMIT = std::size_t(1) << 16;
+    static constexpr std::size_t SMALL_PRIME_COUNT = 6542;  // pi(2^16)
+    static constexpr std::size_t BITMAP_WORDS = SMALL_LIMIT / 64;
+
+    using Bitmap = std::array<std::uint64_t, BITMAP_WORDS>;
+    using PrimeList = std::array<std::uint16_t, SMALL_PRIME_COUNT>;
+
+    static constexpr Bitmap makeBitmap() {
+        Bitmap bitmap{};
+        for (std::size_t w = 0; w < BITMAP_WORDS; ++w) {
+            bitmap[w] = ~std::uint64_t(0);
+        }
+        bitmap[0] &= ~std::uint64_t(3);  // 0 and 1
+        for (std::size_t p = 2; p * p < SMALL_LIMIT; ++p) {
+            if ((bitmap[p / 64] >> (p % 64)) & 1) {
+                for (std::size_t i = p * p; i < SMALL_LIMIT; i += p) {
+                    bitmap[i / 64] &= ~(std::uint64_t(1) << (i % 64));
+                }
+            }
+        }
+        return bitmap;
+    }
+
+    static constexpr PrimeList makePrimes(const Bitmap& bitmap) {
+        PrimeList primes{};
+        std::size_t count = 0;
+        for (std::size_t n = 2; n < SMALL_LIMIT; ++n) {
+            if ((bitmap[n / 64] >> (n % 64)) & 1) {
+                primes[count++] = static_cast<std::uint16_t>(n);
+            }
+        }
+        return primes;
+    }
+
+    static constexpr bool coprime(std::size_t a, std::size_t b) {
+        while (b != 0) {
+            std::size_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a == 1;
+    }
+
+    static constexpr std::size_t countResidues(std::size_t modulus) {
+        std::size_t count = 0;
+        for (std::size_t r = 0; r < modulus; ++r) {
+            if (coprime(modulus, r)) ++count;
+        }
+        return count;
+    }
+
+    static constexpr std::size_t countPrimeFactors(std::size_t modulus) {
+        std::size_t count = 0;
+        for (std::size_t p = 2; p <= modulus; ++p) {
+            if (modulus % p == 0 && countResidues(p) == p - 1) ++count;
+        }
+        return count;
+    }
+
+    template <std::size_t Modulus, std::size_t Count>
+    static constexpr std::array<std::size_t, Count> makeResidues() {
+        std::array<std::size_t, Count> residues{};
+        std::size_t k = 0;
+        for (std::size_t r = 0; r < Modulus; ++r) {
+            if (coprime(Modulus, r)) residues[k++] = r;
+        }
+        return residues;
+    }
+
+    template <std::size_t Modulus, std::size_t Count>
+    static constexpr std::array<std::size_t, Count> makeSteps(const std::array<std::size_t, Count>& residues) {
+        std::array<std::size_t, Count> steps{};
+        for (std::size_t k = 0; k + 1 < Count; ++k) {
+            steps[k] = residues[k + 1] - residues[k];
+        }
+        steps[Count - 1] = Modulus + residues[0] - residues[Count - 1];
+        return steps;
+    }
+
+    template <std::size_t Modulus, std::size_t Count>
+    static constexpr std::array<std::size_t, Modulus> makeIndex(const std::array<std::size_t, Count>& residues) {
+        std::array<std::size_t, Modulus> index{};
+        std::size_t k = 0;
+        for (std::size_t r = 0; r < Modulus; ++r) {
+            while (k < Count && residues[k] < r) ++k;
+            index[r] = k;
+        }
+        return index;
+    }
+
+    template <std::size_t Modulus, std::size_t Count>
+    static constexpr std::array<std::size_t, Count> makePrimeFactors() {
+        std::array<std::size_t, Count> primes{};
+        std::size_t k = 0;
+        for (std::size_t p = 2; p <= Modulus; ++p) {
+            if (Modulus % p == 0 && countResidues(p) == p - 1) primes[k++] = p;
+        }
+        return primes;
+    }
+};
+
+/**
+ * @struct PrimeTables
+ * @brief Compile-time prime tables for numbers below 2^16.
+ *
+ * The bitmap and the prime list are generated by a constexpr sieve, so small
+ * queries and the base primes of any sieve up to 2^32 need no runtime setup.
+ */
+struct PrimeTables {
+    static constexpr std::size_t SMALL_LIMIT = PrimeTableBuilder::SMALL_LIMIT;              ///< Tables cover [0, SMALL_LIMIT)
+    static constexpr std::size_t SMALL_PRIME_COUNT = PrimeTableBuilder::SMALL_PRIME_COUNT;  ///< pi(2^16)
+
+    /// Bit n is set if n is prime, for n < SMALL_LIMIT
+    static constexpr PrimeTableBuilder::Bitmap BITMAP = PrimeTableBuilder::makeBitmap();
+
+    /// All primes below SMALL_LIMIT in ascending order
+    static constexpr PrimeTableBuilder::PrimeList PRIMES = PrimeTableBuilder::makePrimes(BITMAP);
+    /**
+     * @brief Look up a number in the bitmap.
+     * @param n The number (must be below SMALL_LIMIT).
+     * @return True if n is prime.
+     */
+    static constexpr bool isSmallPrime(std::size_t n) {
+        return (BITMAP[n / 64] >> (n % 64)) & 1;
+    }
+
+    /**
+     * @brief Test a number without constructing a sieve.
+     *
+     * Uses the bitmap below SMALL_LIMIT and trial division by the table
+     * primes up to SMALL_LIMIT^2 = 2^32.
+     * @param n The number (must be below 2^32).
+     * @return True if n is prime.
+     */
+    static constexpr bool isPrime(std::uint64_t n) {
+        if (n < SMALL_LIMIT) {
+            return isSmallPrime(static_cast<std::size_t>(n));
+        }
+        for (std::size_t k = 0; k < SMALL_PRIME_COUNT; ++k) {
+            std::uint64_t p = PRIMES[k];
+            if (p * p > n) break;
+            if (n % p == 0) return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Count the primes in [0, n].
+     * @param n The bound (must be below SMALL_LIMIT).
+     * @return pi(n).
+     */
+    static constexpr std::size_t countUpTo(std::size_t n) {
+        std::size_t lo = 0;
+        std::size_t hi = SMALL_PRIME_COUNT;
+        while (lo < hi) {
+            std::size_t mid = (lo + hi) / 2;
+            if (PRIMES[mid] <= n) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+};
+
+/**
+ * @struct WheelTable
+ * @brief Compile-time residue, step and index tables of a factorization wheel.
+ * @tparam Modulus Product of the first few primes (30, 210 or 2310).
+ *
+ * A wheel number is one coprime to Modulus. RESIDUES lists the wheel numbers
+ * in [0, Modulus), STEPS[k] is the gap from RESIDUES[k] to the next wheel
+ * number, and INDEX[r] is the position of the first residue >= r (COUNT when
+ * r is past the last one).
+ */
+template <std::size_t Modulus>
+struct WheelTable {
+    static constexpr std::size_t MODULUS = Modulus;
+    static constexpr std::size_t COUNT = PrimeTableBuilder::countResidues(Modulus);            ///< Euler phi of Modulus
+    static constexpr std::size_t PRIME_COUNT = PrimeTableBuilder::countPrimeFactors(Modulus);  ///< Primes dividing Modulus
+
+    static constexpr std::array<std::size_t, COUNT> RESIDUES =
+        PrimeTableBuilder::makeResidues<Modulus, COUNT>();
+    static constexpr std::array<std::size_t, COUNT> STEPS =
+        PrimeTableBuilder::makeSteps<Modulus, COUNT>(RESIDUES);
+    static constexpr std::array<std::size_t, Modulus> INDEX =
+        PrimeTableBuilder::makeIndex<Modulus, COUNT>(RESIDUES);
+    /// The primes the wheel skips, ascending
+    static constexpr std::array<std::size_t, PRIME_COUNT> PRIMES =
+        PrimeTableBuilder::makePrimeFactors<Modulus, PRIME_COUNT>();
+
+    /**
+     * @brief Check whether a number is coprime to Modulus.
+     * @param n Any number.
+     * @return True if n is a wheel number.
+     */
+    static constexpr bool isWheelNumber(std::size_t n) {
+        std::size_t k = INDEX[n % Modulus];
+        return k < COUNT && RESIDUES[k] == n % Modulus;
+    }
+
+    /**
+     * @brief Smallest wheel number greater than n.
+     * @param n Any number.
+     * @return The next number coprime to Modulus.
+     */
+    static constexpr std::size_t next(std::size_t n) {
+        std::size_t base = n - n % Modulus;
+        std::size_t k = INDEX[n % Modulus];
+        if (isWheelNumber(n)) {
+            return n + STEPS[k];
+        }
+        return k < COUNT ? base + RESIDUES[k] : base + Modulus + RESIDUES[0];
+    }
+
+    /**
+     * @brief Number of wheel numbers below n.
+     *
+     * For a wheel number this is its position among all wheel numbers,
+     * counting 1 as position 0.
+     * @param n Any number.
+     * @return The count.
+     */
+    static constexpr std::size_t indexOf(std::size_t n) {
+        return n / Modulus * COUNT + INDEX[n % Modulus];
+    }
+
+    /**
+     * @brief Wheel number at a position (inverse of indexOf).
+     * @param index The position.
+     * @return The wheel number.
+     */
+    static constexpr std::size_t valueAt(std::size_t index) {
+        return index / COUNT * Modulus + RESIDUES[index % COUNT];
+    }
+};
+
+static_assert(PrimeTables::PRIMES[0] == 2 && PrimeTables::PRIMES[PrimeTables::SMALL_PRIME_COUNT - 1] == 65521,
+              "small prime table must list every prime below 2^16");
+static_assert(PrimeTables::countUpTo(100) == 25 && PrimeTables::countUpTo(10000) == 1229,
+              "small prime table disagrees with pi(x)");
+static_assert(!PrimeTables::isPrime(65521ULL * 65521ULL) && PrimeTables::isPrime(4294967291ULL),
+              "trial division must classify numbers up to 2^32");
+static_assert(WheelTable<30>::COUNT == 8 && WheelTable<210>::COUNT == 48 && WheelTable<2310>::COUNT == 480,
+              "wheel sizes must equal phi(modulus)");
+static_assert(WheelTable<30>::RESIDUES[1] == 7 && WheelTable<30>::STEPS[7] == 2 && WheelTable<30>::next(31) == 37,
+              "mod 30 wheel tables are wrong");
+static_assert(WheelTable<2310>::PRIME_COUNT == 5 && WheelTable<2310>::PRIMES[4] == 11,
+              "mod 2310 wheel must skip 2, 3, 5, 7 and 11");
+
+#endif // PRIME_TABLES_HPP
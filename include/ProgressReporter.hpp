@@ -0,0 +1,129 @@
+#ifndef PROGRESS_REPORTER_HPP
+#define PROGRESS_REPORTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct ProgressInfo
+ * @brief Snapshot of a running sieve.
+ */
+struct ProgressInfo {
+    std::size_t completed = 0;      ///< Integers whose sieving has finished
+    std::size_t total = 0;          ///< Integers to sieve
+    std::size_t current = 0;        ///< Approximate integer reached
+    std::size_t primesFound = 0;    ///< Primes confirmed so far
+    double elapsedSeconds = 0.0;
+    double integersPerSecond = 0.0;
+    double etaSeconds = 0.0;        ///< Estimated time to completion
+    bool finished = false;
+
+    /**
+     * @brief Get the completed fraction.
+     * @return Value in [0, 1].
+     */
+    double fraction() const {
+        return total > 0 ? static_cast<double>(completed) / static_cast<double>(total) : 1.0;
+    }
+};
+
+/**
+ * @class ProgressReporter
+ * @brief Periodically reports how far a parallel sieve has got.
+ *
+ * Sieving threads publish finished blocks into their own cache-line-sized
+ * slot with relaxed atomics, so reporting adds no contention between them.
+ * A background thread sums the slots every interval and passes a
+ * ProgressInfo to the callback; a final snapshot is delivered by finish().
+ */
+class ProgressReporter {
+public:
+    using Callback = std::function<void(const ProgressInfo&)>;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<std::size_t> integers{0};
+        std::atomic<std::size_t> primes{0};
+    };
+
+    Callback callback;
+    std::chrono::milliseconds interval;
+    std::vector<Slot> slots;
+    std::size_t rangeStart = 0;
+    std::size_t total = 0;
+    std::size_t initialPrimes = 0;
+    std::chrono::steady_clock::time_point startTime;
+
+    std::thread sampler;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+
+    void samplerLoop();
+
+public:
+    /**
+     * @brief Construct a reporter.
+     * @param callback Function receiving each snapshot (called from a background thread).
+     * @param interval Time between snapshots.
+     */
+    explicit ProgressReporter(Callback callback,
+                              std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+
+    /**
+     * @brief Destructor; stops the background thread if still running.
+     */
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    /**
+     * @brief Start reporting on a range.
+     * @param start First integer of the range being sieved.
+     * @param end Last integer of the range being sieved.
+     * @param threads Number of sieving threads (one slot each).
+     * @param primesBelowStart Primes already known below start.
+     */
+    void begin(std::size_t start, std::size_t end, int threads, std::size_t primesBelowStart);
+
+    /**
+     * @brief Publish a finished block from a sieving thread.
+     * @param thread Index of the calling thread in [0, threads).
+     * @param integers Number of integers in the block.
+     * @param primes Number of primes found in the block.
+     */
+    void addCompleted(int thread, std::size_t integers, std::size_t primes) {
+        Slot& slot = slots[static_cast<std::size_t>(thread)];
+        // Each slot has a single writer, so load + store is enough
+        slot.integers.store(slot.integers.load(std::memory_order_relaxed) + integers,
+                            std::memory_order_relaxed);
+        slot.primes.store(slot.primes.load(std::memory_order_relaxed) + primes,
+                          std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Stop reporting and deliver the final snapshot.
+     */
+    void finish();
+
+    /**
+     * @brief Take a snapshot now.
+     * @return The current progress.
+     */
+    ProgressInfo sample() const;
+
+    /**
+     * @brief Callback that prints a one-line status to stderr, rewriting it in place.
+     * @return The callback.
+     */
+    static Callback stderrPrinter();
+};
+
+#endif // PROGRESS_REPORTER_HPP
@@ -0,0 +1,126 @@
+#ifndef REGRESSION_GATE_HPP
+#define REGRESSION_GATE_HPP
+
+#include "BenchmarkHarness.hpp"
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct GateConfig
+ * @brief Thresholds for flagging a change against the baseline as a regression.
+ */
+struct GateConfig {
+    double throughputThreshold = 0.05;  ///< Relative throughput drop that fails the gate
+    double memoryThreshold = 0.05;      ///< Relative memory growth that fails the gate
+    double alpha = 0.05;                ///< Significance level of the Mann-Whitney U test
+};
+
+/**
+ * @struct MetricDiff
+ * @brief One metric of one engine configuration, compared with the baseline.
+ */
+struct MetricDiff {
+    enum class Verdict { Ok, Noise, Improvement, Regression, New };
+
+    std::string engine;
+    std::string variant;
+    std::size_t limit = 0;
+    int threads = 1;
+    std::string metric;     ///< "generate", "total" (throughput), "memory" (sieve storage) or "heap" (peak)
+    double baseline = 0.0;  ///< Integers/s for throughput, bytes for memory
+    double current = 0.0;
+    double change = 0.0;    ///< Relative change, positive = better for throughput, larger for memory
+    double pValue = 1.0;    ///< One-sided p-value in the direction of the change (1 for memory)
+    Verdict verdict = Verdict::Ok;
+
+    static const char* verdictName(Verdict verdict);
+};
+
+/**
+ * @struct Baseline
+ * @brief Results loaded from a benchmark JSON file written with --json.
+ */
+struct Baseline {
+    std::string hostClass;
+    std::string revision;
+    std::string label;
+    std::vector<EngineResult> results;
+
+    /**
+     * @brief Load a baseline from a JSON results file.
+     * @param filename Path to the file.
+     * @param baseline Receives the parsed results.
+     * @param error Receives the reason on failure.
+     * @return True if successful, false otherwise.
+     */
+    static bool load(const std::string& filename, Baseline& baseline, std::string& error);
+};
+
+/**
+ * @class RegressionGate
+ * @brief Compares benchmark results against a stored baseline.
+ *
+ * Throughput (integers per second over the generate phase and over all
+ * phases) is compared with a one-sided Mann-Whitney U test on the
+ * per-repetition samples, so a change only counts when it both exceeds the
+ * threshold and is unlikely to be noise. Memory is deterministic and is
+ * compared directly.
+ */
+class RegressionGate {
+private:
+    GateConfig config;
+
+    void compareThroughput(const EngineResult& base, const EngineResult& current, const std::string& metric,
+                           std::vector<MetricDiff>& diffs) const;
+    void compareMemory(const EngineResult& current, const std::string& metric, std::size_t before,
+                       std::size_t after, std::vector<MetricDiff>& diffs) const;
+
+public:
+    explicit RegressionGate(const GateConfig& config = GateConfig()) : config(config) {}
+
+    /**
+     * @brief Compare every current result with the baseline result of the same configuration.
+     * @param baseline The stored results.
+     * @param current The results of this run.
+     * @return One entry per metric and matching configuration; configurations
+     *         missing from the baseline are reported as New.
+     */
+    std::vector<MetricDiff> compare(const std::vector<EngineResult>& baseline,
+                                    const std::vector<EngineResult>& current) const;
+
+    /**
+     * @brief One-sided Mann-Whitney U test that samples of b tend to be larger than those of a.
+     *
+     * Uses the normal approximation with tie and continuity corrections.
+     * @param a First sample.
+     * @param b Second sample.
+     * @return The p-value.
+     */
+    static double mannWhitneyGreater(const std::vector<double>& a, const std::vector<double>& b);
+
+    /**
+     * @brief Check whether any metric failed the gate.
+     * @param diffs The comparison.
+     * @return True if at least one metric regressed.
+     */
+    static bool hasRegressions(const std::vector<MetricDiff>& diffs);
+
+    /**
+     * @brief Print the comparison as a table.
+     * @param os The stream to print to.
+     * @param diffs The comparison.
+     */
+    void writeTable(std::ostream& os, const std::vector<MetricDiff>& diffs) const;
+
+    /**
+     * @brief Resolve a baseline path: a directory holds one file per host class.
+     * @param path File or directory given on the command line.
+     * @param host The host the benchmark runs on.
+     * @return The file to read or write.
+     */
+    static std::string baselineFile(const std::string& path, const HostInfo& host);
+};
+
+#endif // REGRESSION_GATE_HPP
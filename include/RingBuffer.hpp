@@ -0,0 +1,177 @@
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/// Separates the producer and consumer indices so they never share a cache line
+constexpr std::size_t RING_CACHE_LINE = 64;
+
+/**
+ * @brief Round a ring capacity up to a power of two (at least 2).
+ * @param capacity Requested capacity.
+ * @return The capacity actually used.
+ */
+inline std::size_t ringCapacity(std::size_t capacity) {
+    std::size_t size = 2;
+    while (size < capacity) size *= 2;
+    return size;
+}
+
+/**
+ * @class SpscRing
+ * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread.
+ * @tparam T Element type (default-constructible, movable).
+ *
+ * The producer owns the tail and the consumer the head; each publishes its
+ * index with a release store and reads the other's with an acquire load, so
+ * an element is fully written before the consumer can see it. Each side
+ * caches the other's index and only reloads it when the ring looks full or
+ * empty.
+ */
+template <typename T>
+class SpscRing {
+private:
+    std::unique_ptr<T[]> slots;
+    std::size_t mask;
+
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> head{0};
+    std::size_t cachedTail = 0;      // Consumer's copy of tail
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> tail{0};
+    std::size_t cachedHead = 0;      // Producer's copy of head
+
+public:
+    /**
+     * @brief Create an empty ring.
+     * @param capacity Number of elements it can hold, rounded up to a power of two.
+     */
+    explicit SpscRing(std::size_t capacity)
+        : slots(new T[ringCapacity(capacity)]), mask(ringCapacity(capacity) - 1) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /// Number of elements the ring can hold
+    std::size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Append an element (producer thread only).
+     * @param value The element.
+     * @return False if the ring is full; the element is then left untouched.
+     */
+    bool tryPush(T& value) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead > mask) return false;
+        }
+        slots[t & mask] = std::move(value);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest element (consumer thread only).
+     * @param value Receives the element.
+     * @return False if the ring is empty.
+     */
+    bool tryPop(T& value) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return false;
+        }
+        value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+/**
+ * @class MpscRing
+ * @brief Bounded lock-free queue for any number of producer threads and one consumer thread.
+ * @tparam T Element type (default-constructible, movable).
+ *
+ * Each slot carries a sequence number (Vyukov's bounded queue): a producer
+ * claims a position with a compare-exchange on the tail, writes the element
+ * and then releases the slot by advancing its sequence; the consumer reads a
+ * slot only once its sequence says it was written, and hands it back for the
+ * next lap of the ring the same way.
+ */
+template <typename T>
+class MpscRing {
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> tail{0};
+    alignas(RING_CACHE_LINE) std::size_t head = 0;   // Consumer only
+
+public:
+    /**
+     * @brief Create an empty ring.
+     * @param capacity Number of elements it can hold, rounded up to a power of two.
+     */
+    explicit MpscRing(std::size_t capacity)
+        : slots(new Slot[ringCapacity(capacity)]), mask(ringCapacity(capacity) - 1) {
+        for (std::size_t i = 0; i <= mask; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /// Number of elements the ring can hold
+    std::size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Append an element (any thread).
+     * @param value The element.
+     * @return False if the ring is full; the element is then left untouched.
+     */
+    bool tryPush(T& value) {
+        std::size_t position = tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence == position) {
+                // Free for this lap: claim it, or retry from the position another producer left
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (sequence < position) {
+                return false;  // Still holds last lap's element: full
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Take the oldest element (consumer thread only).
+     * @param value Receives the element.
+     * @return False if the ring is empty or its oldest element is still being written.
+     */
+    bool tryPop(T& value) {
+        Slot& slot = slots[head & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        value = std::move(slot.value);
+        slot.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+};
+
+#endif // RING_BUFFER_HPP
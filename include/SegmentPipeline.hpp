@@ -0,0 +1,143 @@
+#ifndef SEGMENT_PIPELINE_HPP
+#define SEGMENT_PIPELINE_HPP
+
+#include "RingBuffer.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct FinishedSegment
+ * @brief A copy of one fully sieved segment of a bit-packed sieve.
+ */
+struct FinishedSegment {
+    std::size_t sequence = 0;       ///< Position of the segment in the range, from 0
+    std::size_t low = 0;            ///< First number, a multiple of 64
+    std::size_t high = 0;           ///< Last number
+    std::vector<uint64_t> words;    ///< Bit i of words[w] stands for low + 64 * w + i
+
+    /**
+     * @brief Call a visitor with every prime of the segment, in ascending order.
+     * @param visit Callable taking the prime.
+     */
+    template <typename Visitor>
+    void forEachPrime(Visitor visit) const {
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            uint64_t word = words[w];
+            while (word != 0) {
+                std::size_t n = low + w * 64 + static_cast<std::size_t>(__builtin_ctzll(word));
+                if (n > high) return;
+                visit(n);
+                word &= word - 1;
+            }
+        }
+    }
+
+    /**
+     * @brief Count the primes of the segment.
+     * @return Set bits in [low, high].
+     */
+    std::size_t count() const;
+};
+
+/**
+ * @class SegmentPipeline
+ * @brief Bounded hand-off of finished segments from sieving threads to one ordered consumer.
+ *
+ * Producers finish segments in any order, copy each into the slot of its
+ * sequence number and announce it through a lock-free ring (SpscRing for a
+ * single producer, MpscRing otherwise). A consumer thread reassembles the
+ * sequence and calls the consumer for segment 0, 1, 2, ... in order, so a
+ * file writer or gap analyzer overlaps with sieving.
+ *
+ * At most capacity segments are finished but not yet consumed: a producer
+ * asking for a slot further ahead spins until the consumer catches up, which
+ * bounds memory and throttles sieving to the consumer's pace. Producers must
+ * take sequence numbers in increasing order per thread, and the lowest
+ * sequence not yet published must always belong to a running producer (true
+ * for consecutive chunks under an OpenMP dynamic schedule).
+ */
+class SegmentPipeline {
+public:
+    using Consumer = std::function<void(const FinishedSegment&)>;
+
+    /**
+     * @brief Start the consumer thread.
+     * @param capacity Segments that may be finished but not consumed (at least 1).
+     * @param producers Number of producer threads (1 selects the SPSC ring).
+     * @param consumer Called on the consumer thread with each segment, in sequence order.
+     */
+    SegmentPipeline(std::size_t capacity, int producers, Consumer consumer);
+
+    /**
+     * @brief Stop the consumer thread, abandoning unconsumed segments if finish() was not called.
+     */
+    ~SegmentPipeline();
+
+    SegmentPipeline(const SegmentPipeline&) = delete;
+    SegmentPipeline& operator=(const SegmentPipeline&) = delete;
+
+    /**
+     * @brief Get the slot for a segment, waiting while it is more than capacity ahead of the consumer.
+     * @param sequence Sequence number of the segment about to be published.
+     * @return The slot to fill, owned by the caller until publish(), or nullptr once cancel() was called.
+     */
+    FinishedSegment* acquire(std::size_t sequence);
+
+    /**
+     * @brief Hand a filled slot to the consumer.
+     * @param sequence Sequence number passed to acquire().
+     */
+    void publish(std::size_t sequence);
+
+    /**
+     * @brief Wait until segments [0, segments) were consumed and stop the consumer thread.
+     *
+     * Rethrows the first exception thrown by the consumer; segments after it
+     * are drained without calling the consumer again.
+     * @param segments Total number of segments published.
+     */
+    void finish(std::size_t segments);
+
+    /**
+     * @brief Give up on the remaining segments, e.g. when sieving was cancelled.
+     *
+     * Producers waiting in acquire() return nullptr and the consumer stops
+     * after the segment it is working on, so the consumer has seen a prefix
+     * of the sequence. Call from any thread; finish() must not follow.
+     */
+    void cancel();
+
+    /// Segments that may be finished but not consumed
+    std::size_t getCapacity() const { return slots.size(); }
+
+    /// Number of acquire() calls that had to wait for the consumer (backpressure)
+    std::size_t getProducerStalls() const { return producerStalls.load(std::memory_order_relaxed); }
+
+    /// Number of times the consumer found nothing to do
+    std::size_t getConsumerWaits() const { return consumerWaits.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<FinishedSegment> slots;     // Segment s lives in slots[s % capacity]
+    std::unique_ptr<SpscRing<std::size_t>> spsc;
+    std::unique_ptr<MpscRing<std::size_t>> mpsc;
+    Consumer consumer;
+
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> consumed{0};  // Every sequence below it is free
+    alignas(RING_CACHE_LINE) std::atomic<std::size_t> total;
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> cancelled{false};
+    std::atomic<std::size_t> producerStalls{0};
+    std::atomic<std::size_t> consumerWaits{0};
+    std::exception_ptr error;
+    std::thread consumerThread;
+
+    void consumerLoop();
+};
+
+#endif // SEGMENT_PIPELINE_HPP
@@ -0,0 +1,204 @@
+#ifndef SIEVE_JOB_POOL_HPP
+#define SIEVE_JOB_POOL_HPP
+
+#include "CancellationToken.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @enum SieveEngine
+ * @brief The parallel engine a job runs.
+ */
+enum class SieveEngine {
+    Basic,   ///< ParallelBasicSieve
+    Bit,     ///< ParallelBitSieve
+    Wheel,   ///< ParallelWheelSieve (mod 30)
+    Atkin    ///< ParallelAtkinSieve
+};
+
+/**
+ * @enum JobStatus
+ * @brief Where a job is in its life cycle.
+ */
+enum class JobStatus {
+    Queued,      ///< Waiting for a pool worker
+    Running,     ///< Being sieved
+    Completed,   ///< Finished; the result holds the primes
+    Cancelled,   ///< Stopped by cancel(), by dropping every handle, or by the pool shutting down
+    TimedOut,    ///< Stopped because its deadline passed
+    Failed       ///< The engine threw (e.g. std::bad_alloc); the result holds the message
+};
+
+/**
+ * @struct SieveJobRequest
+ * @brief What to sieve and how long it may take.
+ */
+struct SieveJobRequest {
+    SieveEngine engine = SieveEngine::Bit;
+    std::size_t limit = 0;
+    int threads = 0;                                  ///< OpenMP threads (0 for the pool's share of the CPUs)
+    std::chrono::steady_clock::duration timeout{0};   ///< Deadline measured from submit() (0 for none)
+    bool keepPrimes = true;                           ///< Return the primes rather than only their count
+};
+
+/**
+ * @struct SieveJobResult
+ * @brief Outcome of a job.
+ */
+struct SieveJobResult {
+    JobStatus status = JobStatus::Queued;
+    std::vector<std::size_t> primes;   ///< Empty unless completed with keepPrimes
+    std::size_t primeCount = 0;        ///< Valid when completed
+    double seconds = 0.0;              ///< Time spent running, excluding the queue
+    std::string error;                 ///< Reason for a failure
+};
+
+struct SieveJobState;
+
+/**
+ * @class SieveJob
+ * @brief Handle to a submitted job: wait for it, poll it, or cancel it.
+ *
+ * Handles are cheap to copy. When the last handle is destroyed the job is
+ * cancelled, so work whose client went away stops using CPU at the next
+ * block boundary; call detach() to let it run to completion (for example
+ * when only the completion callback matters).
+ */
+class SieveJob {
+private:
+    std::shared_ptr<SieveJobState> state;
+    std::shared_ptr<void> interest;    // Cancels the job when the last handle lets go
+
+    friend class SieveJobPool;
+
+    // The job's state; throws std::future_error(no_state) for an empty handle
+    SieveJobState& shared() const;
+
+public:
+    SieveJob() = default;
+
+    /// True if the handle refers to a job
+    bool valid() const { return state != nullptr; }
+
+    /**
+     * @brief Ask the job to stop; a queued job completes as cancelled at once and never starts.
+     */
+    void cancel();
+
+    /**
+     * @brief Keep the job running after every handle is gone.
+     */
+    void detach();
+
+    /**
+     * @brief Get the job's current status without blocking.
+     * @return The status.
+     */
+    JobStatus status() const;
+
+    /**
+     * @brief Wait for the job to finish, whatever the outcome.
+     * @param timeout Longest time to wait.
+     * @return True if the job finished in time.
+     * @throws std::future_error with no_state if the handle is not valid().
+     */
+    bool waitFor(std::chrono::steady_clock::duration timeout) const;
+
+    /**
+     * @brief Wait for the job and get its result.
+     * @return The result, shared by every handle.
+     * @throws std::future_error with no_state if the handle is not valid().
+     */
+    const SieveJobResult& get() const;
+
+    /**
+     * @brief Get a future for the result, e.g. to compose with other futures.
+     * @return Shared future that becomes ready when the job finishes.
+     * @throws std::future_error with no_state if the handle is not valid().
+     */
+    std::shared_future<SieveJobResult> future() const;
+};
+
+/**
+ * @class SieveJobPool
+ * @brief Runs sieve jobs on the library's own worker threads, so callers never block.
+ *
+ * Each worker takes one job at a time from a FIFO queue and runs its engine
+ * with an OpenMP team of the requested size. A job's CancellationToken
+ * combines cancel() with its deadline and is polled by the sieving threads
+ * between blocks. Completion callbacks run on the worker thread just before
+ * the result is published, or on the cancelling thread for a job cancelled
+ * while still queued, so get() returns only after the callback did; a
+ * callback must therefore not wait for its own job. Exceptions they throw
+ * are discarded.
+ */
+class SieveJobPool {
+public:
+    using Callback = std::function<void(const SieveJobResult&)>;
+
+    /**
+     * @brief Start the workers.
+     * @param workers Jobs run at the same time (at least 1).
+     */
+    explicit SieveJobPool(int workers = 1);
+
+    /**
+     * @brief Cancel queued and running jobs and join the workers.
+     *
+     * Every job still gets its result and callback.
+     */
+    ~SieveJobPool();
+
+    SieveJobPool(const SieveJobPool&) = delete;
+    SieveJobPool& operator=(const SieveJobPool&) = delete;
+
+    /**
+     * @brief Queue a job.
+     * @param request What to sieve.
+     * @param onComplete Called with the result on the worker thread before get() returns (optional).
+     * @return Handle to the job.
+     */
+    SieveJob submit(const SieveJobRequest& request, Callback onComplete = {});
+
+    /// Number of workers
+    int getWorkerCount() const { return static_cast<int>(workers.size()); }
+
+    /// Number of jobs waiting for a worker
+    std::size_t getQueuedCount() const;
+
+    /**
+     * @brief Get the OpenMP threads a job with threads = 0 runs with.
+     * @return The CPU budget split between the workers, at least 1.
+     */
+    int getDefaultThreads() const { return defaultThreads; }
+
+    /**
+     * @brief Get the name of a status.
+     * @param status The status.
+     * @return "queued", "running", "completed", "cancelled", "timed out" or "failed".
+     */
+    static const char* statusName(JobStatus status);
+
+private:
+    int defaultThreads;
+    std::vector<std::thread> workers;
+    std::deque<std::shared_ptr<SieveJobState>> queue;
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    bool shuttingDown = false;
+    std::vector<std::shared_ptr<SieveJobState>> running;
+
+    void workerLoop();
+    void run(SieveJobState& job);
+};
+
+#endif // SIEVE_JOB_POOL_HPP
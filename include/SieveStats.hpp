@@ -0,0 +1,123 @@
+#ifndef SIEVE_STATS_HPP
+#define SIEVE_STATS_HPP
+
+#include "CacheTopology.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @struct SieveStats
+ * @brief Per-phase timings and crossing-off counts recorded by a sieve engine.
+ *
+ * Sieving primes are split into three tiers by size: small primes hit every
+ * L1-sized block many times, medium primes hit an L2-sized segment at least
+ * once, and large primes hit most segments not at all. Each tier is timed
+ * and counted separately.
+ */
+struct SieveStats {
+    static constexpr std::size_t TIER_COUNT = 3;
+
+    // Tier boundaries of a host with the default 32 KiB L1d and 256 KiB L2:
+    // small primes hit a 32 KiB block of bits at least 16 times, medium primes
+    // are shorter than a 256 KiB segment of bits
+    static constexpr std::size_t DEFAULT_SMALL_PRIME_LIMIT = 32 * 1024 * 8 / 16;
+    static constexpr std::size_t DEFAULT_MEDIUM_PRIME_LIMIT = 256 * 1024 * 8;
+
+    double allocationSeconds = 0.0;   ///< Storage allocation and initialization
+    double presieveSeconds = 0.0;     ///< Pre-marking of wheel primes (2, 3, 5)
+    double basePrimesSeconds = 0.0;   ///< Finding the sieving primes up to sqrt(limit)
+    double quadraticFormSeconds = 0.0;  ///< Toggling quadratic-form solutions (Sieve of Atkin only)
+    std::array<double, TIER_COUNT> crossOffSeconds{};  ///< Small, medium, large tiers
+    double extractionSeconds = 0.0;   ///< getPrimes() / getPrimeCount()
+    double outputSeconds = 0.0;       ///< printPrimes() / savePrimesToFile()
+
+    std::size_t basePrimeCount = 0;
+    std::array<std::size_t, TIER_COUNT> crossOffs{};  ///< Bits cleared per tier
+    std::size_t toggles = 0;  ///< Quadratic-form solutions toggled (Sieve of Atkin only)
+
+    std::size_t smallPrimeLimit = CacheTopology::host().smallPrimeLimit();    ///< Derived from the L1d size
+    std::size_t mediumPrimeLimit = CacheTopology::host().mediumPrimeLimit();  ///< Derived from the L2 share
+
+    /**
+     * @brief Get the display name of a tier.
+     * @param tier Tier index (0 = small, 1 = medium, 2 = large).
+     * @return The tier name.
+     */
+    static const char* tierName(std::size_t tier);
+
+    /**
+     * @brief Number of multiples of step in [start, end].
+     */
+    static std::size_t multiplesInRange(std::size_t start, std::size_t end, std::size_t step) {
+        return start > end ? 0 : (end - start) / step + 1;
+    }
+
+    /**
+     * @brief Split an ascending list of sieving primes into tiers.
+     * @param primes Sieving primes in ascending order.
+     * @return Index bounds: tier t covers [bounds[t], bounds[t + 1]).
+     */
+    std::array<std::size_t, TIER_COUNT + 1> tierBounds(const std::vector<std::size_t>& primes) const;
+
+    /**
+     * @brief Total time spent crossing off multiples (and toggling, for Atkin).
+     * @return Seconds over all tiers.
+     */
+    double sievingSeconds() const;
+
+    /**
+     * @brief Total time over all recorded phases.
+     * @return Seconds.
+     */
+    double totalSeconds() const;
+
+    /**
+     * @brief Total number of crossing-off operations (and toggles, for Atkin).
+     * @return Operations over all tiers.
+     */
+    std::size_t totalCrossOffs() const;
+
+    /**
+     * @brief Add a finished generate() to the global metrics registry.
+     * @param integers Number of integers covered by the sieve.
+     */
+    void publishMetrics(std::size_t integers) const;
+
+    /**
+     * @brief Format the statistics as indented text.
+     * @return Multi-line text.
+     */
+    std::string toText() const;
+
+    /**
+     * @brief Format the statistics as a JSON object.
+     * @return JSON text.
+     */
+    std::string toJson() const;
+};
+
+/**
+ * @class ScopedPhaseTimer
+ * @brief Adds the lifetime of the timer to a SieveStats phase.
+ */
+class ScopedPhaseTimer {
+private:
+    double& target;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedPhaseTimer(double& seconds)
+        : target(seconds), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedPhaseTimer() {
+        target += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    ScopedPhaseTimer(const ScopedPhaseTimer&) = delete;
+    ScopedPhaseTimer& operator=(const ScopedPhaseTimer&) = delete;
+};
+
+#endif // SIEVE_STATS_HPP
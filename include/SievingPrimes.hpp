@@ -0,0 +1,47 @@
+#ifndef SIEVING_PRIMES_HPP
+#define SIEVING_PRIMES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @struct SievingPrimes
+ * @brief Sieving primes and their next multiples, carried from one segment to the next.
+ *
+ * Structure of arrays: entry k of each vector belongs to primes[k]. A segmented
+ * engine seeds the multiples once per range of consecutive segments (the only
+ * division per prime), and crossing off a segment leaves each multiple at the
+ * first one past the segment, ready for the next. The steady state therefore
+ * needs no division.
+ */
+struct SievingPrimes {
+    std::vector<std::size_t> primes;
+    std::vector<std::size_t> multiples;          ///< Next multiple to cross off
+    std::vector<std::uint32_t> wheelIndices;     ///< Wheel position of the next multiple's cofactor (wheel engines)
+
+    SievingPrimes() = default;
+
+    /**
+     * @brief Take a copy of the sieving primes; the multiples still need seeding.
+     * @param basePrimes Sieving primes in ascending order.
+     */
+    explicit SievingPrimes(const std::vector<std::size_t>& basePrimes)
+        : primes(basePrimes), multiples(basePrimes.size()) {}
+
+    std::size_t size() const { return primes.size(); }
+
+    /**
+     * @brief Seed each multiple with the first one at or above low, but no lower than p*p.
+     * @param low First index of the range about to be sieved.
+     */
+    void seed(std::size_t low) {
+        for (std::size_t k = 0; k < primes.size(); ++k) {
+            std::size_t p = primes[k];
+            multiples[k] = std::max(p * p, (low + p - 1) / p * p);
+        }
+    }
+};
+
+#endif // SIEVING_PRIMES_HPP
@@ -0,0 +1,191 @@
+#ifndef TIERED_CROSS_OFF_HPP
+#define TIERED_CROSS_OFF_HPP
+
+#include "SieveStats.hpp"
+#include "SievingPrimes.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class TieredCrossOff
+ * @brief Segmented crossing-off core of the bit-packed Eratosthenes engines.
+ *
+ * A range is sieved one L2-sized segment at a time, with a different loop
+ * for each SieveStats tier:
+ * - small primes cross off one L1-sized block of the segment at a time, so
+ *   their many hits per segment stay in L1;
+ * - medium primes, which hit a segment at least once, run an unrolled loop
+ *   over the whole segment;
+ * - large primes, which skip most segments, are kept in buckets keyed by the
+ *   segment of their next multiple, so a segment only touches the primes
+ *   that hit it. The ring of buckets reaches one prime ahead; primes whose
+ *   first multiple (p*p) lies further out wait in a pending list until the
+ *   ring reaches their segment.
+ *
+ * Small and medium primes keep their next multiple in a SievingPrimes state
+ * that each segment advances, so only the start of a range divides.
+ *
+ * Segment and block sizes follow the tier limits of the SieveStats passed
+ * in (mediumPrimeLimit indices per segment, 16 * smallPrimeLimit per block).
+ * Bit n of the array stands for the number n; a cleared bit is composite.
+ */
+class TieredCrossOff {
+private:
+    /// A large prime and its next multiple in the range
+    struct BucketEntry {
+        std::size_t prime;
+        std::size_t multiple;
+    };
+
+    SievingPrimes state;
+    std::array<std::size_t, SieveStats::TIER_COUNT + 1> bounds;
+    std::size_t segmentSize;
+    std::size_t blockSize;
+
+    std::array<std::size_t, SieveStats::TIER_COUNT> crossOffs{};
+    std::array<double, SieveStats::TIER_COUNT> seconds{};
+
+    // Ring of buckets, one per segment within reach of the largest prime;
+    // bucket s % size holds only the primes hitting segment s
+    std::vector<std::vector<BucketEntry>> buckets;
+
+    // Large primes whose first multiple lies beyond the ring, latest first
+    std::vector<BucketEntry> pending;
+
+    // Range being sieved by sieveNextSegment()
+    std::size_t rangeLow = 0;
+    std::size_t rangeHigh = 0;
+    std::size_t nextSegment = 0;
+    bool rangeDone = true;
+
+    /**
+     * @brief Seed the multiples and file each large prime under the segment of its first multiple.
+     */
+    void beginRange(std::size_t low, std::size_t high);
+
+    /**
+     * @brief Run the three tiers over one segment, timing each.
+     */
+    void sieveSegment(uint64_t* bits, std::size_t segment, std::size_t low, std::size_t high,
+                      std::size_t rangeLow, std::size_t rangeHigh);
+
+    /**
+     * @brief Cross off the small primes one L1 block at a time.
+     * @return Bits cleared.
+     */
+    std::size_t crossOffSmall(uint64_t* bits, std::size_t low, std::size_t high);
+
+    /**
+     * @brief Cross off the medium primes over the whole segment, four multiples per iteration.
+     * @return Bits cleared.
+     */
+    std::size_t crossOffMedium(uint64_t* bits, std::size_t high);
+
+    /**
+     * @brief Cross off the large primes filed under this segment and refile them.
+     * @return Bits cleared.
+     */
+    std::size_t crossOffLarge(uint64_t* bits, std::size_t segment, std::size_t rangeLow, std::size_t rangeHigh);
+
+public:
+    /**
+     * @brief Prepare the crossing-off of the given sieving primes.
+     * @param primes Sieving primes in ascending order (copied into the per-prime state).
+     * @param stats Statistics whose tier limits select the tiers and sizes.
+     */
+    TieredCrossOff(const std::vector<std::size_t>& primes, const SieveStats& stats);
+
+    /**
+     * @brief Get the segment size used with the tier limits of some statistics.
+     * @param stats Statistics whose mediumPrimeLimit sets the segment size.
+     * @return Indices per segment, a multiple of 64.
+     */
+    static std::size_t segmentSizeFor(const SieveStats& stats) {
+        return std::max<std::size_t>(stats.mediumPrimeLimit / 64 * 64, 64);
+    }
+
+    /**
+     * @brief Get the segment size.
+     * @return Indices per segment, a multiple of 64.
+     */
+    std::size_t getSegmentSize() const { return segmentSize; }
+
+    /**
+     * @brief Cross off the multiples of every sieving prime in [low, high], segment by segment.
+     *
+     * Multiples below p*p are left alone. Segments start at low and are a
+     * multiple of 64 indices long, so a word-aligned low keeps each segment in
+     * its own words for concurrent callers on disjoint ranges.
+     * @param bits The bit array covering at least [low, high].
+     * @param low First index of the range.
+     * @param high Last index of the range.
+     * @param onSegment Called with (segmentLow, segmentHigh) after each segment; if it
+     *        returns bool, false stops the range after that segment.
+     */
+    template <typename Callback>
+    void sieve(std::vector<uint64_t>& bits, std::size_t low, std::size_t high, Callback onSegment);
+
+    /**
+     * @brief Start crossing off [low, high] one sieveNextSegment() call at a time.
+     *
+     * The state between calls is kept here, so a caller can stop after any
+     * segment and resume later.
+     * @param low First index of the range.
+     * @param high Last index of the range (an empty range is already done).
+     */
+    void startRange(std::size_t low, std::size_t high);
+
+    /**
+     * @brief Cross off the next segment of the range given to startRange().
+     * @param bits The bit array covering the range.
+     * @param segmentHigh Receives the last index of the segment; every index up to it is final.
+     * @return False, leaving segmentHigh alone, if the range was already done.
+     */
+    bool sieveNextSegment(std::vector<uint64_t>& bits, std::size_t& segmentHigh);
+
+    /**
+     * @brief Check whether the range given to startRange() has been crossed off completely.
+     * @return True once the last segment was sieved.
+     */
+    bool isRangeDone() const { return rangeDone; }
+
+    /**
+     * @brief Cross off [low, high] without a per-segment callback.
+     */
+    void sieve(std::vector<uint64_t>& bits, std::size_t low, std::size_t high) {
+        sieve(bits, low, high, [](std::size_t, std::size_t) {});
+    }
+
+    /**
+     * @brief Get the bits cleared per tier so far.
+     * @return Counts for the small, medium and large tiers.
+     */
+    const std::array<std::size_t, SieveStats::TIER_COUNT>& getCrossOffs() const { return crossOffs; }
+
+    /**
+     * @brief Get the time spent per tier so far.
+     * @return Seconds for the small, medium and large tiers.
+     */
+    const std::array<double, SieveStats::TIER_COUNT>& getSeconds() const { return seconds; }
+};
+
+template <typename Callback>
+void TieredCrossOff::sieve(std::vector<uint64_t>& bits, std::size_t low, std::size_t high, Callback onSegment) {
+    startRange(low, high);
+    std::size_t segmentLow = low;
+    std::size_t segmentHigh = 0;
+    while (sieveNextSegment(bits, segmentHigh)) {
+        if constexpr (std::is_same_v<decltype(onSegment(segmentLow, segmentHigh)), bool>) {
+            if (!onSegment(segmentLow, segmentHigh)) break;
+        } else {
+            onSegment(segmentLow, segmentHigh);
+        }
+        segmentLow = segmentHigh + 1;
+    }
+}
+
+#endif // TIERED_CROSS_OFF_HPP
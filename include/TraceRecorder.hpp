@@ -0,0 +1,180 @@
+#ifndef TRACE_RECORDER_HPP
+#define TRACE_RECORDER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TraceEvent
+ * @brief One completed span of work on one thread.
+ *
+ * Names, categories and argument names must be string literals (or otherwise
+ * outlive the recorder); only the pointers are stored.
+ */
+struct TraceEvent {
+    const char* name = nullptr;
+    const char* category = nullptr;
+    std::uint64_t startNs = 0;
+    std::uint64_t endNs = 0;
+    const char* argNames[2] = {nullptr, nullptr};
+    std::uint64_t argValues[2] = {0, 0};
+};
+
+/**
+ * @class TraceRecorder
+ * @brief Per-thread timeline of begin/end spans in Chrome trace format.
+ *
+ * Each thread that records an event gets its own fixed-size ring buffer on
+ * first use, so recording never takes a lock; when a ring is full the oldest
+ * events are overwritten. The result loads into Perfetto (ui.perfetto.dev)
+ * or chrome://tracing.
+ *
+ * Instrumented code does not receive the recorder explicitly: it uses
+ * TraceScope, which records into the recorder made active with setActive()
+ * and costs a single atomic load when tracing is off.
+ */
+class TraceRecorder {
+public:
+    static constexpr std::size_t DEFAULT_EVENTS_PER_THREAD = 1 << 16;
+
+private:
+    struct ThreadBuffer {
+        std::vector<TraceEvent> events;
+        std::size_t next = 0;        // Total events recorded; next slot is next % capacity
+        std::uint64_t tid = 0;
+        std::string threadName;
+    };
+
+    std::size_t eventsPerThread;
+    std::chrono::steady_clock::time_point origin;
+    std::uint64_t id;
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+
+    static std::atomic<TraceRecorder*> activeRecorder;
+
+    /**
+     * @brief Get the calling thread's buffer, registering it on first use.
+     * @return The thread's ring buffer.
+     */
+    ThreadBuffer& threadBuffer();
+
+public:
+    /**
+     * @brief Construct a recorder.
+     * @param eventsPerThread Ring buffer capacity of each thread.
+     */
+    explicit TraceRecorder(std::size_t eventsPerThread = DEFAULT_EVENTS_PER_THREAD);
+
+    /**
+     * @brief Destructor; deactivates the recorder if it is still active.
+     */
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * @brief Make a recorder the target of TraceScope.
+     * @param recorder Recorder to activate, or nullptr to stop tracing.
+     */
+    static void setActive(TraceRecorder* recorder) {
+        activeRecorder.store(recorder, std::memory_order_release);
+    }
+
+    /**
+     * @brief Get the active recorder.
+     * @return The active recorder, or nullptr when tracing is off.
+     */
+    static TraceRecorder* active() {
+        return activeRecorder.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get the current time on the trace clock.
+     * @return Nanoseconds since the recorder was constructed.
+     */
+    std::uint64_t now() const {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - origin).count());
+    }
+
+    /**
+     * @brief Record a completed span on the calling thread.
+     * @param event The event to append to the thread's ring.
+     */
+    void record(const TraceEvent& event);
+
+    /**
+     * @brief Get the number of events lost to ring wrap-around.
+     * Call once the traced work has finished.
+     * @return Overwritten events over all threads.
+     */
+    std::size_t droppedEvents();
+
+    /**
+     * @brief Format all recorded events as a Chrome trace JSON document.
+     * Call once the traced work has finished.
+     * @return JSON text.
+     */
+    std::string toJson();
+
+    /**
+     * @brief Write the trace to a file.
+     * @param filename Destination path.
+     * @return True if successful, false otherwise.
+     */
+    bool writeJson(const std::string& filename);
+};
+
+/**
+ * @class TraceScope
+ * @brief Records its own lifetime as a span in the active TraceRecorder.
+ */
+class TraceScope {
+private:
+    TraceRecorder* recorder;
+    TraceEvent event;
+
+public:
+    TraceScope(const char* name, const char* category) : recorder(TraceRecorder::active()) {
+        if (recorder) {
+            event.name = name;
+            event.category = category;
+            event.startNs = recorder->now();
+        }
+    }
+
+    TraceScope(const char* name, const char* category,
+               const char* argName, std::uint64_t argValue)
+        : TraceScope(name, category) {
+        event.argNames[0] = argName;
+        event.argValues[0] = argValue;
+    }
+
+    TraceScope(const char* name, const char* category,
+               const char* argName0, std::uint64_t argValue0,
+               const char* argName1, std::uint64_t argValue1)
+        : TraceScope(name, category, argName0, argValue0) {
+        event.argNames[1] = argName1;
+        event.argValues[1] = argValue1;
+    }
+
+    ~TraceScope() {
+        if (recorder) {
+            event.endNs = recorder->now();
+            recorder->record(event);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+};
+
+#endif // TRACE_RECORDER_HPP
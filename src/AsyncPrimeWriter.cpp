@@ -0,0 +1,322 @@
+#include "AsyncPrimeWriter.hpp"
+#include "MetricsRegistry.hpp"
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef PRIME_SIEVE_HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+AsyncPrimeWriter::AsyncPrimeWriter(std::size_t bufferSize, std::size_t bufferCount, Backend backend)
+    : bufferSize(std::max(bufferSize, MAX_RECORD_SIZE)),
+      bufferCount(std::max(bufferCount, static_cast<std::size_t>(2))),
+      requestedBackend(backend) {
+}
+
+AsyncPrimeWriter::~AsyncPrimeWriter() {
+    if (fd >= 0) {
+        close();
+    }
+}
+
+bool AsyncPrimeWriter::open(const std::string& filename) {
+    if (fd >= 0) {
+        return false;
+    }
+
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    buffers.assign(bufferCount, std::vector<char>(bufferSize));
+    freeBuffers.clear();
+    for (std::size_t i = bufferCount - 1; i > 0; --i) {
+        freeBuffers.push_back(i);
+    }
+    currentIndex = 0;
+    current = buffers[0].data();
+    fill = 0;
+    fileOffset = 0;
+    failed = false;
+    dropping = false;
+    stats = OutputStats();
+    startTime = std::chrono::steady_clock::now();
+
+    if (requestedBackend != Backend::Thread && startIoUring()) {
+        usingIoUring = true;
+        stats.backend = "io_uring";
+    } else if (requestedBackend == Backend::IoUring) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    } else {
+        usingIoUring = false;
+        stats.backend = "thread+pwrite";
+        stopping = false;
+        pending.clear();
+        writerThread = std::thread(&AsyncPrimeWriter::writerLoop, this);
+    }
+
+    return true;
+}
+
+void AsyncPrimeWriter::flushCurrent() {
+    if (fill == 0) {
+        return;
+    }
+
+    PendingWrite write{currentIndex, fill, fileOffset, 0};
+    fileOffset += fill;
+    stats.bytesWritten += fill;
+    fill = 0;
+
+    if (usingIoUring) {
+        submitIoUring(write);
+    } else {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(write);
+        cv.notify_all();
+    }
+}
+
+void AsyncPrimeWriter::submitCurrent() {
+    flushCurrent();
+    if (!acquireBuffer(currentIndex)) {
+        dropping = true;
+        return;
+    }
+    current = buffers[currentIndex].data();
+}
+
+bool AsyncPrimeWriter::acquireBuffer(std::size_t& index) {
+    if (usingIoUring) {
+        while (freeBuffers.empty()) {
+            if (!reapIoUring(true)) {
+                // The ring itself failed and every buffer may still be owned
+                // by the kernel, so the output is lost; drop further writes
+                failed = true;
+                return false;
+            }
+        }
+        index = freeBuffers.back();
+        freeBuffers.pop_back();
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [this] { return !freeBuffers.empty(); });
+    index = freeBuffers.back();
+    freeBuffers.pop_back();
+    return true;
+}
+
+void AsyncPrimeWriter::writerLoop() {
+    for (;;) {
+        PendingWrite write;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+            write = pending.front();
+            pending.pop_front();
+        }
+
+        bool ok;
+        {
+            TraceScope trace("pwrite", "output", "bytes", write.length, "offset", write.offset);
+            ok = writeFully(buffers[write.buffer].data(), write.length, write.offset);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!ok) {
+            failed = true;
+        }
+        freeBuffers.push_back(write.buffer);
+        cv.notify_all();
+    }
+}
+
+bool AsyncPrimeWriter::writeFully(const char* data, std::size_t length, std::uint64_t offset) {
+    while (length > 0) {
+        ssize_t written = ::pwrite(fd, data, length, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        if (written == 0) {
+            return false;
+        }
+        data += written;
+        length -= static_cast<std::size_t>(written);
+        offset += static_cast<std::uint64_t>(written);
+    }
+    return true;
+}
+
+bool AsyncPrimeWriter::close() {
+    if (fd < 0) {
+        return false;
+    }
+
+    flushCurrent();
+
+    if (usingIoUring) {
+        while (inFlight > 0) {
+            if (!reapIoUring(true)) {
+                failed = true;
+                break;
+            }
+        }
+        stopIoUring();
+        usingIoUring = false;
+    } else {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            cv.notify_all();
+        }
+        writerThread.join();
+    }
+
+    if (::close(fd) != 0) {
+        failed = true;
+    }
+    fd = -1;
+    current = nullptr;
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    static MetricsRegistry& registry = MetricsRegistry::global();
+    static Counter& bytes = registry.counter("prime_sieve_output_bytes", "Bytes of prime listings written");
+    static Counter& primes = registry.counter("prime_sieve_output_primes", "Primes written to files");
+    static Counter& failures = registry.counter("prime_sieve_output_failures", "Prime listings that failed to write");
+    static Histogram& seconds = registry.histogram("prime_sieve_output_seconds", "Wall time of prime listing writes",
+                                                   Histogram::exponentialBounds(1e-3, 4.0, 10));
+    bytes.inc(stats.bytesWritten);
+    primes.inc(stats.primesWritten);
+    seconds.observe(stats.seconds);
+    if (failed) {
+        failures.inc();
+    }
+
+    return !failed;
+}
+
+#ifdef PRIME_SIEVE_HAVE_LIBURING
+
+bool AsyncPrimeWriter::ioUringAvailable() {
+    io_uring probe;
+    if (io_uring_queue_init(2, &probe, 0) < 0) {
+        return false;
+    }
+    io_uring_queue_exit(&probe);
+    return true;
+}
+
+bool AsyncPrimeWriter::startIoUring() {
+    auto* r = new io_uring;
+    if (io_uring_queue_init(static_cast<unsigned>(bufferCount), r, 0) < 0) {
+        delete r;
+        return false;
+    }
+    ring = r;
+    inFlight = 0;
+    inflightWrites.assign(bufferCount, PendingWrite{0, 0, 0, 0});
+    return true;
+}
+
+void AsyncPrimeWriter::submitIoUring(const PendingWrite& write) {
+    TraceScope trace("io_uring submit", "output", "bytes", write.length - write.done);
+    auto* r = static_cast<io_uring*>(ring);
+    io_uring_sqe* sqe = io_uring_get_sqe(r);
+    while (sqe == nullptr) {
+        // The queue depth equals the buffer count, so this only happens if
+        // completions have not been reaped yet
+        if (!reapIoUring(true)) {
+            failed = true;
+            freeBuffers.push_back(write.buffer);
+            return;
+        }
+        sqe = io_uring_get_sqe(r);
+    }
+
+    inflightWrites[write.buffer] = write;
+    io_uring_prep_write(sqe, fd, buffers[write.buffer].data() + write.done,
+                        static_cast<unsigned>(write.length - write.done),
+                        write.offset + write.done);
+    io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(static_cast<std::uintptr_t>(write.buffer)));
+    ++inFlight;
+    io_uring_submit(r);
+}
+
+bool AsyncPrimeWriter::reapIoUring(bool wait) {
+    auto* r = static_cast<io_uring*>(ring);
+    io_uring_cqe* cqe = nullptr;
+    int rc = wait ? io_uring_wait_cqe(r, &cqe) : io_uring_peek_cqe(r, &cqe);
+    if (rc < 0 || cqe == nullptr) {
+        return false;
+    }
+
+    auto buffer = static_cast<std::size_t>(reinterpret_cast<std::uintptr_t>(io_uring_cqe_get_data(cqe)));
+    int result = cqe->res;
+    io_uring_cqe_seen(r, cqe);
+    --inFlight;
+
+    PendingWrite& write = inflightWrites[buffer];
+    if (result == -EINTR || result == -EAGAIN) {
+        submitIoUring(write);
+        return true;
+    }
+    if (result <= 0) {
+        failed = true;
+        freeBuffers.push_back(buffer);
+        return true;
+    }
+
+    write.done += static_cast<std::size_t>(result);
+    if (write.done < write.length) {
+        // Short write: resubmit the remainder of the buffer
+        submitIoUring(write);
+        return true;
+    }
+
+    freeBuffers.push_back(buffer);
+    return true;
+}
+
+void AsyncPrimeWriter::stopIoUring() {
+    auto* r = static_cast<io_uring*>(ring);
+    io_uring_queue_exit(r);
+    delete r;
+    ring = nullptr;
+}
+
+#else
+
+bool AsyncPrimeWriter::ioUringAvailable() {
+    return false;
+}
+
+bool AsyncPrimeWriter::startIoUring() {
+    return false;
+}
+
+void AsyncPrimeWriter::submitIoUring(const PendingWrite&) {
+}
+
+bool AsyncPrimeWriter::reapIoUring(bool) {
+    return false;
+}
+
+void AsyncPrimeWriter::stopIoUring() {
+}
+
+#endif // PRIME_SIEVE_HAVE_LIBURING
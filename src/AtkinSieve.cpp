@@ -0,0 +1,283 @@
+#include "AtkinSieve.hpp"
+#include "PrimeTables.hpp"
+#include "TraceRecorder.hpp"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Floor of the square root of n.
+ */
+std::size_t isqrt(std::size_t n) {
+    std::size_t r = static_cast<std::size_t>(std::sqrt(static_cast<double>(n)));
+    while (r > 0 && r * r > n) --r;
+    while ((r + 1) * (r + 1) <= n) ++r;
+    return r;
+}
+
+/**
+ * @brief Ceiling of the square root of n.
+ */
+std::size_t ceilSqrt(std::size_t n) {
+    std::size_t r = isqrt(n);
+    return r * r == n ? r : r + 1;
+}
+
+} // namespace
+
+AtkinSieve::AtkinSieve(std::size_t n)
+    : limit(n), segmentSize(CacheTopology::host().segmentIndices()), generated(false) {
+    ScopedPhaseTimer timer(stats.allocationSeconds);
+
+    // Every number starts out composite; the quadratic forms toggle candidates on
+    bits.resize((limit + 1 + 63) / 64, 0);
+
+    // 2 and 3 are not produced by any of the forms
+    if (limit >= 2) bits[0] |= 1ULL << 2;
+    if (limit >= 3) bits[0] |= 1ULL << 3;
+}
+
+std::vector<std::size_t> AtkinSieve::findBasePrimes(std::size_t sqrtLimit) {
+    ScopedPhaseTimer timer(stats.basePrimesSeconds);
+    TraceScope trace("base primes", "sieve", "sqrt_limit", sqrtLimit);
+    std::vector<std::size_t> basePrimes;
+
+    if (sqrtLimit < PrimeTables::SMALL_LIMIT) {
+        // Take the primes from the compile-time table, skipping 2 and 3
+        std::size_t count = PrimeTables::countUpTo(sqrtLimit);
+        if (count > 2) {
+            basePrimes.assign(PrimeTables::PRIMES.begin() + 2, PrimeTables::PRIMES.begin() + count);
+        }
+    } else {
+        // Sieve of Eratosthenes up to sqrt(limit)
+        std::vector<bool> composite(sqrtLimit + 1, false);
+        for (std::size_t p = 5; p <= sqrtLimit; ++p) {
+            if (composite[p] || p % 2 == 0 || p % 3 == 0) continue;
+            basePrimes.push_back(p);
+            for (std::size_t i = p * p; i <= sqrtLimit; i += p) {
+                composite[i] = true;
+            }
+        }
+    }
+
+    stats.basePrimeCount = basePrimes.size();
+    return basePrimes;
+}
+
+std::size_t AtkinSieve::toggleQuadraticForms(std::size_t low, std::size_t high) {
+    std::size_t toggles = 0;
+    auto toggle = [&](std::size_t n) {
+        bits[n / 64] ^= 1ULL << (n % 64);
+        ++toggles;
+    };
+
+    // 4x^2 + y^2 = n with n mod 12 in {1, 5}: n is odd, so y is odd
+    for (std::size_t x = 1; 4 * x * x + 1 <= high; ++x) {
+        std::size_t base = 4 * x * x;
+        std::size_t y = base >= low ? 1 : ceilSqrt(low - base);
+        if (y % 2 == 0) ++y;
+        std::size_t yMax = isqrt(high - base);
+        for (; y <= yMax; y += 2) {
+            std::size_t n = base + y * y;
+            std::size_t r = n % 12;
+            if (r == 1 || r == 5) toggle(n);
+        }
+    }
+
+    // 3x^2 + y^2 = n with n mod 12 = 7: x is odd and y is even
+    for (std::size_t x = 1; 3 * x * x + 4 <= high; x += 2) {
+        std::size_t base = 3 * x * x;
+        std::size_t y = base >= low ? 2 : ceilSqrt(low - base);
+        if (y % 2 == 1) ++y;
+        std::size_t yMax = isqrt(high - base);
+        for (; y <= yMax; y += 2) {
+            std::size_t n = base + y * y;
+            if (n % 12 == 7) toggle(n);
+        }
+    }
+
+    // 3x^2 - y^2 = n with x > y and n mod 12 = 11: x and y have opposite parity.
+    // For a given x, n lies in [2x^2 + 2x - 1, 3x^2 - 1]
+    for (std::size_t x = std::max<std::size_t>(1, isqrt(low / 3)); 2 * x * x + 2 * x - 1 <= high; ++x) {
+        std::size_t base = 3 * x * x;
+        if (base <= low) continue;
+        std::size_t y = base > high ? ceilSqrt(base - high) : 1;
+        if ((x + y) % 2 == 0) ++y;
+        std::size_t yMax = std::min(x - 1, isqrt(base - low));
+        for (; y <= yMax; y += 2) {
+            std::size_t n = base - y * y;
+            if (n % 12 == 11) toggle(n);
+        }
+    }
+
+    return toggles;
+}
+
+void AtkinSieve::seedSquares(SievingPrimes& state, std::size_t low) {
+    for (std::size_t k = 0; k < state.size(); ++k) {
+        std::size_t square = state.primes[k] * state.primes[k];
+        state.multiples[k] = std::max(square, (low + square - 1) / square * square);
+    }
+}
+
+std::size_t AtkinSieve::eliminateSquares(std::size_t prime, std::size_t& multiple, std::size_t high) {
+    std::size_t square = prime * prime;
+    std::size_t count = 0;
+    std::size_t n = multiple;
+    for (; n <= high; n += square) {
+        bits[n / 64] &= ~(1ULL << (n % 64));
+        ++count;
+    }
+    multiple = n;
+    return count;
+}
+
+void AtkinSieve::generate() {
+    if (generated) return; // Already generated
+
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+    auto bounds = stats.tierBounds(basePrimes);
+    SievingPrimes state(basePrimes);
+    seedSquares(state, 0);
+
+    // Toggle the forms, then clear the non-square-free candidates, one segment at a time
+    for (std::size_t low = 0; low <= limit; low += segmentSize) {
+        std::size_t high = std::min(limit, low + segmentSize - 1);
+        {
+            ScopedPhaseTimer timer(stats.quadraticFormSeconds);
+            TraceScope trace("quadratic forms", "sieve", "low", low, "high", high);
+            stats.toggles += toggleQuadraticForms(low, high);
+        }
+        for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+            ScopedPhaseTimer timer(stats.crossOffSeconds[tier]);
+            for (std::size_t k = bounds[tier]; k < bounds[tier + 1]; ++k) {
+                stats.crossOffs[tier] += eliminateSquares(state.primes[k], state.multiples[k], high);
+            }
+        }
+        if (high == limit) break;
+    }
+
+    stats.publishMetrics(limit + 1);
+    generated = true;
+}
+
+template <typename Visitor>
+void AtkinSieve::forEachPrime(Visitor visit) const {
+    for (std::size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = bits[w];
+        while (word != 0) {
+            std::size_t n = w * 64 + static_cast<std::size_t>(__builtin_ctzll(word));
+            if (n > limit) return;
+            visit(n);
+            word &= word - 1;
+        }
+    }
+}
+
+std::vector<std::size_t> AtkinSieve::getPrimes() {
+    if (!generated) {
+        generate();
+    }
+
+    ScopedPhaseTimer timer(stats.extractionSeconds);
+    std::vector<std::size_t> primes;
+    primes.reserve(limit / 10); // Estimate: approximately 1/10 of numbers are prime
+    forEachPrime([&](std::size_t p) { primes.push_back(p); });
+    return primes;
+}
+
+bool AtkinSieve::isPrime(std::size_t num) {
+    if (num > limit) {
+        throw std::invalid_argument("Number exceeds sieve limit");
+    }
+
+    if (!generated && num < PrimeTables::SMALL_LIMIT) {
+        return PrimeTables::isSmallPrime(num);  // Answer small queries without sieving
+    }
+
+    if (!generated) {
+        generate();
+    }
+
+    return (bits[num / 64] >> (num % 64)) & 1;
+}
+
+std::size_t AtkinSieve::getPrimeCount() {
+    if (!generated) {
+        generate();
+    }
+
+    ScopedPhaseTimer timer(stats.extractionSeconds);
+    return countBits(0, limit);
+}
+
+std::size_t AtkinSieve::countBits(std::size_t low, std::size_t high) const {
+    if (low > high) {
+        return 0;
+    }
+
+    std::size_t first = low / 64;
+    std::size_t last = high / 64;
+    uint64_t lowMask = ~0ULL << (low % 64);
+    uint64_t highMask = ~0ULL >> (63 - high % 64);
+    if (first == last) {
+        return static_cast<std::size_t>(__builtin_popcountll(bits[first] & lowMask & highMask));
+    }
+
+    std::size_t count = static_cast<std::size_t>(__builtin_popcountll(bits[first] & lowMask));
+    for (std::size_t w = first + 1; w < last; ++w) {
+        count += static_cast<std::size_t>(__builtin_popcountll(bits[w]));
+    }
+    count += static_cast<std::size_t>(__builtin_popcountll(bits[last] & highMask));
+    return count;
+}
+
+std::size_t AtkinSieve::getMemoryUsage() const {
+    return bits.size() * sizeof(uint64_t);
+}
+
+void AtkinSieve::printPrimes(std::size_t perLine) const {
+    if (!generated) {
+        throw std::runtime_error("Sieve has not been generated yet");
+    }
+
+    ScopedPhaseTimer timer(stats.outputSeconds);
+    std::size_t count = 0;
+    forEachPrime([&](std::size_t p) {
+        std::cout << p;
+        if (++count % perLine == 0) {
+            std::cout << '\n';
+        } else {
+            std::cout << " ";
+        }
+    });
+
+    // Add newline if the last line wasn't complete
+    if (count % perLine != 0) {
+        std::cout << '\n';
+    }
+    std::cout.flush();
+}
+
+bool AtkinSieve::savePrimesToFile(const std::string& filename, OutputStats* outputStats) const {
+    if (!generated) {
+        throw std::runtime_error("Sieve has not been generated yet");
+    }
+
+    ScopedPhaseTimer timer(stats.outputSeconds);
+    AsyncPrimeWriter writer;
+    if (!writer.open(filename)) {
+        return false;
+    }
+
+    forEachPrime([&](std::size_t p) { writer.write(p); });
+
+    bool ok = writer.close();
+    if (outputStats) {
+        *outputStats = writer.getStats();
+    }
+    return ok;
+}
@@ -1,10 +1,13 @@
 #include "BasicSieve.hpp"
+#include "PrimeTables.hpp"
+#include "TraceRecorder.hpp"
 #include <iostream>
-#include <fstream>
 #include <cmath>
 #include <algorithm>
 
 BasicSieve::BasicSieve(std::size_t n) : limit(n), generated(false) {
+    ScopedPhaseTimer timer(stats.allocationSeconds);
+
     // Initialize sieve vector with all values set to true
     sieve.resize(limit + 1, true);
     
@@ -13,21 +16,61 @@ BasicSieve::BasicSieve(std::size_t n) : limit(n), generated(false) {
     if (limit >= 1) sieve[1] = false;
 }
 
+std::vector<std::size_t> BasicSieve::findBasePrimes(std::size_t sqrtLimit) {
+    ScopedPhaseTimer timer(stats.basePrimesSeconds);
+    TraceScope trace("base primes", "sieve", "sqrt_limit", sqrtLimit);
+    std::vector<std::size_t> basePrimes;
+    
+    if (sqrtLimit < PrimeTables::SMALL_LIMIT) {
+        // Copy [2, sqrtLimit] from the compile-time table instead of sieving it
+        for (std::size_t n = 2; n <= sqrtLimit; ++n) {
+            sieve[n] = PrimeTables::isSmallPrime(n);
+        }
+        basePrimes.assign(PrimeTables::PRIMES.begin(),
+                          PrimeTables::PRIMES.begin() + PrimeTables::countUpTo(sqrtLimit));
+        stats.basePrimeCount = basePrimes.size();
+        return basePrimes;
+    }
+    
+    // Sieve of Eratosthenes up to sqrt(limit)
+    for (std::size_t p = 2; p <= sqrtLimit; ++p) {
+        if (sieve[p]) {
+            basePrimes.push_back(p);
+            for (std::size_t i = p * p; i <= sqrtLimit; i += p) {
+                sieve[i] = false;
+            }
+        }
+    }
+    
+    stats.basePrimeCount = basePrimes.size();
+    return basePrimes;
+}
+
 void BasicSieve::generate() {
     if (generated) return; // Already generated
     
-    // Sieve of Eratosthenes algorithm
-    for (std::size_t p = 2; p * p <= limit; ++p) {
-        // If sieve[p] is true, then p is a prime
-        if (sieve[p]) {
-            // Mark all multiples of p as non-prime
-            // Start from p*p as smaller multiples have already been marked
-            for (std::size_t i = p * p; i <= limit; i += p) {
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+    
+    // Cross off the multiples above sqrt(limit), one prime tier at a time
+    auto bounds = stats.tierBounds(basePrimes);
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        ScopedPhaseTimer timer(stats.crossOffSeconds[tier]);
+        TraceScope trace(SieveStats::tierName(tier), "sieve");
+        std::size_t crossOffs = 0;
+        for (std::size_t k = bounds[tier]; k < bounds[tier + 1]; ++k) {
+            std::size_t p = basePrimes[k];
+            // Start from p*p, or the first multiple the base sieve did not reach
+            std::size_t start = std::max(p * p, (sqrtLimit / p + 1) * p);
+            for (std::size_t i = start; i <= limit; i += p) {
                 sieve[i] = false;
             }
+            crossOffs += SieveStats::multiplesInRange(start, limit, p);
         }
+        stats.crossOffs[tier] = crossOffs;
     }
     
+    stats.publishMetrics(limit + 1);
     generated = true;
 }
 
@@ -36,6 +79,7 @@ std::vector<std::size_t> BasicSieve::getPrimes() {
         generate();
     }
     
+    ScopedPhaseTimer timer(stats.extractionSeconds);
     std::vector<std::size_t> primes;
     primes.reserve(limit / 10); // Estimate: approximately 1/10 of numbers are prime
     
@@ -53,6 +97,10 @@ bool BasicSieve::isPrime(std::size_t num) {
         throw std::invalid_argument("Number exceeds sieve limit");
     }
     
+    if (!generated && num < PrimeTables::SMALL_LIMIT) {
+        return PrimeTables::isSmallPrime(num);  // Answer small queries without sieving
+    }
+    
     if (!generated) {
         generate();
     }
@@ -65,6 +113,7 @@ std::size_t BasicSieve::getPrimeCount() {
         generate();
     }
     
+    ScopedPhaseTimer timer(stats.extractionSeconds);
     std::size_t count = 0;
     for (std::size_t i = 2; i <= limit; ++i) {
         if (sieve[i]) {
@@ -75,17 +124,22 @@ std::size_t BasicSieve::getPrimeCount() {
     return count;
 }
 
+std::size_t BasicSieve::getMemoryUsage() const {
+    return (sieve.size() + 7) / 8;  // std::vector<bool> packs one entry per bit
+}
+
 void BasicSieve::printPrimes(std::size_t perLine) const {
     if (!generated) {
         throw std::runtime_error("Sieve has not been generated yet");
     }
     
+    ScopedPhaseTimer timer(stats.outputSeconds);
     std::size_t count = 0;
     for (std::size_t i = 2; i <= limit; ++i) {
         if (sieve[i]) {
             std::cout << i;
             if (++count % perLine == 0) {
-                std::cout << std::endl;
+                std::cout << '\n';
             } else {
                 std::cout << " ";
             }
@@ -94,26 +148,31 @@ void BasicSieve::printPrimes(std::size_t perLine) const {
     
     // Add newline if the last line wasn't complete
     if (count % perLine != 0) {
-        std::cout << std::endl;
+        std::cout << '\n';
     }
+    std::cout.flush();
 }
 
-bool BasicSieve::savePrimesToFile(const std::string& filename) const {
+bool BasicSieve::savePrimesToFile(const std::string& filename, OutputStats* outputStats) const {
     if (!generated) {
         throw std::runtime_error("Sieve has not been generated yet");
     }
     
-    std::ofstream outFile(filename);
-    if (!outFile) {
+    ScopedPhaseTimer timer(stats.outputSeconds);
+    AsyncPrimeWriter writer;
+    if (!writer.open(filename)) {
         return false;
     }
     
     for (std::size_t i = 2; i <= limit; ++i) {
         if (sieve[i]) {
-            outFile << i << "\n";
+            writer.write(i);
         }
     }
     
-    outFile.close();
-    return true;
+    bool ok = writer.close();
+    if (outputStats) {
+        *outputStats = writer.getStats();
+    }
+    return ok;
 }
\ No newline at end of file
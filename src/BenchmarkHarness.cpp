@@ -0,0 +1,574 @@
+#include "BenchmarkHarness.hpp"
+#include "CpuTopology.hpp"
+#include <omp.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#ifndef PRIME_SIEVE_GIT_REVISION
+#define PRIME_SIEVE_GIT_REVISION "unknown"
+#endif
+
+namespace {
+
+double medianOfSorted(const std::vector<double>& sorted) {
+    std::size_t n = sorted.size();
+    if (n == 0) return 0.0;
+    return n % 2 == 1 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+}
+
+/**
+ * @brief Two-sided standard normal quantile for the given coverage.
+ */
+double normalQuantile(double confidence) {
+    double lo = 0.0;
+    double hi = 10.0;
+    for (int i = 0; i < 100; ++i) {
+        double mid = (lo + hi) / 2.0;
+        if (std::erf(mid / std::sqrt(2.0)) < confidence) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo + hi) / 2.0;
+}
+
+std::string readFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    if (in) {
+        std::getline(in, line);
+    }
+    return line;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += ' ';
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+std::string csvEscape(const std::string& text) {
+    if (text.find_first_of(",\"\n") == std::string::npos) {
+        return text;
+    }
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"') out += '"';
+        out += c;
+    }
+    return out + "\"";
+}
+
+const char* scalingModeName(ScalingMode mode) {
+    switch (mode) {
+        case ScalingMode::Strong: return "strong";
+        case ScalingMode::Weak: return "weak";
+        case ScalingMode::Size: return "size";
+        default: return "none";
+    }
+}
+
+void writeSummaryJson(std::ostream& os, const SampleSummary& s) {
+    os << "{\"n\": " << s.count
+       << ", \"median_ms\": " << s.median
+       << ", \"mad_ms\": " << s.mad
+       << ", \"mean_ms\": " << s.mean
+       << ", \"stddev_ms\": " << s.stddev
+       << ", \"min_ms\": " << s.min
+       << ", \"max_ms\": " << s.max
+       << ", \"ci_low_ms\": " << s.ciLow
+       << ", \"ci_high_ms\": " << s.ciHigh << "}";
+}
+
+} // namespace
+
+SampleSummary SampleSummary::fromSamples(std::vector<double> samples, double confidence) {
+    SampleSummary summary;
+    summary.count = samples.size();
+    if (samples.empty()) {
+        return summary;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    summary.min = samples.front();
+    summary.max = samples.back();
+    summary.median = medianOfSorted(samples);
+
+    double sum = 0.0;
+    for (double x : samples) sum += x;
+    summary.mean = sum / static_cast<double>(samples.size());
+
+    double squares = 0.0;
+    for (double x : samples) squares += (x - summary.mean) * (x - summary.mean);
+    summary.stddev = samples.size() > 1 ? std::sqrt(squares / static_cast<double>(samples.size() - 1)) : 0.0;
+
+    std::vector<double> deviations;
+    deviations.reserve(samples.size());
+    for (double x : samples) deviations.push_back(std::fabs(x - summary.median));
+    std::sort(deviations.begin(), deviations.end());
+    summary.mad = medianOfSorted(deviations);
+
+    // Order-statistic ranks (1-based) bracketing the median
+    double n = static_cast<double>(samples.size());
+    double z = normalQuantile(confidence);
+    double halfWidth = z * std::sqrt(n) / 2.0;
+    long lowRank = static_cast<long>(std::floor(n / 2.0 - halfWidth));
+    long highRank = static_cast<long>(std::ceil(1.0 + n / 2.0 + halfWidth));
+    lowRank = std::max(1L, std::min(lowRank, static_cast<long>(samples.size())));
+    highRank = std::max(1L, std::min(highRank, static_cast<long>(samples.size())));
+    summary.ciLow = samples[static_cast<std::size_t>(lowRank - 1)];
+    summary.ciHigh = samples[static_cast<std::size_t>(highRank - 1)];
+
+    return summary;
+}
+
+void EngineResult::summarize(double confidence) {
+    std::vector<double> c, g, e, t;
+    for (const auto& sample : samples) {
+        c.push_back(sample.construct);
+        g.push_back(sample.generate);
+        e.push_back(sample.extract);
+        t.push_back(sample.total());
+    }
+    construct = SampleSummary::fromSamples(c, confidence);
+    generate = SampleSummary::fromSamples(g, confidence);
+    extract = SampleSummary::fromSamples(e, confidence);
+    total = SampleSummary::fromSamples(t, confidence);
+}
+
+HostInfo HostInfo::detect() {
+    HostInfo info;
+
+    char name[256] = {};
+    if (gethostname(name, sizeof(name) - 1) == 0) {
+        info.hostname = name;
+    }
+
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            auto colon = line.find(':');
+            if (colon != std::string::npos) {
+                info.cpuModel = line.substr(colon + 2);
+            }
+            break;
+        }
+    }
+
+#if defined(__clang__)
+    info.compiler = std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    info.compiler = std::string("gcc ") + __VERSION__;
+#else
+    info.compiler = "unknown";
+#endif
+    info.revision = PRIME_SIEVE_GIT_REVISION;
+
+    info.governor = readFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    std::string noTurbo = readFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+    std::string boost = readFirstLine("/sys/devices/system/cpu/cpufreq/boost");
+    if (!noTurbo.empty()) {
+        info.boost = noTurbo == "1" ? "disabled" : "enabled";
+    } else if (!boost.empty()) {
+        info.boost = boost == "1" ? "enabled" : "disabled";
+    }
+
+    info.logicalCores = static_cast<int>(std::thread::hardware_concurrency());
+    info.physicalCores = CpuTopology::host().physicalCores();
+    info.maxThreads = omp_get_max_threads();
+
+    std::time_t now = std::time(nullptr);
+    char stamp[32] = {};
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    info.timestamp = stamp;
+
+    return info;
+}
+
+std::string HostInfo::hostClass() const {
+    std::string slug;
+    for (char c : cpuModel.empty() ? std::string("unknown-cpu") : cpuModel) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            slug += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        } else if (!slug.empty() && slug.back() != '-') {
+            slug += '-';
+        }
+    }
+    if (!slug.empty() && slug.back() == '-') {
+        slug.pop_back();
+    }
+    return slug + "-" + std::to_string(logicalCores) + "cpu";
+}
+
+std::vector<ScalingPoint> BenchmarkHarness::computeScaling() const {
+    std::vector<ScalingPoint> points;
+
+    auto findResult = [this](const std::string& engine, const std::string& variant,
+                             std::size_t limit, int threads) -> const EngineResult* {
+        for (const auto& r : results) {
+            if (r.engine == engine && r.variant == variant &&
+                (limit == 0 || r.limit == limit) && (threads == 0 || r.threads == threads)) {
+                return &r;
+            }
+        }
+        return nullptr;
+    };
+
+    for (const auto& r : results) {
+        ScalingPoint point;
+        point.engine = r.engine;
+        point.variant = r.variant;
+        point.limit = r.limit;
+        point.threads = r.threads;
+        point.totalMs = r.total.median;
+        point.generateMs = r.generate.median;
+        double integers = static_cast<double>(r.limit) + 1.0;
+        point.nsPerInteger = r.total.median * 1e6 / integers;
+        point.generateNsPerInteger = r.generate.median * 1e6 / integers;
+
+        // Every variant but "sequential" is parallel ("parallel", or a pinned placement)
+        const EngineResult* baseline = nullptr;
+        if (r.variant != "sequential") {
+            switch (config.scaling) {
+                case ScalingMode::Strong:
+                    baseline = findResult(r.engine, r.variant, r.limit, 1);
+                    if (baseline == nullptr) baseline = findResult(r.engine, "sequential", r.limit, 0);
+                    break;
+                case ScalingMode::Weak:
+                    baseline = findResult(r.engine, r.variant, 0, 1);
+                    break;
+                case ScalingMode::Size:
+                case ScalingMode::None:
+                    baseline = findResult(r.engine, "sequential", r.limit, 0);
+                    break;
+            }
+        }
+
+        if (baseline != nullptr && r.total.median > 0.0) {
+            double p = static_cast<double>(r.threads);
+            double ratio = baseline->total.median / r.total.median;
+            // Weak scaling: each thread does the baseline amount of work
+            point.speedup = config.scaling == ScalingMode::Weak ? ratio * p : ratio;
+            point.efficiency = point.speedup / p;
+            if (r.threads > 1 && point.speedup > 0.0) {
+                point.karpFlatt = (1.0 / point.speedup - 1.0 / p) / (1.0 - 1.0 / p);
+            }
+        }
+
+        points.push_back(point);
+    }
+
+    return points;
+}
+
+void BenchmarkHarness::validateResult(EngineResult& result, const std::vector<std::size_t>& counts) {
+    std::string message;
+    for (std::size_t rep = 0; rep < counts.size(); ++rep) {
+        if (!PrimeOracle::checkCount(result.limit, counts[rep], message)) {
+            result.validation = message + " (repetition " + std::to_string(rep + 1) + ")";
+            result.validationFailed = true;
+            return;
+        }
+    }
+    if (result.digest.count != counts.back()) {
+        result.validation = "getPrimes() returned " + std::to_string(result.digest.count) +
+                            " primes but getPrimeCount() returned " + std::to_string(counts.back());
+        result.validationFailed = true;
+        return;
+    }
+
+    auto it = referenceResults.find(result.limit);
+    if (it != referenceResults.end()) {
+        const EngineResult& reference = results[it->second];
+        if (result.digest != reference.digest) {
+            result.validation = "prime set " + result.digest.toString() + " differs from " +
+                                reference.engine + " (" + reference.variant + "): " +
+                                reference.digest.toString();
+            result.validationFailed = true;
+            return;
+        }
+        result.validation = message + "; prime set matches " + reference.engine + " (" +
+                            reference.variant + ")";
+        return;
+    }
+    result.validation = message + "; reference prime set " + result.digest.toString();
+}
+
+bool BenchmarkHarness::hasValidationFailures() const {
+    for (const auto& r : results) {
+        if (r.validationFailed) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BenchmarkHarness::writeValidationReport(std::ostream& os) const {
+    os << "\nValidation:\n";
+    for (const auto& r : results) {
+        os << "  " << (r.validationFailed ? "FAIL " : "ok   ") << r.engine << " (" << r.variant
+           << ", " << r.threads << " threads, limit " << r.limit << "): " << r.validation << "\n";
+    }
+}
+
+void BenchmarkHarness::printFrequencyGuidance(std::ostream& os) const {
+    bool governorOk = host.governor.empty() || host.governor == "performance";
+    bool boostOk = host.boost != "enabled";
+    if (governorOk && boostOk) {
+        return;
+    }
+
+    os << "Note: CPU frequency is not pinned; timings may drift between runs.\n";
+    if (!governorOk) {
+        os << "  Scaling governor is '" << host.governor << "'. For stable results run:\n"
+           << "    sudo cpupower frequency-set -g performance\n";
+    }
+    if (!boostOk) {
+        os << "  Turbo/boost is enabled. Disable it for the benchmark with one of:\n"
+           << "    echo 1 | sudo tee /sys/devices/system/cpu/intel_pstate/no_turbo\n"
+           << "    echo 0 | sudo tee /sys/devices/system/cpu/cpufreq/boost\n";
+    }
+    os << "  Pinning the process (e.g. taskset -c 0-3) further reduces variance.\n\n";
+}
+
+void BenchmarkHarness::writeTable(std::ostream& os) const {
+    os << "Host: " << host.cpuModel << " (" << host.logicalCores << " logical cores), revision "
+       << host.revision << "\n";
+    os << config.repetitions << " repetitions after " << config.warmup << " warmup runs; "
+       << "median [" << static_cast<int>(config.confidence * 100) << "% CI] in ms\n\n";
+
+    os << std::left << std::setfill(' ')
+       << std::setw(16) << "Algorithm"
+       << std::setw(12) << "Variant"
+       << std::setw(9) << "Threads"
+       << std::setw(12) << "Construct"
+       << std::setw(12) << "Generate"
+       << std::setw(12) << "Extract"
+       << std::setw(12) << "Total"
+       << std::setw(10) << "MAD"
+       << std::setw(24) << "CI"
+       << std::setw(16) << "Memory (bytes)"
+       << std::setw(16) << "Peak heap" << "\n";
+    os << std::string(151, '-') << "\n";
+
+    for (const auto& r : results) {
+        std::ostringstream ci;
+        ci << std::fixed << std::setprecision(2) << "[" << r.total.ciLow << ", " << r.total.ciHigh << "]";
+        os << std::left << std::setw(16) << r.engine
+           << std::setw(12) << r.variant
+           << std::setw(9) << r.threads
+           << std::fixed << std::setprecision(2)
+           << std::setw(12) << r.construct.median
+           << std::setw(12) << r.generate.median
+           << std::setw(12) << r.extract.median
+           << std::setw(12) << r.total.median
+           << std::setw(10) << r.total.mad
+           << std::setw(24) << ci.str()
+           << std::setw(16) << r.memoryBytes
+           << std::setw(16) << r.peakHeapBytes << "\n";
+    }
+    os << "Process peak RSS (getrusage): " << MemoryTracker::maxResidentBytes() << " bytes";
+    if (!MemoryTracker::isInstalled()) {
+        os << " (peak heap unavailable: allocator hook not linked)";
+    }
+    os << "\n";
+
+    // Speedup of each parallel engine over its sequential counterpart
+    std::map<std::string, const EngineResult*> sequential;
+    for (const auto& r : results) {
+        if (r.variant == "sequential") sequential[r.engine + "/" + std::to_string(r.limit)] = &r;
+    }
+    bool header = false;
+    for (const auto& r : results) {
+        if (r.variant == "sequential") continue;
+        auto it = sequential.find(r.engine + "/" + std::to_string(r.limit));
+        if (it == sequential.end() || r.total.median <= 0.0 || r.generate.median <= 0.0) continue;
+        if (!header) {
+            os << "\nSpeedup (sequential median / parallel median):\n";
+            header = true;
+        }
+        os << "  " << std::left << std::setw(16) << r.engine
+           << "total " << std::fixed << std::setprecision(2) << it->second->total.median / r.total.median
+           << "x, generate " << it->second->generate.median / r.generate.median
+           << "x with " << r.threads << " threads";
+        if (r.variant != "parallel") os << " (" << r.variant << ")";
+        os << "\n";
+    }
+
+    if (config.perfCounters) {
+        for (const auto& r : results) {
+            os << "\n" << r.engine << " (" << r.variant << ", " << r.threads << " threads, limit "
+               << r.limit << ")\n" << r.perfText;
+        }
+    }
+
+    if (config.scaling == ScalingMode::None) {
+        return;
+    }
+
+    os << "\nScaling (" << scalingModeName(config.scaling) << "):\n";
+    os << std::left
+       << std::setw(16) << "Algorithm"
+       << std::setw(12) << "Variant"
+       << std::setw(14) << "Limit"
+       << std::setw(9) << "Threads"
+       << std::setw(10) << "Speedup"
+       << std::setw(12) << "Efficiency"
+       << std::setw(12) << "Karp-Flatt"
+       << std::setw(10) << "ns/int"
+       << std::setw(12) << "gen ns/int" << "\n";
+    os << std::string(107, '-') << "\n";
+    for (const auto& point : computeScaling()) {
+        os << std::left << std::setw(16) << point.engine
+           << std::setw(12) << point.variant
+           << std::setw(14) << point.limit
+           << std::setw(9) << point.threads
+           << std::fixed << std::setprecision(2)
+           << std::setw(10) << point.speedup
+           << std::setw(12) << point.efficiency
+           << std::setprecision(3)
+           << std::setw(12) << point.karpFlatt
+           << std::setw(10) << point.nsPerInteger
+           << std::setw(12) << point.generateNsPerInteger << "\n";
+    }
+}
+
+void BenchmarkHarness::writeJson(std::ostream& os) const {
+    os << std::setprecision(6) << std::fixed;
+    os << "{\n";
+    os << "  \"schema\": 1,\n";
+    os << "  \"label\": \"" << jsonEscape(config.label) << "\",\n";
+    os << "  \"host\": {"
+       << "\"hostname\": \"" << jsonEscape(host.hostname) << "\", "
+       << "\"cpu_model\": \"" << jsonEscape(host.cpuModel) << "\", "
+       << "\"host_class\": \"" << jsonEscape(host.hostClass()) << "\", "
+       << "\"logical_cores\": " << host.logicalCores << ", "
+       << "\"physical_cores\": " << host.physicalCores << ", "
+       << "\"max_threads\": " << host.maxThreads << ", "
+       << "\"governor\": \"" << jsonEscape(host.governor) << "\", "
+       << "\"boost\": \"" << jsonEscape(host.boost) << "\", "
+       << "\"compiler\": \"" << jsonEscape(host.compiler) << "\", "
+       << "\"revision\": \"" << jsonEscape(host.revision) << "\", "
+       << "\"timestamp\": \"" << jsonEscape(host.timestamp) << "\"},\n";
+    os << "  \"config\": {"
+       << "\"warmup\": " << config.warmup << ", "
+       << "\"repetitions\": " << config.repetitions << ", "
+       << "\"confidence\": " << config.confidence << ", "
+       << "\"extract\": \"" << (config.extractList ? "list" : "count") << "\", "
+       << "\"scaling\": \"" << scalingModeName(config.scaling) << "\"},\n";
+    os << "  \"results\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << (i == 0 ? "\n" : ",\n");
+        os << "    {\"engine\": \"" << jsonEscape(r.engine) << "\", "
+           << "\"variant\": \"" << r.variant << "\", "
+           << "\"limit\": " << r.limit << ", "
+           << "\"threads\": " << r.threads << ", "
+           << "\"memory_bytes\": " << r.memoryBytes << ", "
+           << "\"peak_heap_bytes\": " << r.peakHeapBytes << ", "
+           << "\"prime_count\": " << r.primeCount << ",\n";
+        os << "     \"phases\": {\"construct\": ";
+        writeSummaryJson(os, r.construct);
+        os << ",\n                \"generate\": ";
+        writeSummaryJson(os, r.generate);
+        os << ",\n                \"extract\": ";
+        writeSummaryJson(os, r.extract);
+        os << ",\n                \"total\": ";
+        writeSummaryJson(os, r.total);
+        os << "},\n     \"samples_ms\": [";
+        for (std::size_t s = 0; s < r.samples.size(); ++s) {
+            const auto& sample = r.samples[s];
+            os << (s == 0 ? "" : ", ") << "[" << sample.construct << ", " << sample.generate
+               << ", " << sample.extract << "]";
+        }
+        os << "]";
+        if (config.perfCounters) {
+            os << ",\n     \"perf_counters\": " << r.perfJson;
+        }
+        if (config.validate) {
+            os << ",\n     \"validation\": {\"passed\": " << (r.validationFailed ? "false" : "true")
+               << ", \"message\": \"" << jsonEscape(r.validation) << "\", "
+               << "\"digest\": \"" << jsonEscape(r.digest.toString()) << "\"}";
+        }
+        os << "}";
+    }
+    os << "\n  ]";
+
+    if (config.scaling != ScalingMode::None) {
+        auto points = computeScaling();
+        os << ",\n  \"scaling\": [";
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            const auto& point = points[i];
+            os << (i == 0 ? "\n" : ",\n");
+            os << "    {\"engine\": \"" << jsonEscape(point.engine) << "\", "
+               << "\"variant\": \"" << point.variant << "\", "
+               << "\"limit\": " << point.limit << ", "
+               << "\"threads\": " << point.threads << ", "
+               << "\"total_ms\": " << point.totalMs << ", "
+               << "\"generate_ms\": " << point.generateMs << ", "
+               << "\"speedup\": " << point.speedup << ", "
+               << "\"efficiency\": " << point.efficiency << ", "
+               << "\"karp_flatt\": " << point.karpFlatt << ", "
+               << "\"ns_per_integer\": " << point.nsPerInteger << ", "
+               << "\"generate_ns_per_integer\": " << point.generateNsPerInteger << "}";
+        }
+        os << "\n  ]";
+    }
+    os << "\n}\n";
+}
+
+void BenchmarkHarness::writeCsv(std::ostream& os) const {
+    os << "label,revision,engine,variant,limit,threads,memory_bytes,peak_heap_bytes,prime_count,phase,"
+          "n,median_ms,mad_ms,mean_ms,stddev_ms,min_ms,max_ms,ci_low_ms,ci_high_ms\n";
+    os << std::setprecision(6) << std::fixed;
+    for (const auto& r : results) {
+        const std::pair<const char*, const SampleSummary*> phases[] = {
+            {"construct", &r.construct}, {"generate", &r.generate},
+            {"extract", &r.extract}, {"total", &r.total}};
+        for (const auto& phase : phases) {
+            const SampleSummary& s = *phase.second;
+            os << csvEscape(config.label) << "," << csvEscape(host.revision) << ","
+               << r.engine << "," << r.variant << "," << r.limit << "," << r.threads << ","
+               << r.memoryBytes << "," << r.peakHeapBytes << "," << r.primeCount << "," << phase.first << ","
+               << s.count << "," << s.median << "," << s.mad << "," << s.mean << ","
+               << s.stddev << "," << s.min << "," << s.max << "," << s.ciLow << ","
+               << s.ciHigh << "\n";
+        }
+    }
+}
+
+void BenchmarkHarness::writeScalingCsv(std::ostream& os) const {
+    os << "label,revision,mode,engine,variant,limit,threads,total_ms,generate_ms,speedup,"
+          "efficiency,karp_flatt,ns_per_integer,generate_ns_per_integer\n";
+    os << std::setprecision(6) << std::fixed;
+    for (const auto& point : computeScaling()) {
+        os << csvEscape(config.label) << "," << csvEscape(host.revision) << ","
+           << scalingModeName(config.scaling) << "," << point.engine << "," << point.variant << ","
+           << point.limit << "," << point.threads << "," << point.totalMs << ","
+           << point.generateMs << "," << point.speedup << "," << point.efficiency << ","
+           << point.karpFlatt << "," << point.nsPerInteger << "," << point.generateNsPerInteger << "\n";
+    }
+}
@@ -1,10 +1,15 @@
 #include "BitSieve.hpp"
+#include "PrimeTables.hpp"
+#include "TieredCrossOff.hpp"
+#include "TraceRecorder.hpp"
 #include <iostream>
-#include <fstream>
 #include <cmath>
 #include <algorithm>
+#include <chrono>
 
 BitSieve::BitSieve(std::size_t n) : limit(n), generated(false) {
+    ScopedPhaseTimer timer(stats.allocationSeconds);
+
     // Calculate the number of uint64_t values needed
     bitCount = limit + 1;
     std::size_t arraySize = (bitCount + 63) / 64;  // Each uint64_t holds 64 bits
@@ -17,22 +22,76 @@ BitSieve::BitSieve(std::size_t n) : limit(n), generated(false) {
     if (limit >= 1) clearBit(1);
 }
 
-void BitSieve::generate() {
-    if (generated) return; // Already generated
+std::vector<std::size_t> BitSieve::findBasePrimes(std::size_t sqrtLimit) {
+    ScopedPhaseTimer timer(stats.basePrimesSeconds);
+    TraceScope trace("base primes", "sieve", "sqrt_limit", sqrtLimit);
+    std::vector<std::size_t> basePrimes;
+    
+    if (sqrtLimit < PrimeTables::SMALL_LIMIT) {
+        // Copy the words covering [0, sqrtLimit] from the compile-time bitmap
+        for (std::size_t w = 0; w <= sqrtLimit / 64; ++w) {
+            uint64_t mask = w < sqrtLimit / 64 ? ~0ULL : ~0ULL >> (63 - sqrtLimit % 64);
+            bits[w] = (bits[w] & ~mask) | (PrimeTables::BITMAP[w] & mask);
+        }
+        basePrimes.assign(PrimeTables::PRIMES.begin(),
+                          PrimeTables::PRIMES.begin() + PrimeTables::countUpTo(sqrtLimit));
+        stats.basePrimeCount = basePrimes.size();
+        return basePrimes;
+    }
     
-    // Sieve of Eratosthenes algorithm using bit manipulation
-    for (std::size_t p = 2; p * p <= limit; ++p) {
-        // If p is prime (bit is set)
+    // Sieve of Eratosthenes up to sqrt(limit)
+    for (std::size_t p = 2; p <= sqrtLimit; ++p) {
         if (getBit(p)) {
-            // Mark all multiples of p as non-prime
-            // Start from p*p as smaller multiples have already been marked
-            for (std::size_t i = p * p; i <= limit; i += p) {
+            basePrimes.push_back(p);
+            for (std::size_t i = p * p; i <= sqrtLimit; i += p) {
                 clearBit(i);
             }
         }
     }
     
+    stats.basePrimeCount = basePrimes.size();
+    return basePrimes;
+}
+
+BitSieve::~BitSieve() = default;
+
+void BitSieve::generate() {
+    if (generated) return; // Already generated
+    generateStep(StepBudget{});
+}
+
+bool BitSieve::generateStep(const StepBudget& budget) {
+    if (generated) return true;
+    auto start = std::chrono::steady_clock::now();
+    
+    if (!stepper) {
+        std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+        std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+        
+        // Cross off the multiples above sqrt(limit) one segment at a time, each prime tier with its own loop
+        stepper = std::make_unique<TieredCrossOff>(basePrimes, stats);
+        stepper->startRange(sqrtLimit + 1, limit);
+        frontier = std::min(sqrtLimit, limit);
+    }
+    
+    std::size_t segments = 0;
+    while (stepper->sieveNextSegment(bits, frontier)) {
+        if (budget.segments > 0 && ++segments >= budget.segments) break;
+        if (budget.time.count() > 0 && std::chrono::steady_clock::now() - start >= budget.time) break;
+    }
+    if (!stepper->isRangeDone()) {
+        return false;
+    }
+    
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        stats.crossOffSeconds[tier] += stepper->getSeconds()[tier];
+        stats.crossOffs[tier] = stepper->getCrossOffs()[tier];
+    }
+    stepper.reset();
+    
+    stats.publishMetrics(limit + 1);
     generated = true;
+    return true;
 }
 
 std::vector<std::size_t> BitSieve::getPrimes() {
@@ -40,6 +99,7 @@ std::vector<std::size_t> BitSieve::getPrimes() {
         generate();
     }
     
+    ScopedPhaseTimer timer(stats.extractionSeconds);
     std::vector<std::size_t> primes;
     primes.reserve(limit / 10); // Estimate: approximately 1/10 of numbers are prime
     
@@ -57,6 +117,14 @@ bool BitSieve::isPrime(std::size_t num) {
         throw std::invalid_argument("Number exceeds sieve limit");
     }
     
+    if (!generated && num < PrimeTables::SMALL_LIMIT) {
+        return PrimeTables::isSmallPrime(num);  // Answer small queries without sieving
+    }
+    
+    if (!generated && num <= frontier) {
+        return getBit(num);  // Already final below the generateStep() frontier
+    }
+    
     if (!generated) {
         generate();
     }
@@ -69,13 +137,28 @@ std::size_t BitSieve::getPrimeCount() {
         generate();
     }
     
-    std::size_t count = 0;
-    for (std::size_t i = 2; i <= limit; ++i) {
-        if (getBit(i)) {
-            ++count;
-        }
+    ScopedPhaseTimer timer(stats.extractionSeconds);
+    return countBits(0, limit);  // Bits 0 and 1 are always clear
+}
+
+std::size_t BitSieve::countBits(std::size_t low, std::size_t high) const {
+    if (low > high) {
+        return 0;
     }
     
+    std::size_t first = low / 64;
+    std::size_t last = high / 64;
+    uint64_t lowMask = ~0ULL << (low % 64);
+    uint64_t highMask = ~0ULL >> (63 - high % 64);
+    if (first == last) {
+        return static_cast<std::size_t>(__builtin_popcountll(bits[first] & lowMask & highMask));
+    }
+    
+    std::size_t count = static_cast<std::size_t>(__builtin_popcountll(bits[first] & lowMask));
+    for (std::size_t w = first + 1; w < last; ++w) {
+        count += static_cast<std::size_t>(__builtin_popcountll(bits[w]));
+    }
+    count += static_cast<std::size_t>(__builtin_popcountll(bits[last] & highMask));
     return count;
 }
 
@@ -88,12 +171,13 @@ void BitSieve::printPrimes(std::size_t perLine) const {
         throw std::runtime_error("Sieve has not been generated yet");
     }
     
+    ScopedPhaseTimer timer(stats.outputSeconds);
     std::size_t count = 0;
     for (std::size_t i = 2; i <= limit; ++i) {
         if (getBit(i)) {
             std::cout << i;
             if (++count % perLine == 0) {
-                std::cout << std::endl;
+                std::cout << '\n';
             } else {
                 std::cout << " ";
             }
@@ -102,26 +186,31 @@ void BitSieve::printPrimes(std::size_t perLine) const {
     
     // Add newline if the last line wasn't complete
     if (count % perLine != 0) {
-        std::cout << std::endl;
+        std::cout << '\n';
     }
+    std::cout.flush();
 }
 
-bool BitSieve::savePrimesToFile(const std::string& filename) const {
+bool BitSieve::savePrimesToFile(const std::string& filename, OutputStats* outputStats) const {
     if (!generated) {
         throw std::runtime_error("Sieve has not been generated yet");
     }
     
-    std::ofstream outFile(filename);
-    if (!outFile) {
+    ScopedPhaseTimer timer(stats.outputSeconds);
+    AsyncPrimeWriter writer;
+    if (!writer.open(filename)) {
         return false;
     }
     
     for (std::size_t i = 2; i <= limit; ++i) {
         if (getBit(i)) {
-            outFile << i << "\n";
+            writer.write(i);
         }
     }
     
-    outFile.close();
-    return true;
+    bool ok = writer.close();
+    if (outputStats) {
+        *outputStats = writer.getStats();
+    }
+    return ok;
 }
\ No newline at end of file
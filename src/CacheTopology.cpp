@@ -0,0 +1,213 @@
+#include "CacheTopology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+std::atomic<std::size_t> CacheTopology::segmentOverride{0};
+
+namespace {
+
+std::string readFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    if (in) {
+        std::getline(in, line);
+    }
+    return line;
+}
+
+/**
+ * @brief Parse a sysfs cache size such as "48K", "2048K" or "1M".
+ */
+std::size_t parseSize(const std::string& text) {
+    std::size_t value = 0;
+    std::size_t pos = 0;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+        value = value * 10 + static_cast<std::size_t>(text[pos] - '0');
+        ++pos;
+    }
+    if (pos < text.size()) {
+        switch (text[pos]) {
+            case 'K': value *= 1024; break;
+            case 'M': value *= 1024 * 1024; break;
+            case 'G': value *= 1024 * 1024 * 1024; break;
+            default: break;
+        }
+    }
+    return value;
+}
+
+/**
+ * @brief Count the CPUs in a sysfs CPU list such as "0-3,8-11".
+ */
+int countCpuList(const std::string& list) {
+    int count = 0;
+    std::istringstream in(list);
+    std::string range;
+    while (std::getline(in, range, ',')) {
+        std::size_t dash = range.find('-');
+        try {
+            if (dash == std::string::npos) {
+                std::stoi(range);
+                ++count;
+            } else {
+                count += std::stoi(range.substr(dash + 1)) - std::stoi(range.substr(0, dash)) + 1;
+            }
+        } catch (const std::exception&) {
+            // Ignore malformed entries
+        }
+    }
+    return count;
+}
+
+std::size_t roundToWords(std::size_t indices) {
+    return std::max<std::size_t>(indices / 64 * 64, 64);
+}
+
+} // namespace
+
+CacheTopology CacheTopology::fromSysfs(const std::string& cacheDir) {
+    CacheTopology topology;
+    for (int index = 0;; ++index) {
+        std::string base = cacheDir + "/index" + std::to_string(index) + "/";
+        std::string level = readFirstLine(base + "level");
+        if (level.empty()) break;
+
+        CacheLevel cache;
+        cache.level = std::atoi(level.c_str());
+        cache.type = readFirstLine(base + "type");
+        cache.sizeBytes = parseSize(readFirstLine(base + "size"));
+        cache.lineBytes = parseSize(readFirstLine(base + "coherency_line_size"));
+        cache.sharedCpus = std::max(1, countCpuList(readFirstLine(base + "shared_cpu_list")));
+        if (cache.sizeBytes > 0) {
+            topology.caches.push_back(cache);
+        }
+    }
+
+    if (!topology.caches.empty()) {
+        topology.source = "sysfs";
+    }
+    return topology;
+}
+
+CacheTopology CacheTopology::fromCpuid() {
+    CacheTopology topology;
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0, &eax, &ebx, &ecx, &edx) == 0) {
+        return topology;
+    }
+
+    // AMD reports the same layout in leaf 0x8000001D; "Auth" + "enti" + "cAMD"
+    bool amd = ebx == 0x68747541 && edx == 0x69746e65 && ecx == 0x444d4163;
+    unsigned int leaf = amd ? 0x8000001D : 4;
+    if (!amd && eax < 4) {
+        return topology;
+    }
+
+    for (unsigned int subleaf = 0; subleaf < 16; ++subleaf) {
+        if (__get_cpuid_count(leaf, subleaf, &eax, &ebx, &ecx, &edx) == 0) break;
+        unsigned int type = eax & 0x1F;
+        if (type == 0) break;  // No more caches
+
+        CacheLevel cache;
+        cache.level = static_cast<int>((eax >> 5) & 0x7);
+        cache.type = type == 1 ? "Data" : type == 2 ? "Instruction" : "Unified";
+        cache.lineBytes = (ebx & 0xFFF) + 1;
+        std::size_t partitions = ((ebx >> 12) & 0x3FF) + 1;
+        std::size_t ways = ((ebx >> 22) & 0x3FF) + 1;
+        std::size_t sets = static_cast<std::size_t>(ecx) + 1;
+        cache.sizeBytes = ways * partitions * cache.lineBytes * sets;
+        cache.sharedCpus = static_cast<int>(((eax >> 14) & 0xFFF) + 1);
+        topology.caches.push_back(cache);
+    }
+#endif
+
+    if (!topology.caches.empty()) {
+        topology.source = "cpuid";
+    }
+    return topology;
+}
+
+CacheTopology CacheTopology::detect() {
+    CacheTopology topology = fromSysfs("/sys/devices/system/cpu/cpu0/cache");
+    if (topology.caches.empty()) {
+        topology = fromCpuid();
+    }
+    std::stable_sort(topology.caches.begin(), topology.caches.end(),
+                     [](const CacheLevel& a, const CacheLevel& b) { return a.level < b.level; });
+    return topology;
+}
+
+const CacheTopology& CacheTopology::host() {
+    static const CacheTopology topology = detect();
+    return topology;
+}
+
+void CacheTopology::setSegmentOverride(std::size_t indices) {
+    segmentOverride.store(indices == 0 ? 0 : roundToWords(indices), std::memory_order_relaxed);
+}
+
+const CacheLevel* CacheTopology::find(int level) const {
+    for (const auto& cache : caches) {
+        if (cache.level == level && cache.type != "Instruction") {
+            return &cache;
+        }
+    }
+    return nullptr;
+}
+
+std::size_t CacheTopology::l1dBytes() const {
+    const CacheLevel* l1 = find(1);
+    return l1 ? l1->sizeBytes : DEFAULT_L1D_BYTES;
+}
+
+std::size_t CacheTopology::l2BytesPerCpu() const {
+    const CacheLevel* l2 = find(2);
+    if (!l2) return DEFAULT_L2_BYTES;
+    // SMT siblings sieve their own segments at the same time, so each gets a share
+    return std::max(l2->sizeBytes / static_cast<std::size_t>(l2->sharedCpus), l1dBytes());
+}
+
+std::size_t CacheTopology::l3BytesPerCpu() const {
+    const CacheLevel* l3 = find(3);
+    if (!l3) return DEFAULT_L3_BYTES;
+    return std::max(l3->sizeBytes / static_cast<std::size_t>(l3->sharedCpus), l2BytesPerCpu());
+}
+
+std::size_t CacheTopology::lineBytes() const {
+    const CacheLevel* l1 = find(1);
+    return l1 && l1->lineBytes > 0 ? l1->lineBytes : DEFAULT_LINE_BYTES;
+}
+
+std::size_t CacheTopology::blockIndices() const {
+    return roundToWords(l1dBytes() * 8);
+}
+
+std::size_t CacheTopology::segmentIndices() const {
+    std::size_t forced = segmentOverride.load(std::memory_order_relaxed);
+    return forced > 0 ? forced : roundToWords(l2BytesPerCpu() * 8);
+}
+
+std::string CacheTopology::toText() const {
+    std::ostringstream oss;
+    oss << "  Caches (" << source << "):\n";
+    for (const auto& cache : caches) {
+        oss << "    L" << cache.level << " " << cache.type << ": " << cache.sizeBytes / 1024 << " KiB, "
+            << cache.lineBytes << " B lines, shared by " << cache.sharedCpus
+            << (cache.sharedCpus == 1 ? " CPU\n" : " CPUs\n");
+    }
+    if (caches.empty()) {
+        oss << "    not detected, assuming L1d " << DEFAULT_L1D_BYTES / 1024 << " KiB, L2 "
+            << DEFAULT_L2_BYTES / 1024 << " KiB, L3 " << DEFAULT_L3_BYTES / 1024 << " KiB\n";
+    }
+    oss << "  Block size: " << blockIndices() << " integers (L1d)\n";
+    oss << "  Segment size: " << segmentIndices() << " integers ("
+        << (segmentOverride.load(std::memory_order_relaxed) > 0 ? "--segment-size" : "L2 per CPU") << ")\n";
+    oss << "  Tier limits: small < " << smallPrimeLimit() << " <= medium < " << mediumPrimeLimit() << "\n";
+    return oss.str();
+}
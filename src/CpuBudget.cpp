@@ -0,0 +1,222 @@
+#include "CpuBudget.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace {
+
+std::string readFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    if (in) {
+        std::getline(in, line);
+    }
+    return line;
+}
+
+/**
+ * @brief Parse a cgroup v2 cpu.max line such as "400000 100000" or "max 100000".
+ * @return Quota in CPUs, or 0 if unlimited or unreadable.
+ */
+double parseCpuMax(const std::string& line) {
+    std::istringstream in(line);
+    std::string quota;
+    double period = 0.0;
+    if (!(in >> quota >> period) || quota == "max" || period <= 0.0) {
+        return 0.0;
+    }
+    return std::atof(quota.c_str()) / period;
+}
+
+/**
+ * @brief Read a cgroup v1 cpu.cfs_quota_us / cpu.cfs_period_us pair.
+ * @return Quota in CPUs, or 0 if unlimited (-1) or unreadable.
+ */
+double readCfsQuota(const std::string& dir) {
+    std::string quota = readFirstLine(dir + "/cpu.cfs_quota_us");
+    std::string period = readFirstLine(dir + "/cpu.cfs_period_us");
+    if (quota.empty() || period.empty()) {
+        return 0.0;
+    }
+    double q = std::atof(quota.c_str());
+    double p = std::atof(period.c_str());
+    return q > 0.0 && p > 0.0 ? q / p : 0.0;
+}
+
+/**
+ * @brief Walk from a cgroup directory up to the mount root, keeping the tightest quota.
+ */
+void tightestQuota(const std::string& mount, std::string path, bool v2, double& quota, std::string& source) {
+    while (true) {
+        std::string dir = mount + path;
+        std::string file = dir + (v2 ? "/cpu.max" : "/cpu.cfs_quota_us");
+        double cpus = v2 ? parseCpuMax(readFirstLine(file)) : readCfsQuota(dir);
+        if (cpus > 0.0 && (quota == 0.0 || cpus < quota)) {
+            quota = cpus;
+            source = file;
+        }
+        if (path.empty() || path == "/") break;
+        std::size_t slash = path.find_last_of('/');
+        path = slash == std::string::npos ? "" : path.substr(0, slash);
+    }
+}
+
+} // namespace
+
+double CpuBudget::readCgroupQuota(const std::string& cgroupRoot, const std::string& cgroupFile,
+                                  std::string& source) {
+    double quota = 0.0;
+    std::ifstream in(cgroupFile);
+    std::string line;
+    while (std::getline(in, line)) {
+        // hierarchy-ID:controller-list:path
+        std::size_t first = line.find(':');
+        std::size_t second = first == std::string::npos ? std::string::npos : line.find(':', first + 1);
+        if (second == std::string::npos) continue;
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+
+        if (controllers.empty()) {
+            // cgroup v2, mounted at the root or under "unified" on hybrid hosts
+            tightestQuota(cgroupRoot, path, true, quota, source);
+            tightestQuota(cgroupRoot + "/unified", path, true, quota, source);
+            continue;
+        }
+
+        std::istringstream list(controllers);
+        std::string controller;
+        while (std::getline(list, controller, ',')) {
+            if (controller == "cpu") {
+                // cgroup v1, mounted under the joined controller list (e.g. "cpu,cpuacct") or "cpu"
+                tightestQuota(cgroupRoot + "/" + controllers, path, false, quota, source);
+                if (controllers != "cpu") {
+                    tightestQuota(cgroupRoot + "/cpu", path, false, quota, source);
+                }
+                break;
+            }
+        }
+    }
+    return quota;
+}
+
+int CpuBudget::parseOmpNumThreads(const char* value) {
+    if (value == nullptr) {
+        return 0;
+    }
+    char* end = nullptr;
+    long threads = std::strtol(value, &end, 10);
+    if (end == value || (*end != '\0' && *end != ',') || threads <= 0) {
+        return 0;
+    }
+    return static_cast<int>(threads);
+}
+
+int CpuBudget::readAffinityCpus() {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        return CPU_COUNT(&set);
+    }
+#endif
+    return 0;
+}
+
+CpuBudget CpuBudget::fromSources(int logical, int affinity, const std::string& cgroupRoot,
+                                 const std::string& cgroupFile, const char* ompNumThreads) {
+    CpuBudget budget;
+    budget.logicalCpus = std::max(logical, 1);
+    budget.affinityCpus = std::max(affinity, 0);
+    budget.quotaCpus = readCgroupQuota(cgroupRoot, cgroupFile, budget.quotaSource);
+    budget.ompThreads = parseOmpNumThreads(ompNumThreads);
+    return budget;
+}
+
+CpuBudget CpuBudget::detect() {
+    return fromSources(static_cast<int>(std::thread::hardware_concurrency()), readAffinityCpus(),
+                       "/sys/fs/cgroup", "/proc/self/cgroup", std::getenv("OMP_NUM_THREADS"));
+}
+
+const CpuBudget& CpuBudget::host() {
+    static const CpuBudget budget = detect();
+    return budget;
+}
+
+int CpuBudget::availableCpus() const {
+    int cpus = logicalCpus;
+    if (affinityCpus > 0) {
+        cpus = std::min(cpus, affinityCpus);
+    }
+    if (quotaCpus > 0.0) {
+        // A 1.5-CPU quota keeps two threads busy most of the time
+        cpus = std::min(cpus, static_cast<int>(std::ceil(quotaCpus)));
+    }
+    return std::max(cpus, 1);
+}
+
+std::string CpuBudget::limitedBy() const {
+    int cpus = availableCpus();
+    if (quotaCpus > 0.0 && static_cast<int>(std::ceil(quotaCpus)) == cpus) {
+        std::ostringstream oss;
+        oss << "cgroup quota " << std::fixed << std::setprecision(2) << quotaCpus << " CPUs";
+        return oss.str();
+    }
+    if (affinityCpus > 0 && affinityCpus == cpus && affinityCpus < logicalCpus) {
+        return "affinity mask";
+    }
+    return "logical CPUs";
+}
+
+int CpuBudget::recommendedThreads() const {
+    return ompThreads > 0 ? ompThreads : availableCpus();
+}
+
+std::vector<std::string> CpuBudget::warnings(int threads) const {
+    std::vector<std::string> result;
+    int cpus = availableCpus();
+    if (threads > cpus) {
+        std::string warning = std::to_string(threads) + " threads oversubscribe the " + std::to_string(cpus) +
+                              " available CPUs (" + limitedBy() + ")";
+        if (threads == ompThreads) {
+            warning += "; the count comes from OMP_NUM_THREADS";
+        }
+        result.push_back(warning + "; threads will wait for CPU time");
+    }
+    return result;
+}
+
+std::string CpuBudget::toText() const {
+    std::ostringstream oss;
+    oss << "  Logical CPUs: " << logicalCpus << "\n";
+    oss << "  Affinity mask: ";
+    if (affinityCpus > 0) {
+        oss << affinityCpus << " CPUs\n";
+    } else {
+        oss << "unknown\n";
+    }
+    oss << "  CPU quota: ";
+    if (quotaCpus > 0.0) {
+        oss << std::fixed << std::setprecision(2) << quotaCpus << " CPUs (" << quotaSource << ")\n";
+    } else {
+        oss << "none\n";
+    }
+    oss << "  OMP_NUM_THREADS: ";
+    if (ompThreads > 0) {
+        oss << ompThreads << "\n";
+    } else {
+        oss << "unset\n";
+    }
+    oss << "  Available CPUs: " << availableCpus() << " (" << limitedBy() << ")\n";
+    oss << "  Default threads: " << recommendedThreads() << "\n";
+    for (const auto& warning : warnings(recommendedThreads())) {
+        oss << "  Warning: " << warning << "\n";
+    }
+    return oss.str();
+}
@@ -0,0 +1,224 @@
+#include "CpuTopology.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+std::string readFirstLine(const std::string& path) {
+    std::ifstream in(path);
+    std::string line;
+    if (in) {
+        std::getline(in, line);
+    }
+    return line;
+}
+
+/**
+ * @brief Read the CPUs in the calling thread's affinity mask.
+ */
+std::vector<int> currentMask() {
+    std::vector<int> result;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) result.push_back(cpu);
+        }
+    }
+#endif
+    return result;
+}
+
+/**
+ * @brief Restrict the calling thread to a set of CPUs.
+ * @return True on success.
+ */
+bool setMask(const std::vector<int>& cpus) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return !cpus.empty() && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpus;
+    return false;
+#endif
+}
+
+} // namespace
+
+CpuTopology CpuTopology::fromSysfs(const std::string& cpuDir, const std::vector<int>& allowed) {
+    CpuTopology topology;
+    bool found = false;
+    for (int cpu : allowed) {
+        std::string base = cpuDir + "/cpu" + std::to_string(cpu) + "/topology/";
+        std::string core = readFirstLine(base + "core_id");
+        LogicalCpu entry;
+        entry.cpu = cpu;
+        if (core.empty()) {
+            entry.core = cpu;  // Unknown: its own core
+        } else {
+            entry.core = std::atoi(core.c_str());
+            entry.package = std::atoi(readFirstLine(base + "physical_package_id").c_str());
+            found = true;
+        }
+        topology.cpus.push_back(entry);
+    }
+
+    // Number the SMT siblings of each core in CPU order
+    std::sort(topology.cpus.begin(), topology.cpus.end(),
+              [](const LogicalCpu& a, const LogicalCpu& b) { return a.cpu < b.cpu; });
+    std::map<std::pair<int, int>, int> siblings;
+    for (auto& entry : topology.cpus) {
+        entry.sibling = siblings[{entry.package, entry.core}]++;
+    }
+
+    if (found) {
+        topology.source = "sysfs";
+    }
+    return topology;
+}
+
+std::vector<int> CpuTopology::allowedCpus() {
+    std::vector<int> allowed = currentMask();
+    if (allowed.empty()) {
+        int count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < count; ++cpu) allowed.push_back(cpu);
+    }
+    return allowed;
+}
+
+CpuTopology CpuTopology::detect() {
+    return fromSysfs("/sys/devices/system/cpu", allowedCpus());
+}
+
+const CpuTopology& CpuTopology::host() {
+    static const CpuTopology topology = detect();
+    return topology;
+}
+
+bool CpuTopology::parsePolicy(const std::string& name, AffinityPolicy& policy) {
+    for (AffinityPolicy p : {AffinityPolicy::None, AffinityPolicy::Physical,
+                             AffinityPolicy::Compact, AffinityPolicy::Scatter}) {
+        if (name == policyName(p)) {
+            policy = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* CpuTopology::policyName(AffinityPolicy policy) {
+    switch (policy) {
+        case AffinityPolicy::None: return "none";
+        case AffinityPolicy::Physical: return "physical";
+        case AffinityPolicy::Compact: return "compact";
+        case AffinityPolicy::Scatter: return "scatter";
+    }
+    return "none";
+}
+
+int CpuTopology::physicalCores() const {
+    std::set<std::pair<int, int>> cores;
+    for (const auto& entry : cpus) {
+        cores.insert({entry.package, entry.core});
+    }
+    return std::max(1, static_cast<int>(cores.size()));
+}
+
+int CpuTopology::packages() const {
+    std::set<int> ids;
+    for (const auto& entry : cpus) {
+        ids.insert(entry.package);
+    }
+    return std::max(1, static_cast<int>(ids.size()));
+}
+
+int CpuTopology::threadsPerCore() const {
+    int most = 0;
+    for (const auto& entry : cpus) {
+        most = std::max(most, entry.sibling + 1);
+    }
+    return std::max(1, most);
+}
+
+std::vector<int> CpuTopology::placement(AffinityPolicy policy, int threads) const {
+    std::vector<int> result;
+    if (policy == AffinityPolicy::None || cpus.empty() || threads <= 0) {
+        return result;
+    }
+
+    // Rank each core within its package, so scatter can alternate packages
+    std::map<std::pair<int, int>, int> coreRank;
+    std::map<int, int> coresInPackage;
+    for (const auto& entry : cpus) {
+        auto key = std::make_pair(entry.package, entry.core);
+        if (coreRank.find(key) == coreRank.end()) {
+            coreRank[key] = coresInPackage[entry.package]++;
+        }
+    }
+
+    std::vector<LogicalCpu> order = cpus;
+    if (policy == AffinityPolicy::Compact) {
+        std::sort(order.begin(), order.end(), [&](const LogicalCpu& a, const LogicalCpu& b) {
+            return std::make_tuple(a.package, coreRank[{a.package, a.core}], a.sibling) <
+                   std::make_tuple(b.package, coreRank[{b.package, b.core}], b.sibling);
+        });
+    } else {
+        std::sort(order.begin(), order.end(), [&](const LogicalCpu& a, const LogicalCpu& b) {
+            return std::make_tuple(a.sibling, coreRank[{a.package, a.core}], a.package) <
+                   std::make_tuple(b.sibling, coreRank[{b.package, b.core}], b.package);
+        });
+        if (policy == AffinityPolicy::Physical) {
+            order.erase(std::remove_if(order.begin(), order.end(),
+                                       [](const LogicalCpu& entry) { return entry.sibling > 0; }),
+                        order.end());
+        }
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        result.push_back(order[static_cast<std::size_t>(i) % order.size()].cpu);
+    }
+    return result;
+}
+
+std::string CpuTopology::toText() const {
+    std::ostringstream oss;
+    oss << "  CPU topology (" << source << "): " << cpus.size() << " logical CPUs, " << physicalCores()
+        << " physical cores, " << packages() << (packages() == 1 ? " package, " : " packages, ")
+        << threadsPerCore() << (threadsPerCore() == 1 ? " thread per core\n" : " threads per core\n");
+    for (AffinityPolicy policy : {AffinityPolicy::Physical, AffinityPolicy::Compact, AffinityPolicy::Scatter}) {
+        int threads = policy == AffinityPolicy::Physical ? physicalCores() : static_cast<int>(cpus.size());
+        oss << "    --affinity " << policyName(policy) << ":";
+        for (int cpu : placement(policy, threads)) {
+            oss << " " << cpu;
+        }
+        oss << "\n";
+    }
+    return oss.str();
+}
+
+ScopedPin::ScopedPin(int cpu) {
+    if (cpu < 0) return;
+    saved = currentMask();
+    pinned = setMask({cpu});
+}
+
+ScopedPin::~ScopedPin() {
+    if (pinned) {
+        setMask(saved);
+    }
+}
@@ -0,0 +1,85 @@
+#include "MemoryTracker.hpp"
+#include <sys/resource.h>
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+std::string mebibytes(std::size_t bytes) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2) << static_cast<double>(bytes) / (1024.0 * 1024.0) << " MiB";
+    return oss.str();
+}
+
+} // namespace
+
+std::size_t MemoryTracker::maxResidentBytes() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;  // Kilobytes on Linux
+}
+
+void MemoryTracker::beginPhase(const std::string& name) {
+    resetPeak();
+    PhaseMemory phase;
+    phase.name = name;
+    phase.startBytes = liveBytes();
+    phases.push_back(phase);
+    allocatedAtStart = allocatedBytes();
+    countAtStart = allocationCount();
+}
+
+void MemoryTracker::endPhase() {
+    if (phases.empty()) return;
+    PhaseMemory& phase = phases.back();
+    phase.peakBytes = std::max(peakBytes(), phase.startBytes);
+    phase.endBytes = liveBytes();
+    phase.allocatedBytes = allocatedBytes() - allocatedAtStart;
+    phase.allocations = allocationCount() - countAtStart;
+}
+
+std::size_t MemoryTracker::overallPeakBytes() const {
+    std::size_t highest = 0;
+    for (const auto& phase : phases) {
+        highest = std::max(highest, phase.peakBytes);
+    }
+    return highest;
+}
+
+std::string MemoryTracker::toText() const {
+    std::ostringstream oss;
+    if (!isInstalled()) {
+        oss << "  Heap accounting unavailable (allocator hook not linked)\n";
+    } else {
+        oss << "  Heap by phase (live at end / peak / allocated, allocations):\n";
+        for (const auto& phase : phases) {
+            oss << "    " << std::left << std::setw(10) << phase.name << std::right
+                << mebibytes(phase.endBytes) << " / " << mebibytes(phase.peakBytes) << " / "
+                << mebibytes(phase.allocatedBytes) << ", " << phase.allocations << "\n";
+        }
+        oss << "  Peak heap: " << mebibytes(overallPeakBytes()) << "\n";
+    }
+    oss << "  Peak RSS (getrusage): " << mebibytes(maxResidentBytes()) << "\n";
+    return oss.str();
+}
+
+std::string MemoryTracker::toJson() const {
+    std::ostringstream oss;
+    oss << "{\"hooked\": " << (isInstalled() ? "true" : "false")
+        << ", \"peak_heap_bytes\": " << overallPeakBytes()
+        << ", \"max_rss_bytes\": " << maxResidentBytes() << ", \"phases\": [";
+    for (std::size_t i = 0; i < phases.size(); ++i) {
+        const auto& phase = phases[i];
+        oss << (i == 0 ? "" : ", ") << "{\"name\": \"" << phase.name << "\""
+            << ", \"start_bytes\": " << phase.startBytes
+            << ", \"peak_bytes\": " << phase.peakBytes
+            << ", \"end_bytes\": " << phase.endBytes
+            << ", \"allocated_bytes\": " << phase.allocatedBytes
+            << ", \"allocations\": " << phase.allocations << "}";
+    }
+    oss << "]}";
+    return oss.str();
+}
@@ -0,0 +1,92 @@
+#include "MemoryTracker.hpp"
+#include <malloc.h>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+// Replacement global allocation functions that feed MemoryTracker. Linked
+// only into the executables, so the library and the tests keep the default
+// allocator. Blocks are measured with malloc_usable_size() on both sides, so
+// unsized and sized deletes account identically.
+
+namespace {
+
+void* allocate(std::size_t size) {
+    void* p = std::malloc(size ? size : 1);
+    if (p) {
+        MemoryTracker::recordAllocation(malloc_usable_size(p));
+    }
+    return p;
+}
+
+void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+    void* p = nullptr;
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), sizeof(void*));
+    if (posix_memalign(&p, align, size ? size : 1) != 0) {
+        return nullptr;
+    }
+    MemoryTracker::recordAllocation(malloc_usable_size(p));
+    return p;
+}
+
+void release(void* p) noexcept {
+    if (p) {
+        MemoryTracker::recordRelease(malloc_usable_size(p));
+        std::free(p);
+    }
+}
+
+// Tells MemoryTracker the hook is linked, before main() starts any phase
+struct HookRegistration {
+    HookRegistration() { MemoryTracker::markInstalled(); }
+} registration;
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    void* p = allocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    void* p = allocate(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* p = allocateAligned(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    void* p = allocateAligned(size, alignment);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, std::size_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t) noexcept { release(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { release(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { release(p); }
@@ -0,0 +1,167 @@
+#include "MetricsRegistry.hpp"
+#include <unistd.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+std::string formatValue(double v) {
+    std::ostringstream oss;
+    oss.precision(15);
+    oss << v;
+    return oss.str();
+}
+
+double residentMemoryBytes() {
+    std::ifstream statm("/proc/self/statm");
+    std::size_t pages = 0;
+    std::size_t resident = 0;
+    if (!(statm >> pages >> resident)) {
+        return 0.0;
+    }
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE));
+}
+
+} // namespace
+
+Histogram::Histogram(std::vector<double> upperBounds)
+    : bounds(std::move(upperBounds)),
+      buckets(new std::atomic<std::uint64_t>[bounds.size() + 1]) {
+    for (std::size_t i = 0; i <= bounds.size(); ++i) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+std::vector<double> Histogram::exponentialBounds(double start, double factor, std::size_t count) {
+    std::vector<double> result;
+    result.reserve(count);
+    double bound = start;
+    for (std::size_t i = 0; i < count; ++i) {
+        result.push_back(bound);
+        bound *= factor;
+    }
+    return result;
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    static MetricsRegistry* registry = [] {
+        auto* r = new MetricsRegistry();
+        r->callbackGauge("process_resident_memory_bytes", "Resident set size of the process",
+                         residentMemoryBytes);
+        return r;
+    }();
+    return *registry;
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, Type type, const std::string& help) {
+    auto it = families.find(name);
+    if (it != families.end()) {
+        if (it->second.type != type) {
+            throw std::invalid_argument("Metric " + name + " is already registered with another type");
+        }
+        return it->second;
+    }
+    Family& f = families[name];
+    f.type = type;
+    f.help = help;
+    return f;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Family& f = family(name, Type::Counter, help);
+    if (!f.counter) {
+        f.counter = std::make_unique<Counter>();
+    }
+    return *f.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Family& f = family(name, Type::Gauge, help);
+    if (!f.gauge) {
+        f.gauge = std::make_unique<Gauge>();
+    }
+    return *f.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, std::vector<double> bounds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Family& f = family(name, Type::Histogram, help);
+    if (!f.histogram) {
+        f.histogram = std::make_unique<Histogram>(std::move(bounds));
+    }
+    return *f.histogram;
+}
+
+void MetricsRegistry::callbackGauge(const std::string& name, const std::string& help, std::function<double()> callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Family& f = family(name, Type::CallbackGauge, help);
+    f.callback = std::move(callback);
+}
+
+std::string MetricsRegistry::toOpenMetrics() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream oss;
+
+    for (const auto& entry : families) {
+        const std::string& name = entry.first;
+        const Family& f = entry.second;
+
+        switch (f.type) {
+        case Type::Counter:
+            oss << "# TYPE " << name << " counter\n";
+            oss << "# HELP " << name << " " << f.help << "\n";
+            oss << name << "_total " << f.counter->value() << "\n";
+            break;
+        case Type::Gauge:
+            oss << "# TYPE " << name << " gauge\n";
+            oss << "# HELP " << name << " " << f.help << "\n";
+            oss << name << " " << formatValue(f.gauge->value()) << "\n";
+            break;
+        case Type::CallbackGauge:
+            oss << "# TYPE " << name << " gauge\n";
+            oss << "# HELP " << name << " " << f.help << "\n";
+            oss << name << " " << formatValue(f.callback ? f.callback() : 0.0) << "\n";
+            break;
+        case Type::Histogram: {
+            const Histogram& h = *f.histogram;
+            oss << "# TYPE " << name << " histogram\n";
+            oss << "# HELP " << name << " " << f.help << "\n";
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < h.getBounds().size(); ++i) {
+                cumulative += h.bucketCount(i);
+                oss << name << "_bucket{le=\"" << formatValue(h.getBounds()[i]) << "\"} " << cumulative << "\n";
+            }
+            cumulative += h.bucketCount(h.getBounds().size());
+            oss << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
+            oss << name << "_count " << cumulative << "\n";
+            oss << name << "_sum " << formatValue(h.getSum()) << "\n";
+            break;
+        }
+        }
+    }
+
+    oss << "# EOF\n";
+    return oss.str();
+}
+
+bool MetricsRegistry::writeOpenMetrics(const std::string& filename) const {
+    std::string text = toOpenMetrics();
+    if (filename == "-") {
+        std::cout << text;
+        return static_cast<bool>(std::cout);
+    }
+
+    std::string temporary = filename + ".tmp";
+    {
+        std::ofstream out(temporary);
+        if (!out || !(out << text)) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), filename.c_str()) == 0;
+}
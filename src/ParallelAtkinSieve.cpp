@@ -0,0 +1,158 @@
+#include "ParallelAtkinSieve.hpp"
+#include "ProgressReporter.hpp"
+#include "TraceRecorder.hpp"
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <array>
+#include <atomic>
+
+ParallelAtkinSieve::ParallelAtkinSieve(std::size_t n, int threads)
+    : AtkinSieve(n), ParallelSieveBase(threads) {
+}
+
+void ParallelAtkinSieve::generate() {
+    if (isGenerated()) return; // Already generated
+
+    // Parallel regions run on one thread when parallel processing is disabled
+    int threads = useParallel ? threadCount : 1;
+
+    if (threads <= 1 && !progress && !cancellation) {
+        // Use sequential implementation for single thread
+        AtkinSieve::generate();
+        return;
+    }
+
+    std::size_t limit = getLimit();
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+    SieveStats& stats = getMutableStats();
+
+    // Unlike Eratosthenes every block needs the quadratic forms, so the blocks
+    // cover the whole range; block sizes are multiples of 64 numbers, and each
+    // thread takes chunks of consecutive blocks
+    std::size_t blockSize = getBlockSize(limit + 1);
+    std::size_t blockCount = (limit + 1 + blockSize - 1) / blockSize;
+    std::size_t chunkBlocks = getChunkSize(limit + 1, blockSize) / blockSize;
+    std::size_t chunkCount = (blockCount + chunkBlocks - 1) / chunkBlocks;
+    auto bounds = stats.tierBounds(basePrimes);
+
+    if (progress) {
+        progress->begin(0, limit, threads, 0);
+    }
+
+    double formSeconds = 0.0;
+    std::size_t toggles = 0;
+    std::array<double, SieveStats::TIER_COUNT> tierSeconds{};
+    std::array<std::size_t, SieveStats::TIER_COUNT> tierCrossOffs{};
+    std::atomic<bool> stopped{false};
+
+    #pragma omp parallel num_threads(threads)
+    {
+        ScopedPin pin = pinWorker();
+        double localFormSeconds = 0.0;
+        std::size_t localToggles = 0;
+        std::array<double, SieveStats::TIER_COUNT> localSeconds{};
+        std::array<std::size_t, SieveStats::TIER_COUNT> localCrossOffs{};
+        SievingPrimes state(basePrimes);
+
+        #pragma omp for schedule(dynamic) nowait
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            if (stopped.load(std::memory_order_relaxed)) continue;  // Skip the rest once a thread stopped
+            std::size_t firstBlock = chunk * chunkBlocks;
+            std::size_t lastBlock = std::min(firstBlock + chunkBlocks, blockCount);
+            seedSquares(state, firstBlock * blockSize);
+
+            for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+                if (stopRequested()) {
+                    stopped.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                std::size_t low = block * blockSize;
+                std::size_t high = std::min(low + blockSize - 1, limit);
+
+                {
+                    TraceScope trace("quadratic forms", "sieve", "low", low, "high", high);
+                    auto formStart = std::chrono::steady_clock::now();
+                    localToggles += toggleQuadraticForms(low, high);
+                    localFormSeconds += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - formStart).count();
+                }
+
+                for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                    TraceScope trace(SieveStats::tierName(tier), "sieve", "low", low, "high", high);
+                    auto tierStart = std::chrono::steady_clock::now();
+                    for (std::size_t k = bounds[tier]; k < bounds[tier + 1]; ++k) {
+                        localCrossOffs[tier] += eliminateSquares(state.primes[k], state.multiples[k], high);
+                    }
+                    localSeconds[tier] += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - tierStart).count();
+                }
+
+                if (progress) {
+                    progress->addCompleted(omp_get_thread_num(), high + 1 - low, countPrimesInBlock(low, high));
+                }
+            }
+        }
+
+        #pragma omp critical
+        {
+            formSeconds += localFormSeconds;
+            toggles += localToggles;
+            for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                tierSeconds[tier] += localSeconds[tier];
+                tierCrossOffs[tier] += localCrossOffs[tier];
+            }
+        }
+    }
+
+    if (progress) {
+        progress->finish();
+    }
+    throwIfStopped(stopped.load());
+
+    // Phase times are averaged over the threads so that they add up to wall time
+    stats.quadraticFormSeconds += formSeconds / threads;
+    stats.toggles = toggles;
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        stats.crossOffSeconds[tier] += tierSeconds[tier] / threads;
+        stats.crossOffs[tier] = tierCrossOffs[tier];
+    }
+
+    stats.publishMetrics(limit + 1);
+    setGenerated(true);
+}
+
+std::size_t ParallelAtkinSieve::countPrimesInBlock(std::size_t low, std::size_t high) const {
+    return countBits(low, high);
+}
+
+std::string ParallelAtkinSieve::getPerformanceStats() const {
+    if (!isGenerated()) {
+        return "Sieve not generated yet";
+    }
+
+    std::ostringstream oss;
+    oss << "Parallel AtkinSieve Performance:\n";
+    oss << "  Limit: " << getLimit() << "\n";
+    oss << "  Threads: " << threadCount << "\n";
+    oss << "  Parallel: " << (useParallel ? "Yes" : "No") << "\n";
+    oss << "  Memory Usage: " << getMemoryUsage() << " bytes\n";
+    oss << getStats().toText();
+
+    return oss.str();
+}
+
+std::string ParallelAtkinSieve::getPerformanceStatsJson() const {
+    std::ostringstream oss;
+    oss << "{\"engine\": \"Parallel AtkinSieve\"";
+    oss << ", \"limit\": " << getLimit();
+    oss << ", \"threads\": " << threadCount;
+    oss << ", \"parallel\": " << (useParallel ? "true" : "false");
+    oss << ", \"generated\": " << (isGenerated() ? "true" : "false");
+    oss << ", \"memory_bytes\": " << getMemoryUsage();
+    oss << ", \"phases\": " << getStats().toJson() << "}";
+
+    return oss.str();
+}
@@ -1,80 +1,138 @@
 #include "ParallelBasicSieve.hpp"
+#include "ProgressReporter.hpp"
+#include "TraceRecorder.hpp"
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <array>
+#include <atomic>
 
 ParallelBasicSieve::ParallelBasicSieve(std::size_t n, int threads) 
     : BasicSieve(n), ParallelSieveBase(threads) {
 }
 
-void ParallelBasicSieve::markMultiplesParallel(std::size_t prime) {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        for (std::size_t i = prime * prime; i <= getLimit(); i += prime) {
-            getSieve()[i] = false;
-        }
-        return;
-    }
-    
-    // Parallel implementation using work-sharing
-    std::size_t start = prime * prime;
-    std::size_t end = getLimit();
-    
-    // Calculate optimal chunk size for load balancing
-    std::size_t chunkSize = std::max((end - start) / (threadCount * 4),
-                                     static_cast<std::size_t>(1000));
-    
-    #pragma omp parallel for schedule(static, chunkSize)
-    for (std::size_t i = start; i <= end; i += prime) {
-        getSieve()[i] = false;
-    }
-}
-
-void ParallelBasicSieve::markMultiplesParallelChunked(std::size_t prime, std::size_t chunkSize) {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        for (std::size_t i = prime * prime; i <= getLimit(); i += prime) {
-            getSieve()[i] = false;
-        }
-        return;
-    }
-    
-    // Parallel implementation with explicit chunking for better load balancing
-    std::size_t start = prime * prime;
-    std::size_t end = getLimit();
-    
-    #pragma omp parallel for schedule(static, chunkSize)
-    for (std::size_t i = start; i <= end; i += prime) {
+std::size_t ParallelBasicSieve::markMultiplesInBlock(std::size_t prime, std::size_t& multiple, std::size_t high) {
+    std::size_t count = 0;
+    std::size_t i = multiple;
+    for (; i <= high; i += prime) {
         getSieve()[i] = false;
+        ++count;
     }
+    multiple = i;
+    return count;
 }
 
 void ParallelBasicSieve::generate() {
     if (isGenerated()) return; // Already generated
     
-    if (!useParallel || threadCount <= 1) {
+    // Parallel regions run on one thread when parallel processing is disabled
+    int threads = useParallel ? threadCount : 1;
+    
+    if (threads <= 1 && !progress && !cancellation) {
         // Use sequential implementation for single thread
         BasicSieve::generate();
         return;
     }
     
-    // Parallel sieve of Eratosthenes algorithm
-    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(getLimit()));
+    std::size_t limit = getLimit();
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+    SieveStats& stats = getMutableStats();
+    
+    // Split the range above sqrt(limit) into word-aligned chunks of consecutive
+    // blocks; each chunk is crossed off by a single thread, so threads never
+    // write the same word
+    std::size_t first = (sqrtLimit + 1) / 64 * 64;
+    std::size_t range = limit + 1 - first;
+    std::size_t blockSize = getBlockSize(range);
+    std::size_t blockCount = (range + blockSize - 1) / blockSize;
+    std::size_t chunkBlocks = getChunkSize(range, blockSize) / blockSize;
+    std::size_t chunkCount = (blockCount + chunkBlocks - 1) / chunkBlocks;
+    auto bounds = stats.tierBounds(basePrimes);
+    
+    if (progress) {
+        std::size_t primesBelow = basePrimes.size();
+        progress->begin(sqrtLimit + 1, limit, threads, primesBelow);
+    }
+    
+    std::array<double, SieveStats::TIER_COUNT> tierSeconds{};
+    std::array<std::size_t, SieveStats::TIER_COUNT> tierCrossOffs{};
+    std::atomic<bool> stopped{false};
     
-    // Use parallel for loop for finding primes
-    #pragma omp parallel for schedule(static)
-    for (std::size_t p = 2; p <= sqrtLimit; ++p) {
-        // If sieve[p] is true, then p is a prime
-        if (getSieve()[p]) {
-            // Mark multiples of p in parallel
-            markMultiplesParallel(p);
+    #pragma omp parallel num_threads(threads)
+    {
+        ScopedPin pin = pinWorker();
+        std::array<double, SieveStats::TIER_COUNT> localSeconds{};
+        std::array<std::size_t, SieveStats::TIER_COUNT> localCrossOffs{};
+        SievingPrimes state(basePrimes);
+        
+        #pragma omp for schedule(dynamic) nowait
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            if (stopped.load(std::memory_order_relaxed)) continue;  // Skip the rest once a thread stopped
+            std::size_t firstBlock = chunk * chunkBlocks;
+            std::size_t lastBlock = std::min(firstBlock + chunkBlocks, blockCount);
+            state.seed(std::max(first + firstBlock * blockSize, sqrtLimit + 1));
+            
+            // Each block runs through all tiers while it is still in cache
+            for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+                if (stopRequested()) {
+                    stopped.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                std::size_t low = std::max(first + block * blockSize, sqrtLimit + 1);
+                std::size_t high = std::min(first + (block + 1) * blockSize - 1, limit);
+                
+                for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                    TraceScope trace(SieveStats::tierName(tier), "sieve", "low", low, "high", high);
+                    auto tierStart = std::chrono::steady_clock::now();
+                    for (std::size_t k = bounds[tier]; k < bounds[tier + 1]; ++k) {
+                        localCrossOffs[tier] += markMultiplesInBlock(state.primes[k], state.multiples[k], high);
+                    }
+                    localSeconds[tier] += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - tierStart).count();
+                }
+                
+                if (progress) {
+                    progress->addCompleted(omp_get_thread_num(), high + 1 - low, countPrimesInBlock(low, high));
+                }
+            }
+        }
+        
+        #pragma omp critical
+        {
+            for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                tierSeconds[tier] += localSeconds[tier];
+                tierCrossOffs[tier] += localCrossOffs[tier];
+            }
         }
     }
     
+    if (progress) {
+        progress->finish();
+    }
+    throwIfStopped(stopped.load());
+    
+    // Tier times are averaged over the threads so that they add up to wall time
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        stats.crossOffSeconds[tier] += tierSeconds[tier] / threads;
+        stats.crossOffs[tier] = tierCrossOffs[tier];
+    }
+    
+    stats.publishMetrics(limit + 1);
     setGenerated(true);
 }
 
+std::size_t ParallelBasicSieve::countPrimesInBlock(std::size_t low, std::size_t high) const {
+    std::size_t count = 0;
+    for (std::size_t i = low; i <= high; ++i) {
+        if (getSieve()[i]) {
+            ++count;
+        }
+    }
+    return count;
+}
+
 std::string ParallelBasicSieve::getPerformanceStats() const {
     if (!isGenerated()) {
         return "Sieve not generated yet";
@@ -85,7 +143,21 @@ std::string ParallelBasicSieve::getPerformanceStats() const {
     oss << "  Limit: " << getLimit() << "\n";
     oss << "  Threads: " << threadCount << "\n";
     oss << "  Parallel: " << (useParallel ? "Yes" : "No") << "\n";
-    oss << "  Memory Usage: " << (getSieve().size() * sizeof(bool)) << " bytes\n";
+    oss << "  Memory Usage: " << getMemoryUsage() << " bytes\n";
+    oss << getStats().toText();
+    
+    return oss.str();
+}
+
+std::string ParallelBasicSieve::getPerformanceStatsJson() const {
+    std::ostringstream oss;
+    oss << "{\"engine\": \"Parallel BasicSieve\"";
+    oss << ", \"limit\": " << getLimit();
+    oss << ", \"threads\": " << threadCount;
+    oss << ", \"parallel\": " << (useParallel ? "true" : "false");
+    oss << ", \"generated\": " << (isGenerated() ? "true" : "false");
+    oss << ", \"memory_bytes\": " << getMemoryUsage();
+    oss << ", \"phases\": " << getStats().toJson() << "}";
     
     return oss.str();
 }
\ No newline at end of file
@@ -1,99 +1,239 @@
 #include "ParallelBitSieve.hpp"
-#include <chrono>
+#include "ProgressReporter.hpp"
+#include "TieredCrossOff.hpp"
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <array>
 
 ParallelBitSieve::ParallelBitSieve(std::size_t n, int threads) 
     : BitSieve(n), ParallelSieveBase(threads) {
 }
 
-void ParallelBitSieve::clearBitParallel(std::size_t index) {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        BitSieve::clearBit(index);
+void ParallelBitSieve::generate() {
+    if (isGenerated()) return; // Already generated
+    
+    // Parallel regions run on one thread when parallel processing is disabled
+    int threads = useParallel ? threadCount : 1;
+    
+    if ((threads <= 1 && !progress && !cancellation) || getFrontier() > 0) {
+        // Use sequential implementation for single thread, or to finish a generateStep() pass
+        BitSieve::generate();
         return;
     }
     
-    // For bit operations, we need to be careful with thread safety
-    // Each thread works on different 64-bit words, so we need
-    // to ensure no race conditions when clearing bits
-    std::size_t arrayIndex = index / 64;
-    std::size_t bitPosition = index % 64;
+    std::size_t limit = getLimit();
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+    SieveStats& stats = getMutableStats();
+    
+    // Split the range above sqrt(limit) into word-aligned chunks, a few per thread.
+    // Each chunk is sieved by a single thread, segment by segment with the
+    // tiered loops, so threads never write the same word
+    std::size_t first = (sqrtLimit + 1) / 64 * 64;
+    std::size_t range = limit + 1 - first;
+    std::size_t blockSize = getBlockSize(range);
+    std::size_t chunkSize = getChunkSize(range, blockSize);
+    std::size_t chunkCount = (range + chunkSize - 1) / chunkSize;
     
-    uint64_t mask = ~(1ULL << bitPosition);
-    #pragma omp critical
+    if (progress) {
+        std::size_t primesBelow = basePrimes.size();
+        progress->begin(sqrtLimit + 1, limit, threads, primesBelow);
+    }
+    
+    std::array<double, SieveStats::TIER_COUNT> tierSeconds{};
+    std::array<std::size_t, SieveStats::TIER_COUNT> tierCrossOffs{};
+    std::atomic<bool> stopped{false};
+    
+    #pragma omp parallel num_threads(threads)
     {
-        getBits()[arrayIndex] &= mask;
+        // Pin first, so the per-thread state below is first touched on the pinned CPU
+        ScopedPin pin = pinWorker();
+        
+        // Per-thread sieving state and buckets for the large primes
+        TieredCrossOff crossOff(basePrimes, stats);
+        
+        #pragma omp for schedule(dynamic) nowait
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            if (stopped.load(std::memory_order_relaxed)) continue;  // Skip the rest once a thread stopped
+            std::size_t low = std::max(first + chunk * chunkSize, sqrtLimit + 1);
+            std::size_t high = std::min(first + (chunk + 1) * chunkSize - 1, limit);
+            
+            crossOff.sieve(getBits(), low, high, [&](std::size_t segmentLow, std::size_t segmentHigh) {
+                if (progress) {
+                    progress->addCompleted(omp_get_thread_num(), segmentHigh + 1 - segmentLow,
+                                           countPrimesInBlock(segmentLow, segmentHigh));
+                }
+                if (stopRequested()) {
+                    stopped.store(true, std::memory_order_relaxed);
+                    return false;
+                }
+                return true;
+            });
+        }
+        
+        #pragma omp critical
+        {
+            for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                tierSeconds[tier] += crossOff.getSeconds()[tier];
+                tierCrossOffs[tier] += crossOff.getCrossOffs()[tier];
+            }
+        }
+    }
+    
+    if (progress) {
+        progress->finish();
     }
+    throwIfStopped(stopped.load());
+    
+    // Tier times are averaged over the threads so that they add up to wall time
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        stats.crossOffSeconds[tier] += tierSeconds[tier] / threads;
+        stats.crossOffs[tier] = tierCrossOffs[tier];
+    }
+    
+    stats.publishMetrics(limit + 1);
+    setGenerated(true);
 }
 
-void ParallelBitSieve::markMultiplesParallel(std::size_t prime) {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        for (std::size_t i = prime * prime; i <= getLimit(); i += prime) {
-            BitSieve::clearBit(i);
+void ParallelBitSieve::generateStreaming(const SegmentPipeline::Consumer& consumer, std::size_t inFlight) {
+    std::size_t limit = getLimit();
+    std::size_t segmentSize = TieredCrossOff::segmentSizeFor(getStats());
+    std::size_t segmentCount = limit / segmentSize + 1;
+    
+    auto fill = [&](FinishedSegment& segment, std::size_t sequence) {
+        segment.sequence = sequence;
+        segment.low = sequence * segmentSize;
+        segment.high = std::min(segment.low + segmentSize - 1, limit);
+        segment.words.assign(getBits().begin() + segment.low / 64, getBits().begin() + segment.high / 64 + 1);
+    };
+    
+    if (getFrontier() > 0 && !isGenerated()) {
+        // Finish a generateStep() pass where it left off, then replay it like generate()
+        BitSieve::generate();
+    }
+    
+    if (isGenerated()) {
+        FinishedSegment segment;
+        for (std::size_t sequence = 0; sequence < segmentCount; ++sequence) {
+            fill(segment, sequence);
+            consumer(segment);
         }
         return;
     }
     
-    // Parallel implementation using work-sharing
-    std::size_t start = prime * prime;
-    std::size_t end = getLimit();
+    int producers = useParallel ? threadCount : 1;
+    SegmentPipeline pipeline(inFlight ? inFlight : 4 * static_cast<std::size_t>(producers), producers, consumer);
     
-    // Calculate optimal chunk size for load balancing
-    // Use smaller chunks for bit operations to improve cache efficiency
-    std::size_t chunkSize = std::max((end - start) / (threadCount * 8), 
-                                     static_cast<std::size_t>(500));
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+    SieveStats& stats = getMutableStats();
     
-    #pragma omp parallel for schedule(static, chunkSize)
-    for (std::size_t i = start; i <= end; i += prime) {
-        BitSieve::clearBit(i);
+    // Chunks are runs of whole streaming segments, handed out in ascending
+    // order, so the lowest unpublished segment always has a running owner
+    std::size_t chunkSegments = std::max<std::size_t>(segmentCount / (4 * static_cast<std::size_t>(producers)), 1);
+    std::size_t chunkCount = (segmentCount + chunkSegments - 1) / chunkSegments;
+    
+    if (progress) {
+        progress->begin(sqrtLimit + 1, limit, producers, basePrimes.size());
     }
-}
-
-void ParallelBitSieve::markMultiplesParallelChunked(std::size_t prime, std::size_t chunkSize) {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        for (std::size_t i = prime * prime; i <= getLimit(); i += prime) {
-            BitSieve::clearBit(i);
+    
+    std::array<double, SieveStats::TIER_COUNT> tierSeconds{};
+    std::array<std::size_t, SieveStats::TIER_COUNT> tierCrossOffs{};
+    std::atomic<bool> stopped{false};
+    
+    #pragma omp parallel num_threads(producers)
+    {
+        ScopedPin pin = pinWorker();
+        TieredCrossOff crossOff(basePrimes, stats);
+        
+        #pragma omp for schedule(dynamic) nowait
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            if (stopped.load(std::memory_order_relaxed)) continue;  // Skip the rest once a thread stopped
+            std::size_t next = chunk * chunkSegments;
+            std::size_t end = std::min(next + chunkSegments, segmentCount);
+            
+            // Publish every segment of the chunk that ends at or below done; false once cancelled
+            auto publishUpTo = [&](std::size_t done) {
+                while (next < end && std::min((next + 1) * segmentSize - 1, limit) <= done) {
+                    FinishedSegment* slot = pipeline.acquire(next);
+                    if (!slot) return false;
+                    fill(*slot, next);
+                    pipeline.publish(next);
+                    ++next;
+                }
+                return true;
+            };
+            
+            std::size_t low = std::max(next * segmentSize, sqrtLimit + 1);
+            std::size_t high = std::min(end * segmentSize - 1, limit);
+            if (low <= high) {
+                crossOff.sieve(getBits(), low, high, [&](std::size_t segmentLow, std::size_t segmentHigh) {
+                    if (progress) {
+                        progress->addCompleted(omp_get_thread_num(), segmentHigh + 1 - segmentLow,
+                                               countPrimesInBlock(segmentLow, segmentHigh));
+                    }
+                    if (stopRequested()) {
+                        // Producers waiting for the consumer must not wait for this chunk
+                        stopped.store(true, std::memory_order_relaxed);
+                        pipeline.cancel();
+                        return false;
+                    }
+                    return publishUpTo(segmentHigh);
+                });
+            }
+            if (!stopped.load(std::memory_order_relaxed)) {
+                publishUpTo(limit);
+            }
+        }
+        
+        #pragma omp critical
+        {
+            for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                tierSeconds[tier] += crossOff.getSeconds()[tier];
+                tierCrossOffs[tier] += crossOff.getCrossOffs()[tier];
+            }
         }
-        return;
     }
     
-    // Parallel implementation with explicit chunking for better load balancing
-    std::size_t start = prime * prime;
-    std::size_t end = getLimit();
+    if (!stopped.load()) {
+        pipeline.finish(segmentCount);
+    }
     
-    #pragma omp parallel for schedule(static, chunkSize)
-    for (std::size_t i = start; i <= end; i += prime) {
-        BitSieve::clearBit(i);
+    if (progress) {
+        progress->finish();
     }
+    throwIfStopped(stopped.load());
+    
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        stats.crossOffSeconds[tier] += tierSeconds[tier] / producers;
+        stats.crossOffs[tier] = tierCrossOffs[tier];
+    }
+    
+    stats.publishMetrics(limit + 1);
+    setGenerated(true);
 }
 
-void ParallelBitSieve::generate() {
-    if (isGenerated()) return; // Already generated
-    
-    if (!useParallel || threadCount <= 1) {
-        // Use sequential implementation for single thread
-        BitSieve::generate();
-        return;
+bool ParallelBitSieve::generateToFile(const std::string& filename, OutputStats* outputStats) {
+    AsyncPrimeWriter writer;
+    if (!writer.open(filename)) {
+        return false;
     }
     
-    // Parallel bit sieve of Eratosthenes algorithm
-    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(getLimit()));
+    // The writer is only touched by the pipeline's consumer thread until close()
+    generateStreaming([&](const FinishedSegment& segment) {
+        segment.forEachPrime([&](std::size_t prime) { writer.write(prime); });
+    });
     
-    // Use parallel for loop for finding primes
-    #pragma omp parallel for schedule(static)
-    for (std::size_t p = 2; p <= sqrtLimit; ++p) {
-        // If p is prime (bit is set)
-        if (BitSieve::getBit(p)) {
-            // Mark multiples of p in parallel
-            markMultiplesParallel(p);
-        }
+    bool ok = writer.close();
+    if (outputStats) {
+        *outputStats = writer.getStats();
     }
-    
-    setGenerated(true);
+    return ok;
+}
+
+std::size_t ParallelBitSieve::countPrimesInBlock(std::size_t low, std::size_t high) const {
+    return countBits(low, high);
 }
 
 std::string ParallelBitSieve::getPerformanceStats() const {
@@ -107,6 +247,20 @@ std::string ParallelBitSieve::getPerformanceStats() const {
     oss << "  Threads: " << threadCount << "\n";
     oss << "  Parallel: " << (useParallel ? "Yes" : "No") << "\n";
     oss << "  Memory Usage: " << getMemoryUsage() << " bytes\n";
+    oss << getStats().toText();
+    
+    return oss.str();
+}
+
+std::string ParallelBitSieve::getPerformanceStatsJson() const {
+    std::ostringstream oss;
+    oss << "{\"engine\": \"Parallel BitSieve\"";
+    oss << ", \"limit\": " << getLimit();
+    oss << ", \"threads\": " << threadCount;
+    oss << ", \"parallel\": " << (useParallel ? "true" : "false");
+    oss << ", \"generated\": " << (isGenerated() ? "true" : "false");
+    oss << ", \"memory_bytes\": " << getMemoryUsage();
+    oss << ", \"phases\": " << getStats().toJson() << "}";
     
     return oss.str();
 }
\ No newline at end of file
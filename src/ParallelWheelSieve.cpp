@@ -1,138 +1,176 @@
 #include "ParallelWheelSieve.hpp"
+#include "PrimeTables.hpp"
+#include "ProgressReporter.hpp"
+#include "TraceRecorder.hpp"
 #include <chrono>
 #include <sstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
+#include <array>
+#include <atomic>
 
-ParallelWheelSieve::ParallelWheelSieve(std::size_t n, int threads) 
-    : WheelSieve(n), ParallelSieveBase(threads) {
+template <std::size_t Modulus>
+ParallelModWheelSieve<Modulus>::ParallelModWheelSieve(std::size_t n, int threads) 
+    : ModWheelSieve<Modulus>(n), ParallelSieveBase(threads) {
 }
 
-void ParallelWheelSieve::markMultiplesParallel(std::size_t prime) {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        std::size_t multiple = prime * prime;
-        while (multiple <= getLimit()) {
-            getSieve()[multiple] = false;
-            multiple += prime;
-        }
-        return;
-    }
+template <std::size_t Modulus>
+void ParallelModWheelSieve<Modulus>::generate() {
+    using Wheel = WheelTable<Modulus>;
+    if (this->isGenerated()) return; // Already generated
     
-    // Parallel implementation using work-sharing
-    std::size_t start = prime * prime;
-    std::size_t end = getLimit();
+    // Parallel regions run on one thread when parallel processing is disabled
+    int threads = useParallel ? threadCount : 1;
     
-    // Calculate optimal chunk size for load balancing
-    // Use smaller chunks for wheel operations to improve cache efficiency
-    std::size_t chunkSize = std::max((end - start) / (threadCount * 8), 
-                                     static_cast<std::size_t>(200));
-    
-    #pragma omp parallel for schedule(static, chunkSize)
-    for (std::size_t i = start; i <= end; i += prime) {
-        getSieve()[i] = false;
-    }
-}
-
-void ParallelWheelSieve::markMultiplesParallelChunked(std::size_t prime, std::size_t chunkSize) {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        std::size_t multiple = prime * prime;
-        while (multiple <= getLimit()) {
-            getSieve()[multiple] = false;
-            multiple += prime;
-        }
+    if (threads <= 1 && !progress && !cancellation) {
+        // Use sequential implementation for single thread
+        ModWheelSieve<Modulus>::generate();
         return;
     }
     
-    // Parallel implementation with explicit chunking for better load balancing
-    std::size_t start = prime * prime;
-    std::size_t end = getLimit();
-    
-    #pragma omp parallel for schedule(static, chunkSize)
-    for (std::size_t i = start; i <= end; i += prime) {
-        getSieve()[i] = false;
-    }
-}
-
-std::size_t ParallelWheelSieve::getNextWheelNumberParallel(std::size_t current) const {
-    if (!useParallel || threadCount <= 1) {
-        // Fallback to sequential implementation
-        return getNextWheelNumber(current);
-    }
-    
-    // For parallel wheel navigation, we need to be careful about
-    // maintaining the wheel state across threads
-    if (current < 7) {
-        // Handle small numbers (same as sequential)
-        if (current < 2) return 2;
-        if (current == 2) return 3;
-        if (current == 3) return 5;
-        if (current == 5) return 7;
-        return getLimit() + 1; // Signal end
+    std::size_t limit = this->getLimit();
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = this->findBasePrimes(sqrtLimit);
+    SieveStats& stats = this->getMutableStats();
+    
+    // Split the wheel indices above sqrt(limit) into word-aligned chunks of
+    // consecutive blocks; each chunk is crossed off by a single thread, so
+    // threads never write the same word
+    std::size_t entries = this->getSieve().size();
+    std::size_t firstIndex = Wheel::indexOf(sqrtLimit + 1);
+    std::size_t first = firstIndex / 64 * 64;
+    std::size_t blockSize = entries > first ? getBlockSize(entries - first) : 1;
+    std::size_t blockCount = entries > first ? (entries - first + blockSize - 1) / blockSize : 0;
+    std::size_t chunkBlocks = entries > first ? getChunkSize(entries - first, blockSize) / blockSize : 1;
+    std::size_t chunkCount = (blockCount + chunkBlocks - 1) / chunkBlocks;
+    auto bounds = stats.tierBounds(basePrimes);
+    
+    if (progress) {
+        // The primes dividing the modulus are neither sieving primes nor stored in blocks
+        std::size_t primesBelow = basePrimes.size();
+        for (std::size_t p : Wheel::PRIMES) {
+            if (p <= limit) ++primesBelow;
+        }
+        progress->begin(sqrtLimit + 1, limit, threads, primesBelow);
     }
     
-    // For numbers >= 7, use the wheel to find the next number
-    // that is not divisible by 2, 3, or 5
-    std::size_t next = current + 1;
-    
-    // Use parallel reduction to find the next valid wheel number
-    std::size_t found = 0;
+    std::array<double, SieveStats::TIER_COUNT> tierSeconds{};
+    std::array<std::size_t, SieveStats::TIER_COUNT> tierCrossOffs{};
+    std::atomic<bool> stopped{false};
     
-    #pragma omp parallel reduction(+:found)
+    #pragma omp parallel num_threads(threads)
     {
-        while (next <= getLimit()) {
-            if (next % 2 != 0 && next % 3 != 0 && next % 5 != 0) {
-                found = 1;
-                #pragma omp flush(found)
-                break;
+        ScopedPin pin = pinWorker();
+        std::array<double, SieveStats::TIER_COUNT> localSeconds{};
+        std::array<std::size_t, SieveStats::TIER_COUNT> localCrossOffs{};
+        SievingPrimes state(basePrimes);
+        
+        #pragma omp for schedule(dynamic) nowait
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            if (stopped.load(std::memory_order_relaxed)) continue;  // Skip the rest once a thread stopped
+            std::size_t firstBlock = chunk * chunkBlocks;
+            std::size_t lastBlock = std::min(firstBlock + chunkBlocks, blockCount);
+            std::size_t chunkEntry = std::max(first + firstBlock * blockSize, firstIndex);
+            this->seedMultiples(state, std::max(Wheel::valueAt(chunkEntry), sqrtLimit + 1));
+            
+            // Each block runs through all tiers while it is still in cache
+            for (std::size_t block = firstBlock; block < lastBlock; ++block) {
+                if (stopRequested()) {
+                    stopped.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                std::size_t firstEntry = std::max(first + block * blockSize, firstIndex);
+                std::size_t lastEntry = std::min(first + (block + 1) * blockSize, entries) - 1;
+                if (firstEntry > lastEntry) continue;
+                
+                // Numbers covered by the block: from its first wheel number up to the next block's
+                std::size_t low = std::max(Wheel::valueAt(firstEntry), sqrtLimit + 1);
+                std::size_t high = std::min(Wheel::valueAt(lastEntry), limit);
+                
+                for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                    TraceScope trace(SieveStats::tierName(tier), "sieve", "low", low, "high", high);
+                    auto tierStart = std::chrono::steady_clock::now();
+                    for (std::size_t k = bounds[tier]; k < bounds[tier + 1]; ++k) {
+                        localCrossOffs[tier] += this->crossOffFrom(state.primes[k], state.multiples[k],
+                                                                   state.wheelIndices[k], high);
+                    }
+                    localSeconds[tier] += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - tierStart).count();
+                }
+                
+                if (progress) {
+                    // Report the numbers up to the next block's first wheel number, so the gaps count too
+                    std::size_t from = block == 0 ? sqrtLimit + 1 : low;
+                    std::size_t to = block + 1 < blockCount ? Wheel::valueAt(lastEntry + 1) - 1 : limit;
+                    progress->addCompleted(omp_get_thread_num(), to + 1 - from,
+                                           countPrimesInBlock(firstEntry, lastEntry));
+                }
+            }
+        }
+        
+        #pragma omp critical
+        {
+            for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+                tierSeconds[tier] += localSeconds[tier];
+                tierCrossOffs[tier] += localCrossOffs[tier];
             }
-            if (found) break;
-            next++;
         }
     }
     
-    return found ? next : getLimit() + 1;
-}
-
-
-void ParallelWheelSieve::generate() {
-    if (isGenerated()) return; // Already generated
-    
-    if (!useParallel || threadCount <= 1) {
-        // Use sequential implementation for single thread
-        WheelSieve::generate();
-        return;
+    if (progress) {
+        progress->finish();
     }
+    throwIfStopped(stopped.load());
     
-    // Start with first prime in the wheel (7)
-    std::size_t p = 7;
-    
-    while (p * p <= getLimit()) {
-        // If p is prime
-        if (getSieve()[p]) {
-            // Mark multiples of p in parallel
-            markMultiplesParallel(p);
-        }
-        
-        // Move to the next potential prime using the wheel
-        p = getNextWheelNumberParallel(p);
+    // Tier times are averaged over the threads so that they add up to wall time
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        stats.crossOffSeconds[tier] += tierSeconds[tier] / threads;
+        stats.crossOffs[tier] = tierCrossOffs[tier];
     }
     
-    setGenerated(true);
+    stats.publishMetrics(limit + 1);
+    this->setGenerated(true);
 }
 
-std::string ParallelWheelSieve::getPerformanceStats() const {
-    if (!isGenerated()) {
+template <std::size_t Modulus>
+std::size_t ParallelModWheelSieve<Modulus>::countPrimesInBlock(std::size_t first, std::size_t last) const {
+    const std::vector<bool>& sieve = this->getSieve();
+    return static_cast<std::size_t>(std::count(sieve.begin() + first, sieve.begin() + last + 1, true));
+}
+
+template <std::size_t Modulus>
+std::string ParallelModWheelSieve<Modulus>::getPerformanceStats() const {
+    if (!this->isGenerated()) {
         return "Sieve not generated yet";
     }
     
     std::ostringstream oss;
-    oss << "Parallel WheelSieve Performance:\n";
-    oss << "  Limit: " << getLimit() << "\n";
+    oss << "Parallel WheelSieve (mod " << Modulus << ") Performance:\n";
+    oss << "  Limit: " << this->getLimit() << "\n";
     oss << "  Threads: " << threadCount << "\n";
     oss << "  Parallel: " << (useParallel ? "Yes" : "No") << "\n";
-    oss << "  Memory Usage: " << getMemoryUsage() << " bytes\n";
+    oss << "  Memory Usage: " << this->getMemoryUsage() << " bytes\n";
+    oss << this->getStats().toText();
     
     return oss.str();
-}
\ No newline at end of file
+}
+
+template <std::size_t Modulus>
+std::string ParallelModWheelSieve<Modulus>::getPerformanceStatsJson() const {
+    std::ostringstream oss;
+    oss << "{\"engine\": \"Parallel WheelSieve\"";
+    oss << ", \"wheel_modulus\": " << Modulus;
+    oss << ", \"limit\": " << this->getLimit();
+    oss << ", \"threads\": " << threadCount;
+    oss << ", \"parallel\": " << (useParallel ? "true" : "false");
+    oss << ", \"generated\": " << (this->isGenerated() ? "true" : "false");
+    oss << ", \"memory_bytes\": " << this->getMemoryUsage();
+    oss << ", \"phases\": " << this->getStats().toJson() << "}";
+    
+    return oss.str();
+}
+
+template class ParallelModWheelSieve<30>;
+template class ParallelModWheelSieve<210>;
+template class ParallelModWheelSieve<2310>;
@@ -0,0 +1,289 @@
+#include "PerfCounters.hpp"
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <omp.h>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+struct EventConfig {
+    const char* name;
+    std::uint32_t type;
+    std::uint64_t config;
+};
+
+constexpr std::uint64_t cacheEvent(std::uint64_t cache, std::uint64_t op, std::uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+const EventConfig EVENTS[PERF_EVENT_COUNT] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"L1d-misses", PERF_TYPE_HW_CACHE,
+     cacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"LLC-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"dTLB-misses", PERF_TYPE_HW_CACHE,
+     cacheEvent(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+int openEvent(const EventConfig& event, int tid) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+}
+
+std::string describeOpenError(int err) {
+    if (err == EACCES || err == EPERM) {
+        std::string paranoid;
+        std::ifstream in("/proc/sys/kernel/perf_event_paranoid");
+        std::getline(in, paranoid);
+        return "not permitted (perf_event_paranoid=" + (paranoid.empty() ? "?" : paranoid) +
+               "; lower it or grant CAP_PERFMON)";
+    }
+    if (err == ENOENT || err == EOPNOTSUPP || err == ENODEV) {
+        return "hardware counters not supported on this CPU or virtual machine";
+    }
+    if (err == ENOSYS) {
+        return "perf_event_open is not available in this kernel";
+    }
+    return std::string("perf_event_open failed: ") + std::strerror(err);
+}
+
+std::string formatCount(const PerfCounterSample& sample, std::size_t index) {
+    return sample.available[index] ? std::to_string(sample.values[index]) : "n/a";
+}
+
+} // namespace
+
+PerfCounterSample& PerfCounterSample::operator+=(const PerfCounterSample& other) {
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        values[i] += other.values[i];
+        available[i] = available[i] || other.available[i];
+    }
+    return *this;
+}
+
+double PerfCounterSample::ipc() const {
+    if (!available[0] || !available[1] || values[0] == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(values[1]) / static_cast<double>(values[0]);
+}
+
+PerfCounterGroup::PerfCounterGroup() {
+    fds.fill(-1);
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+    close();
+}
+
+PerfCounterGroup::PerfCounterGroup(PerfCounterGroup&& other) noexcept
+    : fds(other.fds), error(std::move(other.error)) {
+    other.fds.fill(-1);
+}
+
+PerfCounterGroup& PerfCounterGroup::operator=(PerfCounterGroup&& other) noexcept {
+    if (this != &other) {
+        close();
+        fds = other.fds;
+        error = std::move(other.error);
+        other.fds.fill(-1);
+    }
+    return *this;
+}
+
+bool PerfCounterGroup::open(int tid) {
+    close();
+    error.clear();
+
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        fds[i] = openEvent(EVENTS[i], tid);
+        if (fds[i] < 0 && i == 0) {
+            // Without cycles nothing else is meaningful
+            error = describeOpenError(errno);
+            return false;
+        }
+    }
+    return true;
+}
+
+void PerfCounterGroup::close() {
+    for (int& fd : fds) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+void PerfCounterGroup::start() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void PerfCounterGroup::stop() {
+    for (int fd : fds) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+PerfCounterSample PerfCounterGroup::read() const {
+    PerfCounterSample sample;
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        if (fds[i] < 0) {
+            continue;
+        }
+        std::uint64_t data[3] = {0, 0, 0};  // value, time enabled, time running
+        if (::read(fds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        double value = static_cast<double>(data[0]);
+        if (data[2] > 0 && data[2] < data[1]) {
+            value *= static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+        sample.values[i] = static_cast<std::uint64_t>(value);
+        sample.available[i] = true;
+    }
+    return sample;
+}
+
+const char* PerfCounterGroup::eventName(std::size_t index) {
+    return index < PERF_EVENT_COUNT ? EVENTS[index].name : "unknown";
+}
+
+PerfCounterSample ThreadPerfCounters::Phase::total() const {
+    PerfCounterSample sum;
+    for (const auto& sample : threads) {
+        sum += sample;
+    }
+    return sum;
+}
+
+ThreadPerfCounters::ThreadPerfCounters(int threads) : available(true) {
+    groups.resize(static_cast<std::size_t>(threads > 0 ? threads : 1));
+    std::vector<std::string> errors(groups.size());
+
+    // Attach one counter group to each thread of the team the engines will reuse
+    #pragma omp parallel num_threads(static_cast<int>(groups.size()))
+    {
+        std::size_t t = static_cast<std::size_t>(omp_get_thread_num());
+        if (t < groups.size() && !groups[t].open()) {
+            errors[t] = groups[t].getError();
+        }
+    }
+
+    for (const auto& e : errors) {
+        if (!e.empty()) {
+            available = false;
+            error = e;
+            break;
+        }
+    }
+    if (!available) {
+        groups.clear();
+    }
+}
+
+void ThreadPerfCounters::beginPhase(const std::string& name) {
+    if (!available) return;
+    phases.push_back(Phase{name, {}});
+    for (auto& group : groups) {
+        group.start();
+    }
+}
+
+void ThreadPerfCounters::endPhase() {
+    if (!available || phases.empty()) return;
+    for (auto& group : groups) {
+        group.stop();
+    }
+    auto& phase = phases.back();
+    for (const auto& group : groups) {
+        phase.threads.push_back(group.read());
+    }
+}
+
+std::string ThreadPerfCounters::toText() const {
+    std::ostringstream oss;
+    if (!available) {
+        oss << "Hardware counters unavailable: " << error << "\n";
+        return oss.str();
+    }
+
+    oss << "Hardware counters:\n";
+    oss << std::left << "  " << std::setw(12) << "Phase" << std::setw(8) << "Thread";
+    for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        oss << std::setw(16) << PerfCounterGroup::eventName(i);
+    }
+    oss << std::setw(6) << "IPC" << "\n";
+
+    auto printRow = [&](const std::string& phase, const std::string& thread, const PerfCounterSample& s) {
+        oss << "  " << std::setw(12) << phase << std::setw(8) << thread;
+        for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            oss << std::setw(16) << formatCount(s, i);
+        }
+        oss << std::fixed << std::setprecision(2) << s.ipc() << "\n";
+    };
+
+    for (const auto& phase : phases) {
+        if (phase.threads.size() > 1) {
+            for (std::size_t t = 0; t < phase.threads.size(); ++t) {
+                printRow(phase.name, std::to_string(t), phase.threads[t]);
+            }
+        }
+        printRow(phase.name, "all", phase.total());
+    }
+    return oss.str();
+}
+
+std::string ThreadPerfCounters::toJson() const {
+    std::ostringstream oss;
+    auto writeSample = [&](const PerfCounterSample& s) {
+        oss << "{";
+        for (std::size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            oss << (i == 0 ? "" : ", ") << "\"" << PerfCounterGroup::eventName(i) << "\": ";
+            if (s.available[i]) {
+                oss << s.values[i];
+            } else {
+                oss << "null";
+            }
+        }
+        oss << "}";
+    };
+
+    oss << "[";
+    for (std::size_t p = 0; p < phases.size(); ++p) {
+        const auto& phase = phases[p];
+        oss << (p == 0 ? "" : ", ") << "{\"phase\": \"" << phase.name << "\", \"total\": ";
+        writeSample(phase.total());
+        oss << ", \"threads\": [";
+        for (std::size_t t = 0; t < phase.threads.size(); ++t) {
+            if (t > 0) oss << ", ";
+            writeSample(phase.threads[t]);
+        }
+        oss << "]}";
+    }
+    oss << "]";
+    return oss.str();
+}
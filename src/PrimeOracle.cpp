@@ -0,0 +1,89 @@
+#include "PrimeOracle.hpp"
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+// pi(10^k) for k = 0..19 (OEIS A006880)
+const std::uint64_t PI_POWERS_OF_TEN[] = {
+    0ULL, 4ULL, 25ULL, 168ULL, 1229ULL, 9592ULL, 78498ULL, 664579ULL, 5761455ULL,
+    50847534ULL, 455052511ULL, 4118054813ULL, 37607912018ULL, 346065536839ULL,
+    3204941750802ULL, 29844570422669ULL, 279238341033925ULL, 2623557157654233ULL,
+    24739954287740860ULL, 234057667276344607ULL,
+};
+
+// pi(2^k) for k = 0..40 (OEIS A007053)
+const std::uint64_t PI_POWERS_OF_TWO[] = {
+    0ULL, 1ULL, 2ULL, 4ULL, 6ULL, 11ULL, 18ULL, 31ULL, 54ULL, 97ULL, 172ULL,
+    309ULL, 564ULL, 1028ULL, 1900ULL, 3512ULL, 6542ULL, 12251ULL, 23000ULL,
+    43390ULL, 82025ULL, 155611ULL, 295947ULL, 564163ULL, 1077871ULL, 2063689ULL,
+    3957809ULL, 7603553ULL, 14630843ULL, 28192750ULL, 54400028ULL, 105097565ULL,
+    203280221ULL, 393615806ULL, 762939111ULL, 1480206279ULL, 2874398515ULL,
+    5586502348ULL, 10866266172ULL, 21151907950ULL, 41203088796ULL,
+};
+
+constexpr std::size_t TEN_COUNT = sizeof(PI_POWERS_OF_TEN) / sizeof(PI_POWERS_OF_TEN[0]);
+constexpr std::size_t TWO_COUNT = sizeof(PI_POWERS_OF_TWO) / sizeof(PI_POWERS_OF_TWO[0]);
+
+// Exponent k with base^k == limit, or -1
+int exactPower(std::uint64_t limit, std::uint64_t base, std::size_t maxExponent) {
+    std::uint64_t value = 1;
+    for (std::size_t k = 0; k < maxExponent; ++k) {
+        if (value == limit) {
+            return static_cast<int>(k);
+        }
+        if (value > limit / base) {
+            break;
+        }
+        value *= base;
+    }
+    return -1;
+}
+
+} // namespace
+
+std::string PrimeDigest::toString() const {
+    std::ostringstream oss;
+    oss << count << " primes, hash 0x" << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return oss.str();
+}
+
+std::optional<std::size_t> PrimeOracle::knownPrimeCount(std::size_t limit) {
+    int k = exactPower(limit, 10, TEN_COUNT);
+    if (k >= 0) {
+        return static_cast<std::size_t>(PI_POWERS_OF_TEN[k]);
+    }
+    k = exactPower(limit, 2, TWO_COUNT);
+    if (k >= 0) {
+        return static_cast<std::size_t>(PI_POWERS_OF_TWO[k]);
+    }
+    return std::nullopt;
+}
+
+std::string PrimeOracle::describeLimit(std::size_t limit) {
+    int k = exactPower(limit, 10, TEN_COUNT);
+    if (k >= 0) {
+        return "10^" + std::to_string(k);
+    }
+    k = exactPower(limit, 2, TWO_COUNT);
+    if (k >= 0) {
+        return "2^" + std::to_string(k);
+    }
+    return std::to_string(limit);
+}
+
+bool PrimeOracle::checkCount(std::size_t limit, std::size_t count, std::string& message) {
+    std::optional<std::size_t> expected = knownPrimeCount(limit);
+    if (!expected) {
+        message = "pi(" + std::to_string(limit) + ") is not tabulated (use a power of 10 or 2)";
+        return true;
+    }
+    std::string pi = "pi(" + describeLimit(limit) + ")";
+    if (*expected != count) {
+        message = pi + " should be " + std::to_string(*expected) + " but the engine found " +
+                  std::to_string(count);
+        return false;
+    }
+    message = pi + " = " + std::to_string(count) + " matches the table";
+    return true;
+}
@@ -0,0 +1,109 @@
+#include "ProgressReporter.hpp"
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+std::string formatDuration(double seconds) {
+    long total = static_cast<long>(seconds + 0.5);
+    std::ostringstream oss;
+    oss << std::setfill('0') << std::setw(2) << total / 3600 << ":"
+        << std::setw(2) << (total / 60) % 60 << ":" << std::setw(2) << total % 60;
+    return oss.str();
+}
+
+} // namespace
+
+ProgressReporter::ProgressReporter(Callback callback, std::chrono::milliseconds interval)
+    : callback(std::move(callback)),
+      interval(interval.count() > 0 ? interval : std::chrono::milliseconds(1)) {
+}
+
+ProgressReporter::~ProgressReporter() {
+    if (sampler.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        sampler.join();
+    }
+}
+
+void ProgressReporter::begin(std::size_t start, std::size_t end, int threads, std::size_t primesBelowStart) {
+    finish();
+
+    slots = std::vector<Slot>(static_cast<std::size_t>(threads > 0 ? threads : 1));
+    rangeStart = start;
+    total = end >= start ? end - start + 1 : 0;
+    initialPrimes = primesBelowStart;
+    startTime = std::chrono::steady_clock::now();
+    stopping = false;
+    sampler = std::thread(&ProgressReporter::samplerLoop, this);
+}
+
+void ProgressReporter::samplerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!cv.wait_for(lock, interval, [this] { return stopping; })) {
+        lock.unlock();
+        if (callback) {
+            callback(sample());
+        }
+        lock.lock();
+    }
+}
+
+void ProgressReporter::finish() {
+    if (!sampler.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    sampler.join();
+
+    if (callback) {
+        ProgressInfo info = sample();
+        info.finished = true;
+        callback(info);
+    }
+}
+
+ProgressInfo ProgressReporter::sample() const {
+    ProgressInfo info;
+    info.total = total;
+    info.primesFound = initialPrimes;
+    for (const auto& slot : slots) {
+        info.completed += slot.integers.load(std::memory_order_relaxed);
+        info.primesFound += slot.primes.load(std::memory_order_relaxed);
+    }
+    info.current = info.completed > 0 ? rangeStart + info.completed - 1 : rangeStart;
+    info.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    if (info.elapsedSeconds > 0.0) {
+        info.integersPerSecond = static_cast<double>(info.completed) / info.elapsedSeconds;
+    }
+    if (info.integersPerSecond > 0.0) {
+        info.etaSeconds = static_cast<double>(info.total - info.completed) / info.integersPerSecond;
+    }
+    return info;
+}
+
+ProgressReporter::Callback ProgressReporter::stderrPrinter() {
+    return [](const ProgressInfo& info) {
+        std::ostringstream oss;
+        oss << "\r[" << std::fixed << std::setprecision(1) << std::setw(5) << info.fraction() * 100.0 << "%]"
+            << " at " << info.current
+            << ", primes " << info.primesFound
+            << ", " << std::scientific << std::setprecision(2) << info.integersPerSecond << " int/s"
+            << ", " << (info.finished ? "elapsed " + formatDuration(info.elapsedSeconds)
+                                      : "ETA " + formatDuration(info.etaSeconds))
+            << "   ";
+        if (info.finished) {
+            oss << "\n";
+        }
+        std::cerr << oss.str() << std::flush;
+    };
+}
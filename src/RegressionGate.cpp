@@ -0,0 +1,261 @@
+#include "RegressionGate.hpp"
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <sys/stat.h>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+double median(std::vector<double> values) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    std::size_t n = values.size();
+    return n % 2 == 1 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+/**
+ * @brief Integers per second of each repetition for one metric.
+ */
+std::vector<double> throughputSamples(const EngineResult& r, const std::string& metric) {
+    std::vector<double> rates;
+    for (const auto& sample : r.samples) {
+        double ms = metric == "generate" ? sample.generate : sample.total();
+        if (ms > 0.0) {
+            rates.push_back(static_cast<double>(r.limit + 1) / (ms / 1000.0));
+        }
+    }
+    return rates;
+}
+
+std::string formatQuantity(double value, const std::string& metric) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(2);
+    if (metric == "memory" || metric == "heap") {
+        oss << value / (1024.0 * 1024.0) << " MiB";
+    } else {
+        oss << value / 1e6 << " M/s";
+    }
+    return oss.str();
+}
+
+bool sameConfiguration(const EngineResult& a, const EngineResult& b) {
+    return a.engine == b.engine && a.variant == b.variant && a.limit == b.limit && a.threads == b.threads;
+}
+
+} // namespace
+
+const char* MetricDiff::verdictName(Verdict verdict) {
+    switch (verdict) {
+        case Verdict::Ok: return "ok";
+        case Verdict::Noise: return "noise";
+        case Verdict::Improvement: return "improved";
+        case Verdict::Regression: return "REGRESSION";
+        case Verdict::New: return "new";
+    }
+    return "";
+}
+
+bool Baseline::load(const std::string& filename, Baseline& baseline, std::string& error) {
+    namespace pt = boost::property_tree;
+    pt::ptree root;
+    try {
+        pt::read_json(filename, root);
+        baseline.label = root.get<std::string>("label", "");
+        baseline.hostClass = root.get<std::string>("host.host_class", "");
+        baseline.revision = root.get<std::string>("host.revision", "");
+        baseline.results.clear();
+        for (const auto& entry : root.get_child("results")) {
+            const pt::ptree& node = entry.second;
+            EngineResult r;
+            r.engine = node.get<std::string>("engine");
+            r.variant = node.get<std::string>("variant");
+            r.limit = node.get<std::size_t>("limit");
+            r.threads = node.get<int>("threads");
+            r.memoryBytes = node.get<std::size_t>("memory_bytes");
+            r.peakHeapBytes = node.get<std::size_t>("peak_heap_bytes", 0);
+            r.primeCount = node.get<std::size_t>("prime_count");
+            for (const auto& row : node.get_child("samples_ms")) {
+                std::vector<double> phases;
+                for (const auto& value : row.second) {
+                    phases.push_back(value.second.get_value<double>());
+                }
+                if (phases.size() != 3) {
+                    throw std::runtime_error("samples_ms rows must have 3 phases");
+                }
+                r.samples.push_back(PhaseSample{phases[0], phases[1], phases[2]});
+            }
+            baseline.results.push_back(std::move(r));
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    return true;
+}
+
+double RegressionGate::mannWhitneyGreater(const std::vector<double>& a, const std::vector<double>& b) {
+    std::size_t na = a.size();
+    std::size_t nb = b.size();
+    if (na == 0 || nb == 0) return 1.0;
+
+    // Rank the pooled samples, giving ties their average rank
+    std::vector<std::pair<double, bool>> pooled;  // value, is from b
+    for (double v : a) pooled.emplace_back(v, false);
+    for (double v : b) pooled.emplace_back(v, true);
+    std::sort(pooled.begin(), pooled.end());
+
+    std::size_t n = pooled.size();
+    double rankSumB = 0.0;
+    double tieTerm = 0.0;
+    for (std::size_t i = 0; i < n;) {
+        std::size_t j = i;
+        while (j < n && pooled[j].first == pooled[i].first) ++j;
+        double rank = (i + 1 + j) / 2.0;  // Average of ranks i+1 .. j
+        for (std::size_t k = i; k < j; ++k) {
+            if (pooled[k].second) rankSumB += rank;
+        }
+        double t = static_cast<double>(j - i);
+        tieTerm += t * t * t - t;
+        i = j;
+    }
+
+    double uB = rankSumB - nb * (nb + 1) / 2.0;
+    double mean = na * nb / 2.0;
+    double variance = na * nb / 12.0 * ((n + 1) - tieTerm / (static_cast<double>(n) * (n - 1)));
+    if (variance <= 0.0) return 1.0;
+    double z = (uB - mean - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+void RegressionGate::compareThroughput(const EngineResult& base, const EngineResult& current,
+                                       const std::string& metric, std::vector<MetricDiff>& diffs) const {
+    std::vector<double> before = throughputSamples(base, metric);
+    std::vector<double> after = throughputSamples(current, metric);
+
+    MetricDiff diff;
+    diff.engine = current.engine;
+    diff.variant = current.variant;
+    diff.limit = current.limit;
+    diff.threads = current.threads;
+    diff.metric = metric;
+    diff.baseline = median(before);
+    diff.current = median(after);
+    diff.change = diff.baseline > 0.0 ? diff.current / diff.baseline - 1.0 : 0.0;
+
+    if (diff.change < 0.0) {
+        diff.pValue = mannWhitneyGreater(after, before);
+    } else {
+        diff.pValue = mannWhitneyGreater(before, after);
+    }
+    bool significant = diff.pValue < config.alpha;
+    if (diff.change <= -config.throughputThreshold) {
+        diff.verdict = significant ? MetricDiff::Verdict::Regression : MetricDiff::Verdict::Noise;
+    } else if (diff.change >= config.throughputThreshold) {
+        diff.verdict = significant ? MetricDiff::Verdict::Improvement : MetricDiff::Verdict::Noise;
+    }
+    diffs.push_back(diff);
+}
+
+void RegressionGate::compareMemory(const EngineResult& current, const std::string& metric, std::size_t before,
+                                   std::size_t after, std::vector<MetricDiff>& diffs) const {
+    MetricDiff diff;
+    diff.engine = current.engine;
+    diff.variant = current.variant;
+    diff.limit = current.limit;
+    diff.threads = current.threads;
+    diff.metric = metric;
+    diff.baseline = static_cast<double>(before);
+    diff.current = static_cast<double>(after);
+    diff.change = diff.baseline > 0.0 ? diff.current / diff.baseline - 1.0 : 0.0;
+    if (diff.change > config.memoryThreshold) {
+        diff.verdict = MetricDiff::Verdict::Regression;
+    } else if (diff.change < -config.memoryThreshold) {
+        diff.verdict = MetricDiff::Verdict::Improvement;
+    }
+    diffs.push_back(diff);
+}
+
+std::vector<MetricDiff> RegressionGate::compare(const std::vector<EngineResult>& baseline,
+                                                const std::vector<EngineResult>& current) const {
+    std::vector<MetricDiff> diffs;
+    for (const auto& r : current) {
+        auto base = std::find_if(baseline.begin(), baseline.end(),
+                                 [&](const EngineResult& b) { return sameConfiguration(b, r); });
+        if (base == baseline.end()) {
+            MetricDiff diff;
+            diff.engine = r.engine;
+            diff.variant = r.variant;
+            diff.limit = r.limit;
+            diff.threads = r.threads;
+            diff.metric = "total";
+            diff.current = median(throughputSamples(r, "total"));
+            diff.verdict = MetricDiff::Verdict::New;
+            diffs.push_back(diff);
+            continue;
+        }
+
+        compareThroughput(*base, r, "generate", diffs);
+        compareThroughput(*base, r, "total", diffs);
+
+        compareMemory(r, "memory", base->memoryBytes, r.memoryBytes, diffs);
+        if (base->peakHeapBytes > 0 && r.peakHeapBytes > 0) {
+            compareMemory(r, "heap", base->peakHeapBytes, r.peakHeapBytes, diffs);
+        }
+    }
+    return diffs;
+}
+
+bool RegressionGate::hasRegressions(const std::vector<MetricDiff>& diffs) {
+    return std::any_of(diffs.begin(), diffs.end(),
+                       [](const MetricDiff& d) { return d.verdict == MetricDiff::Verdict::Regression; });
+}
+
+void RegressionGate::writeTable(std::ostream& os, const std::vector<MetricDiff>& diffs) const {
+    os << "\nComparison with baseline (throughput -" << config.throughputThreshold * 100.0
+       << "% / memory +" << config.memoryThreshold * 100.0 << "% at alpha " << config.alpha << "):\n";
+    os << std::left
+       << std::setw(16) << "Algorithm"
+       << std::setw(12) << "Variant"
+       << std::setw(9) << "Threads"
+       << std::setw(14) << "Limit"
+       << std::setw(10) << "Metric"
+       << std::setw(14) << "Baseline"
+       << std::setw(14) << "Current"
+       << std::setw(10) << "Change"
+       << std::setw(10) << "p"
+       << "Verdict\n";
+    os << std::string(119, '-') << "\n";
+
+    for (const auto& d : diffs) {
+        std::ostringstream change;
+        std::ostringstream p;
+        if (d.verdict != MetricDiff::Verdict::New) {
+            change << std::showpos << std::fixed << std::setprecision(1) << d.change * 100.0 << "%";
+            if (d.metric != "memory" && d.metric != "heap") {
+                p << std::setprecision(2) << d.pValue;
+            }
+        }
+        os << std::left
+           << std::setw(16) << d.engine
+           << std::setw(12) << d.variant
+           << std::setw(9) << d.threads
+           << std::setw(14) << d.limit
+           << std::setw(10) << d.metric
+           << std::setw(14) << (d.verdict == MetricDiff::Verdict::New ? "-" : formatQuantity(d.baseline, d.metric))
+           << std::setw(14) << formatQuantity(d.current, d.metric)
+           << std::setw(10) << change.str()
+           << std::setw(10) << p.str()
+           << MetricDiff::verdictName(d.verdict) << "\n";
+    }
+}
+
+std::string RegressionGate::baselineFile(const std::string& path, const HostInfo& host) {
+    struct stat info;
+    if (stat(path.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+        return path + "/" + host.hostClass() + ".json";
+    }
+    return path;
+}
@@ -0,0 +1,99 @@
+#include "SegmentPipeline.hpp"
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <limits>
+
+std::size_t FinishedSegment::count() const {
+    std::size_t primes = 0;
+    forEachPrime([&](std::size_t) { ++primes; });
+    return primes;
+}
+
+SegmentPipeline::SegmentPipeline(std::size_t capacity, int producers, Consumer consumer)
+    : slots(std::max<std::size_t>(capacity, 1)), consumer(std::move(consumer)),
+      total(std::numeric_limits<std::size_t>::max()) {
+    // Never more announcements in flight than slots, so the ring cannot fill up
+    if (producers <= 1) {
+        spsc = std::make_unique<SpscRing<std::size_t>>(slots.size());
+    } else {
+        mpsc = std::make_unique<MpscRing<std::size_t>>(slots.size());
+    }
+    consumerThread = std::thread(&SegmentPipeline::consumerLoop, this);
+}
+
+SegmentPipeline::~SegmentPipeline() {
+    if (consumerThread.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        consumerThread.join();
+    }
+}
+
+FinishedSegment* SegmentPipeline::acquire(std::size_t sequence) {
+    if (sequence >= consumed.load(std::memory_order_acquire) + slots.size()) {
+        producerStalls.fetch_add(1, std::memory_order_relaxed);
+        TraceScope trace("backpressure", "pipeline", "sequence", sequence);
+        while (sequence >= consumed.load(std::memory_order_acquire) + slots.size()) {
+            // The segments the consumer waits for may never come
+            if (cancelled.load(std::memory_order_acquire)) return nullptr;
+            std::this_thread::yield();
+        }
+    }
+    if (cancelled.load(std::memory_order_acquire)) return nullptr;
+    return &slots[sequence % slots.size()];
+}
+
+void SegmentPipeline::publish(std::size_t sequence) {
+    while (spsc ? !spsc->tryPush(sequence) : !mpsc->tryPush(sequence)) {
+        std::this_thread::yield();
+    }
+}
+
+void SegmentPipeline::finish(std::size_t segments) {
+    total.store(segments, std::memory_order_release);
+    if (consumerThread.joinable()) {
+        consumerThread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void SegmentPipeline::cancel() {
+    cancelled.store(true, std::memory_order_release);
+}
+
+void SegmentPipeline::consumerLoop() {
+    std::vector<char> ready(slots.size(), 0);
+    std::size_t next = 0;
+    while (true) {
+        // Collect every announcement, then consume the run that is now in order
+        bool received = false;
+        std::size_t sequence = 0;
+        while (spsc ? spsc->tryPop(sequence) : mpsc->tryPop(sequence)) {
+            ready[sequence % slots.size()] = 1;
+            received = true;
+        }
+
+        while (ready[next % slots.size()] && !cancelled.load(std::memory_order_acquire)) {
+            ready[next % slots.size()] = 0;
+            if (!error) {
+                try {
+                    consumer(slots[next % slots.size()]);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+            ++next;
+            consumed.store(next, std::memory_order_release);
+        }
+
+        if (next >= total.load(std::memory_order_acquire) || stopping.load(std::memory_order_acquire) ||
+            cancelled.load(std::memory_order_acquire)) {
+            break;
+        }
+        if (!received) {
+            consumerWaits.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,232 @@
+#include "SieveJobPool.hpp"
+#include "CpuBudget.hpp"
+#include "ParallelAtkinSieve.hpp"
+#include "ParallelBasicSieve.hpp"
+#include "ParallelBitSieve.hpp"
+#include "ParallelWheelSieve.hpp"
+#include <algorithm>
+#include <atomic>
+
+/**
+ * @struct SieveJobState
+ * @brief A job as shared by its handles and the pool.
+ */
+struct SieveJobState {
+    SieveJobRequest request;
+    SieveJobPool::Callback onComplete;
+    CancellationToken token;
+    std::atomic<JobStatus> status{JobStatus::Queued};
+    std::atomic<bool> detached{false};
+    std::promise<SieveJobResult> promise;
+    std::shared_future<SieveJobResult> result;
+
+    SieveJobState(const SieveJobRequest& request, SieveJobPool::Callback onComplete,
+                  CancellationToken::Clock::time_point deadline)
+        : request(request), onComplete(std::move(onComplete)), token(deadline),
+          result(promise.get_future().share()) {}
+};
+
+namespace {
+
+/**
+ * @brief Run a job's callback, then publish its result, so waiters see the callback's effects.
+ */
+void complete(SieveJobState& job, SieveJobResult result) {
+    job.status.store(result.status);
+    if (job.onComplete) {
+        try {
+            job.onComplete(result);
+        } catch (...) {
+            // A failing callback must not take the worker down
+        }
+    }
+    job.promise.set_value(std::move(result));
+}
+
+/**
+ * @brief Finish a job that never left the queue; a no-op once a worker took it.
+ */
+void cancelQueued(SieveJobState& job) {
+    JobStatus expected = JobStatus::Queued;
+    if (job.status.compare_exchange_strong(expected, JobStatus::Cancelled)) {
+        SieveJobResult result;
+        result.status = JobStatus::Cancelled;
+        complete(job, std::move(result));
+    }
+}
+
+template <typename Sieve>
+void runEngine(const SieveJobState& job, int threads, SieveJobResult& result) {
+    Sieve sieve(job.request.limit, threads);
+    sieve.setCancellationToken(&job.token);
+    sieve.generate();
+    if (job.request.keepPrimes) {
+        result.primes = sieve.getPrimes();
+        result.primeCount = result.primes.size();
+    } else {
+        result.primeCount = sieve.getPrimeCount();
+    }
+}
+
+} // namespace
+
+void SieveJob::cancel() {
+    if (!state) return;
+    state->token.cancel();
+    cancelQueued(*state);
+}
+
+void SieveJob::detach() {
+    if (state) state->detached.store(true);
+}
+
+JobStatus SieveJob::status() const {
+    return state ? state->status.load() : JobStatus::Cancelled;
+}
+
+bool SieveJob::waitFor(std::chrono::steady_clock::duration timeout) const {
+    return shared().result.wait_for(timeout) == std::future_status::ready;
+}
+
+const SieveJobResult& SieveJob::get() const {
+    return shared().result.get();
+}
+
+std::shared_future<SieveJobResult> SieveJob::future() const {
+    return shared().result;
+}
+
+SieveJobState& SieveJob::shared() const {
+    if (!state) {
+        throw std::future_error(std::future_errc::no_state);
+    }
+    return *state;
+}
+
+SieveJobPool::SieveJobPool(int workerCount) {
+    workerCount = std::max(workerCount, 1);
+    defaultThreads = std::max(1, CpuBudget::host().recommendedThreads() / workerCount);
+    for (int i = 0; i < workerCount; ++i) {
+        workers.emplace_back(&SieveJobPool::workerLoop, this);
+    }
+}
+
+SieveJobPool::~SieveJobPool() {
+    std::deque<std::shared_ptr<SieveJobState>> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        shuttingDown = true;
+        abandoned.swap(queue);
+        for (auto& job : running) {
+            job->token.cancel();
+        }
+    }
+    available.notify_all();
+    for (auto& job : abandoned) {
+        cancelQueued(*job);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+SieveJob SieveJobPool::submit(const SieveJobRequest& request, Callback onComplete) {
+    auto deadline = request.timeout > std::chrono::steady_clock::duration::zero()
+                        ? CancellationToken::Clock::now() + request.timeout
+                        : CancellationToken::Clock::time_point::max();
+    auto state = std::make_shared<SieveJobState>(request, std::move(onComplete), deadline);
+
+    SieveJob job;
+    job.state = state;
+    std::weak_ptr<SieveJobState> weak = state;
+    job.interest = std::shared_ptr<void>(state.get(), [weak](void*) {
+        if (auto abandoned = weak.lock()) {
+            if (!abandoned->detached.load()) {
+                abandoned->token.cancel();
+                cancelQueued(*abandoned);
+            }
+        }
+    });
+
+    bool accepted = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!shuttingDown) {
+            queue.push_back(state);
+            accepted = true;
+        }
+    }
+    if (accepted) {
+        available.notify_one();
+    } else {
+        cancelQueued(*state);
+    }
+    return job;
+}
+
+std::size_t SieveJobPool::getQueuedCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
+
+const char* SieveJobPool::statusName(JobStatus status) {
+    switch (status) {
+        case JobStatus::Queued: return "queued";
+        case JobStatus::Running: return "running";
+        case JobStatus::Completed: return "completed";
+        case JobStatus::Cancelled: return "cancelled";
+        case JobStatus::TimedOut: return "timed out";
+        case JobStatus::Failed: return "failed";
+    }
+    return "failed";
+}
+
+void SieveJobPool::workerLoop() {
+    while (true) {
+        std::shared_ptr<SieveJobState> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return shuttingDown || !queue.empty(); });
+            if (queue.empty()) return;
+            job = queue.front();
+            queue.pop_front();
+
+            // Jobs cancelled while queued were already completed by cancel()
+            JobStatus expected = JobStatus::Queued;
+            if (!job->status.compare_exchange_strong(expected, JobStatus::Running)) continue;
+            running.push_back(job);
+        }
+
+        run(*job);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running.erase(std::find(running.begin(), running.end(), job));
+    }
+}
+
+void SieveJobPool::run(SieveJobState& job) {
+    SieveJobResult result;
+    auto start = std::chrono::steady_clock::now();
+    int threads = job.request.threads > 0 ? job.request.threads : getDefaultThreads();
+
+    try {
+        if (job.token.stopRequested()) {
+            throw SieveCancelled(!job.token.isCancelled());
+        }
+        switch (job.request.engine) {
+            case SieveEngine::Basic: runEngine<ParallelBasicSieve>(job, threads, result); break;
+            case SieveEngine::Bit: runEngine<ParallelBitSieve>(job, threads, result); break;
+            case SieveEngine::Wheel: runEngine<ParallelWheelSieve>(job, threads, result); break;
+            case SieveEngine::Atkin: runEngine<ParallelAtkinSieve>(job, threads, result); break;
+        }
+        result.status = JobStatus::Completed;
+    } catch (const SieveCancelled& e) {
+        result.status = e.deadlineExpired() ? JobStatus::TimedOut : JobStatus::Cancelled;
+    } catch (const std::exception& e) {
+        result.status = JobStatus::Failed;
+        result.error = e.what();
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    complete(job, std::move(result));
+}
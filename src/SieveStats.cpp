@@ -0,0 +1,106 @@
+#include "SieveStats.hpp"
+#include "MetricsRegistry.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+const char* SieveStats::tierName(std::size_t tier) {
+    static const char* const names[TIER_COUNT] = {"small", "medium", "large"};
+    return tier < TIER_COUNT ? names[tier] : "unknown";
+}
+
+std::array<std::size_t, SieveStats::TIER_COUNT + 1>
+SieveStats::tierBounds(const std::vector<std::size_t>& primes) const {
+    std::array<std::size_t, TIER_COUNT + 1> bounds{};
+    bounds[0] = 0;
+    bounds[1] = static_cast<std::size_t>(
+        std::lower_bound(primes.begin(), primes.end(), smallPrimeLimit) - primes.begin());
+    bounds[2] = static_cast<std::size_t>(
+        std::lower_bound(primes.begin() + static_cast<std::ptrdiff_t>(bounds[1]), primes.end(),
+                         mediumPrimeLimit) - primes.begin());
+    bounds[3] = primes.size();
+    return bounds;
+}
+
+double SieveStats::sievingSeconds() const {
+    double total = quadraticFormSeconds;
+    for (double seconds : crossOffSeconds) total += seconds;
+    return total;
+}
+
+double SieveStats::totalSeconds() const {
+    return allocationSeconds + presieveSeconds + basePrimesSeconds + sievingSeconds() +
+           extractionSeconds + outputSeconds;
+}
+
+std::size_t SieveStats::totalCrossOffs() const {
+    std::size_t total = toggles;
+    for (std::size_t count : crossOffs) total += count;
+    return total;
+}
+
+void SieveStats::publishMetrics(std::size_t integers) const {
+    static MetricsRegistry& registry = MetricsRegistry::global();
+    static Counter& runs = registry.counter("prime_sieve_runs", "Completed generate() calls");
+    static Counter& sieved = registry.counter("prime_sieve_integers_sieved", "Integers covered by completed sieves");
+    static Counter& crossed = registry.counter("prime_sieve_cross_offs", "Composite markings performed");
+    static Histogram& seconds = registry.histogram("prime_sieve_generate_seconds",
+                                                   "Wall time of generate() (base primes and crossing-off)",
+                                                   Histogram::exponentialBounds(1e-4, 4.0, 12));
+    static Gauge& throughput = registry.gauge("prime_sieve_throughput_integers_per_second",
+                                              "Sieving throughput of the most recent generate()");
+
+    double elapsed = basePrimesSeconds + sievingSeconds();
+    runs.inc();
+    sieved.inc(integers);
+    crossed.inc(totalCrossOffs());
+    seconds.observe(elapsed);
+    if (elapsed > 0.0) {
+        throughput.set(static_cast<double>(integers) / elapsed);
+    }
+}
+
+std::string SieveStats::toText() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "  Phase timings (ms):\n";
+    oss << "    Allocation/init: " << allocationSeconds * 1e3 << "\n";
+    oss << "    Presieve: " << presieveSeconds * 1e3 << "\n";
+    oss << "    Base primes: " << basePrimesSeconds * 1e3 << " (" << basePrimeCount << " primes)\n";
+    if (toggles > 0) {
+        oss << "    Quadratic forms: " << quadraticFormSeconds * 1e3 << " (" << toggles << " toggles)\n";
+    }
+    for (std::size_t tier = 0; tier < TIER_COUNT; ++tier) {
+        oss << "    Cross-off " << tierName(tier) << " primes: " << crossOffSeconds[tier] * 1e3
+            << " (" << crossOffs[tier] << " cross-offs)\n";
+    }
+    oss << "    Extraction: " << extractionSeconds * 1e3 << "\n";
+    oss << "    Output: " << outputSeconds * 1e3 << "\n";
+    oss << "    Total: " << totalSeconds() * 1e3 << "\n";
+    oss << "  Tier limits: small < " << smallPrimeLimit << " <= medium < " << mediumPrimeLimit
+        << " <= large\n";
+    return oss.str();
+}
+
+std::string SieveStats::toJson() const {
+    std::ostringstream oss;
+    oss << std::setprecision(9);
+    oss << "{\"allocation_s\": " << allocationSeconds
+        << ", \"presieve_s\": " << presieveSeconds
+        << ", \"base_primes_s\": " << basePrimesSeconds
+        << ", \"quadratic_forms_s\": " << quadraticFormSeconds;
+    for (std::size_t tier = 0; tier < TIER_COUNT; ++tier) {
+        oss << ", \"" << tierName(tier) << "_primes_s\": " << crossOffSeconds[tier];
+    }
+    oss << ", \"extraction_s\": " << extractionSeconds
+        << ", \"output_s\": " << outputSeconds
+        << ", \"total_s\": " << totalSeconds()
+        << ", \"base_prime_count\": " << basePrimeCount
+        << ", \"toggles\": " << toggles;
+    for (std::size_t tier = 0; tier < TIER_COUNT; ++tier) {
+        oss << ", \"" << tierName(tier) << "_cross_offs\": " << crossOffs[tier];
+    }
+    oss << ", \"small_prime_limit\": " << smallPrimeLimit
+        << ", \"medium_prime_limit\": " << mediumPrimeLimit << "}";
+    return oss.str();
+}
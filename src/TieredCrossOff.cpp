@@ -0,0 +1,151 @@
+#include "TieredCrossOff.hpp"
+#include "TraceRecorder.hpp"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+inline void clearBit(uint64_t* bits, std::size_t index) {
+    bits[index / 64] &= ~(1ULL << (index % 64));
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+TieredCrossOff::TieredCrossOff(const std::vector<std::size_t>& primes, const SieveStats& stats)
+    : state(primes), bounds(stats.tierBounds(primes)) {
+    segmentSize = segmentSizeFor(stats);
+    blockSize = std::min(std::max<std::size_t>(stats.smallPrimeLimit * 16 / 64 * 64, 64), segmentSize);
+
+    std::size_t largest = primes.empty() ? 0 : primes.back();
+    buckets.resize(largest / segmentSize + 2);
+}
+
+void TieredCrossOff::beginRange(std::size_t low, std::size_t high) {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    pending.clear();
+
+    // The only divisions of the range: one per prime
+    state.seed(low);
+
+    // File every large prime under the segment of its first multiple, or
+    // hold it back while that segment is beyond the ring
+    std::size_t large = SieveStats::TIER_COUNT - 1;
+    for (std::size_t k = bounds[large]; k < bounds[large + 1]; ++k) {
+        std::size_t start = state.multiples[k];
+        if (start > high) continue;
+        std::size_t segment = (start - low) / segmentSize;
+        if (segment < buckets.size()) {
+            buckets[segment].push_back({state.primes[k], start});
+        } else {
+            pending.push_back({state.primes[k], start});
+        }
+    }
+    std::sort(pending.begin(), pending.end(),
+              [](const BucketEntry& a, const BucketEntry& b) { return a.multiple > b.multiple; });
+}
+
+void TieredCrossOff::startRange(std::size_t low, std::size_t high) {
+    rangeLow = low;
+    rangeHigh = high;
+    nextSegment = 0;
+    rangeDone = low > high;
+    if (!rangeDone) {
+        beginRange(low, high);
+    }
+}
+
+bool TieredCrossOff::sieveNextSegment(std::vector<uint64_t>& bits, std::size_t& segmentHigh) {
+    if (rangeDone) return false;
+    std::size_t segmentLow = rangeLow + nextSegment * segmentSize;
+    segmentHigh = std::min(rangeHigh, segmentLow + segmentSize - 1);
+    sieveSegment(bits.data(), nextSegment, segmentLow, segmentHigh, rangeLow, rangeHigh);
+    ++nextSegment;
+    rangeDone = segmentHigh == rangeHigh;
+    return true;
+}
+
+void TieredCrossOff::sieveSegment(uint64_t* bits, std::size_t segment, std::size_t low, std::size_t high,
+                                  std::size_t rangeLow, std::size_t rangeHigh) {
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        TraceScope trace(SieveStats::tierName(tier), "sieve", "low", low, "high", high);
+        auto start = std::chrono::steady_clock::now();
+        switch (tier) {
+            case 0: crossOffs[tier] += crossOffSmall(bits, low, high); break;
+            case 1: crossOffs[tier] += crossOffMedium(bits, high); break;
+            default: crossOffs[tier] += crossOffLarge(bits, segment, rangeLow, rangeHigh); break;
+        }
+        seconds[tier] += secondsSince(start);
+    }
+}
+
+std::size_t TieredCrossOff::crossOffSmall(uint64_t* bits, std::size_t low, std::size_t high) {
+    // Every small prime hits a block many times; finish one block before the next
+    std::size_t count = 0;
+    for (std::size_t blockLow = low; blockLow <= high; blockLow += blockSize) {
+        std::size_t blockHigh = std::min(high, blockLow + blockSize - 1);
+        for (std::size_t k = bounds[0]; k < bounds[1]; ++k) {
+            std::size_t p = state.primes[k];
+            std::size_t i = state.multiples[k];
+            for (; i <= blockHigh; i += p) {
+                clearBit(bits, i);
+                ++count;
+            }
+            state.multiples[k] = i;  // First multiple of the next block
+        }
+        if (blockHigh == high) break;
+    }
+    return count;
+}
+
+std::size_t TieredCrossOff::crossOffMedium(uint64_t* bits, std::size_t high) {
+    std::size_t count = 0;
+    for (std::size_t k = bounds[1]; k < bounds[2]; ++k) {
+        std::size_t p = state.primes[k];
+        std::size_t i = state.multiples[k];
+        if (i > high) continue;
+        count += (high - i) / p + 1;
+
+        // Four multiples per iteration, then the remainder
+        for (; i + 3 * p <= high; i += 4 * p) {
+            clearBit(bits, i);
+            clearBit(bits, i + p);
+            clearBit(bits, i + 2 * p);
+            clearBit(bits, i + 3 * p);
+        }
+        for (; i <= high; i += p) {
+            clearBit(bits, i);
+        }
+        state.multiples[k] = i;  // First multiple of the next segment
+    }
+    return count;
+}
+
+std::size_t TieredCrossOff::crossOffLarge(uint64_t* bits, std::size_t segment, std::size_t rangeLow,
+                                          std::size_t rangeHigh) {
+    // Bring in the held-back primes whose segment the ring now reaches
+    while (!pending.empty() && (pending.back().multiple - rangeLow) / segmentSize < segment + buckets.size()) {
+        const BucketEntry& entry = pending.back();
+        buckets[(entry.multiple - rangeLow) / segmentSize % buckets.size()].push_back(entry);
+        pending.pop_back();
+    }
+
+    // A large prime hits a segment at most once, then moves to a later bucket
+    // (at most one prime, so less than a ring, ahead)
+    std::vector<BucketEntry>& bucket = buckets[segment % buckets.size()];
+    std::size_t count = bucket.size();
+    for (const BucketEntry& entry : bucket) {
+        clearBit(bits, entry.multiple);
+        std::size_t next = entry.multiple + entry.prime;
+        if (next <= rangeHigh) {
+            buckets[(next - rangeLow) / segmentSize % buckets.size()].push_back({entry.prime, next});
+        }
+    }
+    bucket.clear();
+    return count;
+}
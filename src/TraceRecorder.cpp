@@ -0,0 +1,152 @@
+#include "TraceRecorder.hpp"
+#include <omp.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+std::atomic<TraceRecorder*> TraceRecorder::activeRecorder{nullptr};
+
+namespace {
+
+std::atomic<std::uint64_t> nextRecorderId{1};
+
+// Buffer the calling thread registered with the recorder identified by id
+struct ThreadSlot {
+    std::uint64_t recorderId = 0;
+    void* buffer = nullptr;
+};
+
+thread_local ThreadSlot threadSlot;
+
+void writeEscaped(std::ostringstream& oss, const char* text) {
+    oss << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            oss << '\\';
+        }
+        oss << *c;
+    }
+    oss << '"';
+}
+
+} // namespace
+
+TraceRecorder::TraceRecorder(std::size_t eventsPerThread)
+    : eventsPerThread(eventsPerThread > 0 ? eventsPerThread : 1),
+      origin(std::chrono::steady_clock::now()),
+      id(nextRecorderId.fetch_add(1, std::memory_order_relaxed)) {
+}
+
+TraceRecorder::~TraceRecorder() {
+    TraceRecorder* self = this;
+    activeRecorder.compare_exchange_strong(self, nullptr);
+}
+
+TraceRecorder::ThreadBuffer& TraceRecorder::threadBuffer() {
+    if (threadSlot.recorderId == id) {
+        return *static_cast<ThreadBuffer*>(threadSlot.buffer);
+    }
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->events.resize(eventsPerThread);
+    buffer->tid = static_cast<std::uint64_t>(syscall(SYS_gettid));
+    if (omp_in_parallel()) {
+        buffer->threadName = "OpenMP thread " + std::to_string(omp_get_thread_num());
+    } else {
+        buffer->threadName = "thread " + std::to_string(buffer->tid);
+    }
+
+    ThreadBuffer* raw = buffer.get();
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        if (threads.empty() && !omp_in_parallel()) {
+            raw->threadName = "main";
+        }
+        threads.push_back(std::move(buffer));
+    }
+    threadSlot.recorderId = id;
+    threadSlot.buffer = raw;
+    return *raw;
+}
+
+void TraceRecorder::record(const TraceEvent& event) {
+    ThreadBuffer& buffer = threadBuffer();
+    buffer.events[buffer.next % buffer.events.size()] = event;
+    ++buffer.next;
+}
+
+std::size_t TraceRecorder::droppedEvents() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::size_t dropped = 0;
+    for (const auto& buffer : threads) {
+        if (buffer->next > buffer->events.size()) {
+            dropped += buffer->next - buffer->events.size();
+        }
+    }
+    return dropped;
+}
+
+std::string TraceRecorder::toJson() {
+    std::size_t dropped = droppedEvents();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    long pid = static_cast<long>(getpid());
+
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "{\"traceEvents\": [\n";
+    bool first = true;
+    auto separator = [&]() {
+        oss << (first ? "  " : ",\n  ");
+        first = false;
+    };
+
+    for (const auto& buffer : threads) {
+        separator();
+        oss << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid
+            << ", \"tid\": " << buffer->tid << ", \"args\": {\"name\": ";
+        writeEscaped(oss, buffer->threadName.c_str());
+        oss << "}}";
+
+        // Oldest surviving event first
+        std::size_t capacity = buffer->events.size();
+        std::size_t count = std::min(buffer->next, capacity);
+        std::size_t begin = buffer->next - count;
+        for (std::size_t i = begin; i < buffer->next; ++i) {
+            const TraceEvent& event = buffer->events[i % capacity];
+            separator();
+            oss << "{\"name\": ";
+            writeEscaped(oss, event.name);
+            oss << ", \"cat\": ";
+            writeEscaped(oss, event.category);
+            oss << ", \"ph\": \"X\", \"ts\": " << static_cast<double>(event.startNs) / 1e3
+                << ", \"dur\": " << static_cast<double>(event.endNs - event.startNs) / 1e3
+                << ", \"pid\": " << pid << ", \"tid\": " << buffer->tid;
+            if (event.argNames[0]) {
+                oss << ", \"args\": {";
+                writeEscaped(oss, event.argNames[0]);
+                oss << ": " << event.argValues[0];
+                if (event.argNames[1]) {
+                    oss << ", ";
+                    writeEscaped(oss, event.argNames[1]);
+                    oss << ": " << event.argValues[1];
+                }
+                oss << "}";
+            }
+            oss << "}";
+        }
+    }
+
+    oss << "\n], \"displayTimeUnit\": \"ns\", \"otherData\": {\"dropped_events\": " << dropped << "}}\n";
+    return oss.str();
+}
+
+bool TraceRecorder::writeJson(const std::string& filename) {
+    std::ofstream out(filename);
+    if (!out) {
+        return false;
+    }
+    out << toJson();
+    return static_cast<bool>(out);
+}
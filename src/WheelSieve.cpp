@@ -1,223 +1,288 @@
 #include "WheelSieve.hpp"
+#include "PrimeTables.hpp"
+#include "TraceRecorder.hpp"
 #include <iostream>
-#include <fstream>
 #include <cmath>
 #include <algorithm>
 
-WheelSieve::WheelSieve(std::size_t n) : limit(n), generated(false) {
-    // Initialize sieve vector with all values set to true
-    sieve.resize(limit + 1, true);
-    
-    // 0 and 1 are not prime numbers
-    if (limit >= 0) sieve[0] = false;
-    if (limit >= 1) sieve[1] = false;
+template <std::size_t Modulus>
+ModWheelSieve<Modulus>::ModWheelSieve(std::size_t n) : limit(n), generated(false) {
+    using Wheel = WheelTable<Modulus>;
+    {
+        ScopedPhaseTimer timer(stats.allocationSeconds);
+        
+        // One entry per number in [0, limit] that is coprime to the modulus,
+        // initialized to true; multiples of the wheel primes are never stored
+        sieve.resize(Wheel::indexOf(limit + 1), true);
+    }
     
-    // Mark multiples of 2, 3, and 5 as non-prime
-    for (std::size_t i = 2; i <= limit; i += 2) sieve[i] = false;
-    for (std::size_t i = 3; i <= limit; i += 3) sieve[i] = false;
-    for (std::size_t i = 5; i <= limit; i += 5) sieve[i] = false;
+    ScopedPhaseTimer timer(stats.presieveSeconds);
     
-    // Mark 2, 3, and 5 as prime (they were marked as non-prime above)
-    if (limit >= 2) sieve[2] = true;
-    if (limit >= 3) sieve[3] = true;
-    if (limit >= 5) sieve[5] = true;
+    // 1 is not a prime number
+    if (!sieve.empty()) sieve[0] = false;
+}
+
+template <std::size_t Modulus>
+std::size_t ModWheelSieve<Modulus>::numToWheelIndex(std::size_t num) const {
+    return WheelTable<Modulus>::indexOf(num);
+}
+
+template <std::size_t Modulus>
+std::size_t ModWheelSieve<Modulus>::wheelIndexToNum(std::size_t index) const {
+    return WheelTable<Modulus>::valueAt(index);
 }
 
-std::size_t WheelSieve::numToWheelIndex(std::size_t num) const {
-    if (num < 7) return 0;
+template <std::size_t Modulus>
+std::size_t ModWheelSieve<Modulus>::getNextWheelNumber(std::size_t current) const {
+    using Wheel = WheelTable<Modulus>;
+    
+    // Handle small numbers: step through the primes the wheel skips
+    for (std::size_t p : Wheel::PRIMES) {
+        if (current < p) return p;
+    }
     
-    // Find the position in the wheel
-    std::size_t remainder = (num - 7) % WHEEL_SIZE;
-    std::size_t quotient = (num - 7) / WHEEL_SIZE;
+    // Otherwise step to the next number coprime to the modulus
+    std::size_t next = Wheel::next(current);
+    return next <= limit ? next : limit + 1; // Value > limit signals the end
+}
+
+namespace {
+
+/**
+ * @brief First multiple of prime at or above low whose cofactor is a wheel number (at least prime).
+ * @param wheelIndex Receives the wheel position of the cofactor.
+ */
+template <std::size_t Modulus>
+std::size_t firstWheelMultiple(std::size_t prime, std::size_t low, std::uint32_t& wheelIndex) {
+    using Wheel = WheelTable<Modulus>;
     
-    return quotient * WHEEL_PRIMES_COUNT + remainder;
+    // Smallest cofactor m >= prime with prime * m >= low, rounded up to a wheel number
+    std::size_t cofactor = std::max(prime, (low + prime - 1) / prime);
+    std::size_t k = Wheel::indexOf(cofactor);
+    wheelIndex = static_cast<std::uint32_t>(k % Wheel::COUNT);
+    return prime * Wheel::valueAt(k);
 }
 
-std::size_t WheelSieve::wheelIndexToNum(std::size_t index) const {
-    if (index < WHEEL_PRIMES_COUNT) {
-        return WHEEL_PRIMES[index];
+} // namespace
+
+template <std::size_t Modulus>
+std::size_t ModWheelSieve<Modulus>::crossOffMultiples(std::size_t prime, std::size_t low, std::size_t high) {
+    std::uint32_t wheelIndex = 0;
+    std::size_t multiple = firstWheelMultiple<Modulus>(prime, low, wheelIndex);
+    return crossOffFrom(prime, multiple, wheelIndex, high);
+}
+
+template <std::size_t Modulus>
+void ModWheelSieve<Modulus>::seedMultiples(SievingPrimes& state, std::size_t low) {
+    state.wheelIndices.resize(state.size());
+    for (std::size_t k = 0; k < state.size(); ++k) {
+        state.multiples[k] = firstWheelMultiple<Modulus>(state.primes[k], low, state.wheelIndices[k]);
     }
+}
+
+template <std::size_t Modulus>
+std::size_t ModWheelSieve<Modulus>::crossOffFrom(std::size_t prime, std::size_t& multiple,
+                                                 std::uint32_t& wheelIndex, std::size_t high) {
+    using Wheel = WheelTable<Modulus>;
     
-    std::size_t quotient = index / WHEEL_PRIMES_COUNT;
-    std::size_t remainder = index % WHEEL_PRIMES_COUNT;
-    
-    return 7 + quotient * WHEEL_SIZE + (WHEEL_PRIMES[remainder] - 7);
+    std::size_t crossOffs = 0;
+    std::size_t k = wheelIndex;
+    std::size_t i = multiple;
+    while (i <= high) {
+        sieve[Wheel::indexOf(i)] = false;
+        ++crossOffs;
+        i += prime * Wheel::STEPS[k];
+        if (++k == Wheel::COUNT) k = 0;
+    }
+    multiple = i;
+    wheelIndex = static_cast<std::uint32_t>(k);
+    return crossOffs;
 }
 
-std::size_t WheelSieve::getNextWheelNumber(std::size_t current) const {
-    if (current < 7) {
-        // Handle small numbers
-        if (current < 2) return 2;
-        if (current == 2) return 3;
-        if (current == 3) return 5;
-        if (current == 5) return 7;
+template <std::size_t Modulus>
+std::vector<std::size_t> ModWheelSieve<Modulus>::findBasePrimes(std::size_t sqrtLimit) {
+    using Wheel = WheelTable<Modulus>;
+    ScopedPhaseTimer timer(stats.basePrimesSeconds);
+    TraceScope trace("base primes", "sieve", "sqrt_limit", sqrtLimit);
+    std::vector<std::size_t> basePrimes;
+    std::size_t end = Wheel::indexOf(sqrtLimit + 1);  // Wheel numbers in [0, sqrtLimit]
+    
+    if (sqrtLimit < PrimeTables::SMALL_LIMIT) {
+        // Copy the wheel numbers in [2, sqrtLimit] from the compile-time table
+        for (std::size_t i = 1; i < end; ++i) {
+            sieve[i] = PrimeTables::isSmallPrime(Wheel::valueAt(i));
+        }
+        std::size_t count = PrimeTables::countUpTo(sqrtLimit);
+        if (count > Wheel::PRIME_COUNT) {
+            basePrimes.assign(PrimeTables::PRIMES.begin() + Wheel::PRIME_COUNT,
+                              PrimeTables::PRIMES.begin() + count);
+        }
+        stats.basePrimeCount = basePrimes.size();
+        return basePrimes;
     }
     
-    // For numbers >= 7, use the wheel to find the next number
-    // that is not divisible by 2, 3, or 5
-    std::size_t next = current + 1;
-    while (next <= limit) {
-        if (next % 2 != 0 && next % 3 != 0 && next % 5 != 0) {
-            return next;
+    // Sieve up to sqrt(limit), starting with the first prime on the wheel
+    for (std::size_t i = 1; i < end; ++i) {
+        if (sieve[i]) {
+            std::size_t p = Wheel::valueAt(i);
+            basePrimes.push_back(p);
+            crossOffMultiples(p, p * p, sqrtLimit);
         }
-        next++;
     }
     
-    return limit + 1; // Return value > limit to signal end
+    stats.basePrimeCount = basePrimes.size();
+    return basePrimes;
 }
 
-void WheelSieve::generate() {
+template <std::size_t Modulus>
+void ModWheelSieve<Modulus>::generate() {
     if (generated) return; // Already generated
     
-    // Start with the first prime in the wheel (7)
-    std::size_t p = 7;
-    
-    while (p * p <= limit) {
-        // If p is prime
-        if (sieve[p]) {
-            // Mark all multiples of p as non-prime
-            // Start from p*p as smaller multiples have already been marked
-            std::size_t multiple = p * p;
-            
-            while (multiple <= limit) {
-                sieve[multiple] = false;
-                // Simple approach: just add p to get the next multiple
-                multiple += p;
-            }
+    std::size_t sqrtLimit = static_cast<std::size_t>(std::sqrt(limit));
+    std::vector<std::size_t> basePrimes = findBasePrimes(sqrtLimit);
+    
+    // Cross off the multiples above sqrt(limit), one prime tier at a time
+    auto bounds = stats.tierBounds(basePrimes);
+    for (std::size_t tier = 0; tier < SieveStats::TIER_COUNT; ++tier) {
+        ScopedPhaseTimer timer(stats.crossOffSeconds[tier]);
+        TraceScope trace(SieveStats::tierName(tier), "sieve");
+        std::size_t crossOffs = 0;
+        for (std::size_t k = bounds[tier]; k < bounds[tier + 1]; ++k) {
+            // Start from p*p, or the first multiple the base sieve did not reach
+            crossOffs += crossOffMultiples(basePrimes[k], sqrtLimit + 1, limit);
         }
-        
-        // Move to the next potential prime using the wheel
-        p = getNextWheelNumber(p);
+        stats.crossOffs[tier] = crossOffs;
     }
     
+    stats.publishMetrics(limit + 1);
     generated = true;
 }
 
-std::vector<std::size_t> WheelSieve::getPrimes() {
+template <std::size_t Modulus>
+template <typename Visitor>
+void ModWheelSieve<Modulus>::forEachPrime(Visitor visit) const {
+    using Wheel = WheelTable<Modulus>;
+    
+    // The primes the wheel skips are never stored
+    for (std::size_t p : Wheel::PRIMES) {
+        if (p <= limit) visit(p);
+    }
+    
+    // Walk the stored wheel numbers one turn of the wheel at a time
+    std::size_t base = 0;
+    for (std::size_t i = 0; i < sieve.size(); i += Wheel::COUNT, base += Modulus) {
+        std::size_t turnEnd = std::min(sieve.size(), i + Wheel::COUNT);
+        for (std::size_t j = i; j < turnEnd; ++j) {
+            if (sieve[j]) {
+                visit(base + Wheel::RESIDUES[j - i]);
+            }
+        }
+    }
+}
+
+template <std::size_t Modulus>
+std::vector<std::size_t> ModWheelSieve<Modulus>::getPrimes() {
     if (!generated) {
         generate();
     }
     
+    ScopedPhaseTimer timer(stats.extractionSeconds);
     std::vector<std::size_t> primes;
     primes.reserve(limit / 10); // Estimate: approximately 1/10 of numbers are prime
-    
-    // Always include 2, 3, and 5
-    if (limit >= 2) primes.push_back(2);
-    if (limit >= 3) primes.push_back(3);
-    if (limit >= 5) primes.push_back(5);
-    
-    // Add primes from the wheel
-    for (std::size_t i = 7; i <= limit; i = getNextWheelNumber(i)) {
-        if (sieve[i]) {
-            primes.push_back(i);
-        }
-    }
-    
+    forEachPrime([&](std::size_t p) { primes.push_back(p); });
     return primes;
 }
 
-bool WheelSieve::isPrime(std::size_t num) {
+template <std::size_t Modulus>
+bool ModWheelSieve<Modulus>::isPrime(std::size_t num) {
+    using Wheel = WheelTable<Modulus>;
     if (num > limit) {
         throw std::invalid_argument("Number exceeds sieve limit");
     }
     
+    if (!generated && num < PrimeTables::SMALL_LIMIT) {
+        return PrimeTables::isSmallPrime(num);  // Answer small queries without sieving
+    }
+    
+    if (!Wheel::isWheelNumber(num)) {
+        // Off the wheel: prime only if it is one of the primes dividing the modulus
+        return std::find(Wheel::PRIMES.begin(), Wheel::PRIMES.end(), num) != Wheel::PRIMES.end();
+    }
+    
     if (!generated) {
         generate();
     }
     
-    return sieve[num];
+    return sieve[Wheel::indexOf(num)];
 }
 
-std::size_t WheelSieve::getPrimeCount() {
+template <std::size_t Modulus>
+std::size_t ModWheelSieve<Modulus>::getPrimeCount() {
     if (!generated) {
         generate();
     }
     
+    ScopedPhaseTimer timer(stats.extractionSeconds);
     std::size_t count = 0;
-    
-    // Count 2, 3, and 5 if within limit
-    if (limit >= 2) ++count;
-    if (limit >= 3) ++count;
-    if (limit >= 5) ++count;
-    
-    // Count primes from the wheel
-    for (std::size_t i = 7; i <= limit; i = getNextWheelNumber(i)) {
-        if (sieve[i]) {
-            ++count;
-        }
+    for (std::size_t p : WheelTable<Modulus>::PRIMES) {
+        if (p <= limit) ++count;
     }
     
+    // Every remaining entry is a prime on the wheel
+    count += static_cast<std::size_t>(std::count(sieve.begin(), sieve.end(), true));
     return count;
 }
 
-std::size_t WheelSieve::getMemoryUsage() const {
-    return sieve.size() * sizeof(bool);
+template <std::size_t Modulus>
+std::size_t ModWheelSieve<Modulus>::getMemoryUsage() const {
+    return (sieve.size() + 7) / 8;  // std::vector<bool> packs one entry per bit
 }
 
-void WheelSieve::printPrimes(std::size_t perLine) const {
+template <std::size_t Modulus>
+void ModWheelSieve<Modulus>::printPrimes(std::size_t perLine) const {
     if (!generated) {
         throw std::runtime_error("Sieve has not been generated yet");
     }
     
+    ScopedPhaseTimer timer(stats.outputSeconds);
     std::size_t count = 0;
-    
-    // Print 2, 3, and 5 if within limit
-    if (limit >= 2) {
-        std::cout << 2;
-        if (++count % perLine == 0) std::cout << std::endl;
-        else std::cout << " ";
-    }
-    if (limit >= 3) {
-        std::cout << 3;
-        if (++count % perLine == 0) std::cout << std::endl;
-        else std::cout << " ";
-    }
-    if (limit >= 5) {
-        std::cout << 5;
-        if (++count % perLine == 0) std::cout << std::endl;
-        else std::cout << " ";
-    }
-    
-    // Print primes from the wheel
-    for (std::size_t i = 7; i <= limit; i = getNextWheelNumber(i)) {
-        if (sieve[i]) {
-            std::cout << i;
-            if (++count % perLine == 0) {
-                std::cout << std::endl;
-            } else {
-                std::cout << " ";
-            }
+    forEachPrime([&](std::size_t p) {
+        std::cout << p;
+        if (++count % perLine == 0) {
+            std::cout << '\n';
+        } else {
+            std::cout << " ";
         }
-    }
+    });
     
     // Add newline if the last line wasn't complete
     if (count % perLine != 0) {
-        std::cout << std::endl;
+        std::cout << '\n';
     }
+    std::cout.flush();
 }
 
-bool WheelSieve::savePrimesToFile(const std::string& filename) const {
+template <std::size_t Modulus>
+bool ModWheelSieve<Modulus>::savePrimesToFile(const std::string& filename, OutputStats* outputStats) const {
     if (!generated) {
         throw std::runtime_error("Sieve has not been generated yet");
     }
     
-    std::ofstream outFile(filename);
-    if (!outFile) {
+    ScopedPhaseTimer timer(stats.outputSeconds);
+    AsyncPrimeWriter writer;
+    if (!writer.open(filename)) {
         return false;
     }
     
-    // Save 2, 3, and 5 if within limit
-    if (limit >= 2) outFile << 2 << "\n";
-    if (limit >= 3) outFile << 3 << "\n";
-    if (limit >= 5) outFile << 5 << "\n";
+    forEachPrime([&](std::size_t p) { writer.write(p); });
     
-    // Save primes from the wheel
-    for (std::size_t i = 7; i <= limit; i = getNextWheelNumber(i)) {
-        if (sieve[i]) {
-            outFile << i << "\n";
-        }
+    bool ok = writer.close();
+    if (outputStats) {
+        *outputStats = writer.getStats();
     }
-    
-    outFile.close();
-    return true;
-}
\ No newline at end of file
+    return ok;
+}
+
+template class ModWheelSieve<30>;
+template class ModWheelSieve<210>;
+template class ModWheelSieve<2310>;
@@ -1,122 +1,296 @@
 #include "BasicSieve.hpp"
 #include "BitSieve.hpp"
 #include "WheelSieve.hpp"
+#include "AtkinSieve.hpp"
 #include "ParallelBasicSieve.hpp"
 #include "ParallelBitSieve.hpp"
 #include "ParallelWheelSieve.hpp"
-#include <chrono>
+#include "ParallelAtkinSieve.hpp"
+#include "BenchmarkHarness.hpp"
+#include "CpuTopology.hpp"
+#include "RegressionGate.hpp"
+#include <algorithm>
+#include <fstream>
+#include <functional>
 #include <iostream>
-#include <iomanip>
+#include <map>
+#include <memory>
+#include <set>
 #include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
 
 /**
- * @struct BenchmarkResult
- * @brief Structure to hold benchmark results for comparison.
+ * @struct EngineSpec
+ * @brief Runs one engine's sequential and parallel variants through the harness.
  */
-struct BenchmarkResult {
-    std::size_t limit;
-    std::string algorithm;
-    int threadCount;
-    double sequentialTime;
-    double parallelTime;
-    double speedup;
-    std::size_t memoryUsage;
-
-    BenchmarkResult(std::size_t lim, const std::string &algo, int threads,
-                    double seqTime, double parTime, std::size_t mem)
-        : limit(lim), algorithm(algo), threadCount(threads),
-          sequentialTime(seqTime), parallelTime(parTime), speedup(parTime > 0 ? seqTime / parTime : 0.0),
-          memoryUsage(mem) {}
+struct EngineSpec {
+    std::string name;
+    std::string key;
+    std::function<void(BenchmarkHarness&, std::size_t)> runSequential;
+    std::function<void(BenchmarkHarness&, std::size_t, int, AffinityPolicy)> runParallel;
 };
 
 /**
- * @brief Run benchmark comparing sequential vs parallel performance.
- * @param limit Upper limit for prime numbers.
- * @param threadCount Number of threads to use for parallel tests.
+ * @brief Run a parallel engine through the harness with its threads placed by a policy.
+ *
+ * Unpinned runs are the "parallel" variant; pinned runs are named after their
+ * policy, so each placement is a separate row, baseline entry and scaling series.
+ * @tparam Sieve The parallel engine.
+ * @param h The harness.
+ * @param name Engine name used in the results.
+ * @param limit Upper limit to sieve.
+ * @param threads Thread count.
+ * @param policy Placement policy.
  */
-void runBenchmark(std::size_t limit, int threadCount) {
-    std::vector<BenchmarkResult> results;
-
-    // Benchmark BasicSieve
-    {
-        auto start = std::chrono::high_resolution_clock::now();
-        BasicSieve basicSieve(limit);
-        basicSieve.generate();
-        auto end = std::chrono::high_resolution_clock::now();
-        double seqTime = std::chrono::duration<double, std::milli>(end - start).count();
-        std::size_t basicMemory = limit + 1;
-
-        start = std::chrono::high_resolution_clock::now();
-        ParallelBasicSieve parallelBasicSieve(limit, threadCount);
-        parallelBasicSieve.generate();
-        end = std::chrono::high_resolution_clock::now();
-        double parTime = std::chrono::duration<double, std::milli>(end - start).count();
-        std::size_t parallelMemory = limit + 1;
-
-        BenchmarkResult basicResult(limit, "BasicSieve", threadCount,
-                                    seqTime, parTime, basicMemory);
-        results.push_back(basicResult);
-    }
-
-    // Benchmark BitSieve
-    {
-        auto start = std::chrono::high_resolution_clock::now();
-        BitSieve bitSieve(limit);
-        bitSieve.generate();
-        auto end = std::chrono::high_resolution_clock::now();
-        double seqTime = std::chrono::duration<double, std::milli>(end - start).count();
-        std::size_t bitMemory = bitSieve.getMemoryUsage();
-
-        start = std::chrono::high_resolution_clock::now();
-        ParallelBitSieve parallelBitSieve(limit, threadCount);
-        parallelBitSieve.generate();
-        end = std::chrono::high_resolution_clock::now();
-        double parTime = std::chrono::duration<double, std::milli>(end - start).count();
-        std::size_t parallelMemory = parallelBitSieve.getMemoryUsage();
-
-        BenchmarkResult bitResult(limit, "BitSieve", threadCount,
-                                  seqTime, parTime, bitMemory);
-        results.push_back(bitResult);
-    }
-
-    // Benchmark WheelSieve
-    {
-        auto start = std::chrono::high_resolution_clock::now();
-        WheelSieve wheelSieve(limit);
-        wheelSieve.generate();
-        auto end = std::chrono::high_resolution_clock::now();
-        double seqTime = std::chrono::duration<double, std::milli>(end - start).count();
-        std::size_t wheelMemory = wheelSieve.getMemoryUsage();
-
-        start = std::chrono::high_resolution_clock::now();
-        ParallelWheelSieve parallelWheelSieve(limit, threadCount);
-        parallelWheelSieve.generate();
-        end = std::chrono::high_resolution_clock::now();
-        double parTime = std::chrono::duration<double, std::milli>(end - start).count();
-        std::size_t parallelMemory = parallelWheelSieve.getMemoryUsage();
-
-        BenchmarkResult wheelResult(limit, "WheelSieve", threadCount,
-                                    seqTime, parTime, wheelMemory);
-        results.push_back(wheelResult);
-    }
-
-    // Print results
-    std::cout << "Benchmark Results for limit " << limit << " with " << threadCount << " threads:\n\n";
-    std::cout << std::left << std::setw(15) << std::setfill(' ') << "Algorithm"
-              << std::setw(12) << "Sequential (ms)"
-              << std::setw(15) << "Parallel (ms)"
-              << std::setw(10) << "Speedup"
-              << std::setw(15) << "Seq Memory (bytes)"
-              << std::setw(18) << "Par Memory (bytes)" << "\n";
-    std::cout << std::string(65, '-') << "\n";
-
-    for (const auto &result : results) {
-        std::cout << std::left << std::setw(12) << result.algorithm
-                  << std::setw(15) << std::fixed << std::setprecision(2) << result.sequentialTime
-                  << std::setw(18) << std::fixed << std::setprecision(2) << result.parallelTime
-                  << std::setw(8) << std::fixed << std::setprecision(2) << result.speedup
-                  << std::setw(18) << result.memoryUsage << "\n";
+template <typename Sieve>
+void runParallel(BenchmarkHarness& h, const std::string& name, std::size_t limit, int threads,
+                 AffinityPolicy policy) {
+    std::string variant = policy == AffinityPolicy::None ? "parallel" : CpuTopology::policyName(policy);
+    h.run<Sieve>(name, variant, limit, threads, [=] {
+        auto sieve = std::make_unique<Sieve>(limit, threads);
+        sieve->setAffinityPolicy(policy);
+        return sieve;
+    });
+}
+
+/**
+ * @brief Spec for the wheel engines of one modulus.
+ * @tparam Modulus Wheel modulus (30, 210 or 2310).
+ * @param name Engine name used in the results.
+ * @param key Name accepted by --engines.
+ * @return The spec.
+ */
+template <std::size_t Modulus>
+EngineSpec wheelSpec(const std::string& name, const std::string& key) {
+    return {name, key,
+            [name](BenchmarkHarness& h, std::size_t limit) {
+                h.run<ModWheelSieve<Modulus>>(name, "sequential", limit, 1,
+                    [=] { return std::make_unique<ModWheelSieve<Modulus>>(limit); });
+            },
+            [name](BenchmarkHarness& h, std::size_t limit, int threads, AffinityPolicy policy) {
+                runParallel<ParallelModWheelSieve<Modulus>>(h, name, limit, threads, policy);
+            }};
+}
+
+/**
+ * @brief Build the list of benchmarked engines.
+ * @return One entry per engine family.
+ */
+std::vector<EngineSpec> makeEngineSpecs() {
+    return {
+        {"BasicSieve", "basic",
+         [](BenchmarkHarness& h, std::size_t limit) {
+             h.run<BasicSieve>("BasicSieve", "sequential", limit, 1,
+                 [=] { return std::make_unique<BasicSieve>(limit); });
+         },
+         [](BenchmarkHarness& h, std::size_t limit, int threads, AffinityPolicy policy) {
+             runParallel<ParallelBasicSieve>(h, "BasicSieve", limit, threads, policy);
+         }},
+        {"BitSieve", "bit",
+         [](BenchmarkHarness& h, std::size_t limit) {
+             h.run<BitSieve>("BitSieve", "sequential", limit, 1,
+                 [=] { return std::make_unique<BitSieve>(limit); });
+         },
+         [](BenchmarkHarness& h, std::size_t limit, int threads, AffinityPolicy policy) {
+             runParallel<ParallelBitSieve>(h, "BitSieve", limit, threads, policy);
+         }},
+        wheelSpec<30>("WheelSieve", "wheel"),
+        wheelSpec<210>("Wheel210Sieve", "wheel210"),
+        wheelSpec<2310>("Wheel2310Sieve", "wheel2310"),
+        {"AtkinSieve", "atkin",
+         [](BenchmarkHarness& h, std::size_t limit) {
+             h.run<AtkinSieve>("AtkinSieve", "sequential", limit, 1,
+                 [=] { return std::make_unique<AtkinSieve>(limit); });
+         },
+         [](BenchmarkHarness& h, std::size_t limit, int threads, AffinityPolicy policy) {
+             runParallel<ParallelAtkinSieve>(h, "AtkinSieve", limit, threads, policy);
+         }},
+    };
+}
+
+/**
+ * @brief Print which wheel modulus generated fastest for each configuration.
+ *
+ * Larger wheels store and cross off fewer candidates, but their step and
+ * index tables are larger and their sieve arrays fit a given cache level up
+ * to a higher limit, so the best modulus depends on the limit and the cache
+ * sizes; the storage column shows where each choice sits.
+ * @param os The stream to print to.
+ * @param results All benchmark results.
+ */
+void writeWheelChoice(std::ostream& os, const std::vector<EngineResult>& results) {
+    std::map<std::tuple<std::size_t, std::string, int>, std::vector<const EngineResult*>> groups;
+    for (const auto& r : results) {
+        if (r.engine == "WheelSieve" || r.engine == "Wheel210Sieve" || r.engine == "Wheel2310Sieve") {
+            groups[std::make_tuple(r.limit, r.variant, r.threads)].push_back(&r);
+        }
+    }
+
+    bool header = false;
+    for (const auto& group : groups) {
+        if (group.second.size() < 2) continue;
+        if (!header) {
+            os << "\nBest wheel by median generate time:\n";
+            header = true;
+        }
+        auto best = *std::min_element(group.second.begin(), group.second.end(),
+            [](const EngineResult* a, const EngineResult* b) { return a->generate.median < b->generate.median; });
+        os << "  limit " << std::get<0>(group.first) << ", " << std::get<1>(group.first) << " ("
+           << std::get<2>(group.first) << " threads): " << best->engine << " in "
+           << best->generate.median << " ms, storage " << best->memoryBytes << " bytes (";
+        for (std::size_t k = 0; k < group.second.size(); ++k) {
+            const EngineResult* r = group.second[k];
+            os << (k ? ", " : "") << r->engine << " " << r->generate.median << " ms";
+        }
+        os << ")\n";
+    }
+}
+
+/**
+ * @brief Run every selected engine, sequential and parallel, through the harness.
+ * @param harness The harness collecting results.
+ * @param engines The engines to run.
+ * @param limits Upper limits to sieve.
+ * @param threadCounts Thread counts for the parallel variants.
+ * @param policies Thread placements to run each parallel configuration with.
+ * @param weak Scale each limit by the thread count (weak scaling).
+ */
+void runBenchmark(BenchmarkHarness& harness, const std::vector<EngineSpec>& engines,
+                  const std::vector<std::size_t>& limits, const std::vector<int>& threadCounts,
+                  const std::vector<AffinityPolicy>& policies, bool weak) {
+    for (std::size_t limit : limits) {
+        for (const auto& engine : engines) {
+            std::cerr << "  " << engine.name << " up to " << limit << "\n";
+            if (!weak) {
+                engine.runSequential(harness, limit);
+            }
+            for (int threads : threadCounts) {
+                for (AffinityPolicy policy : policies) {
+                    engine.runParallel(harness, weak ? limit * static_cast<std::size_t>(threads) : limit,
+                                       threads, policy);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Expand a --sweep-threads mode into thread counts.
+ * @param mode "linear", "pow2" or "cores".
+ * @param maxThreads Largest thread count for linear and pow2 sweeps.
+ * @param host Host information providing physical and logical core counts.
+ * @return Sorted, unique thread counts.
+ */
+std::vector<int> threadSweep(const std::string& mode, int maxThreads, const HostInfo& host) {
+    std::set<int> counts;
+    if (mode == "linear") {
+        for (int t = 1; t <= maxThreads; ++t) counts.insert(t);
+    } else if (mode == "pow2") {
+        for (int t = 1; t <= maxThreads; t *= 2) counts.insert(t);
+        counts.insert(maxThreads);
+    } else if (mode == "cores") {
+        counts = {1, host.physicalCores, host.logicalCores};
+    } else {
+        throw std::invalid_argument("--sweep-threads must be linear, pow2 or cores");
+    }
+    counts.erase(0);
+    return std::vector<int>(counts.begin(), counts.end());
+}
+
+/**
+ * @brief Parse a --sweep-limits specification.
+ *
+ * Accepts either a decade range "FROM:TO" (e.g. 1e6:1e11, one limit per
+ * power of ten) or a comma-separated list of limits.
+ *
+ * @param spec The specification.
+ * @return The limits in ascending order.
+ */
+std::vector<std::size_t> limitSweep(const std::string& spec) {
+    auto parseLimit = [](const std::string& text) {
+        return static_cast<std::size_t>(std::stod(text));
+    };
+
+    std::vector<std::size_t> limits;
+    auto colon = spec.find(':');
+    if (colon != std::string::npos) {
+        std::size_t from = parseLimit(spec.substr(0, colon));
+        std::size_t to = parseLimit(spec.substr(colon + 1));
+        if (from == 0 || from > to) {
+            throw std::invalid_argument("--sweep-limits range must satisfy 0 < FROM <= TO");
+        }
+        for (std::size_t limit = from; limit <= to; limit *= 10) {
+            limits.push_back(limit);
+            if (limit > to / 10) break;
+        }
+    } else {
+        std::stringstream items(spec);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            limits.push_back(parseLimit(item));
+        }
+        std::sort(limits.begin(), limits.end());
+    }
+    return limits;
+}
+
+/**
+ * @brief Print command-line usage.
+ * @param program The program name.
+ */
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <limit> <threads> [options]\n";
+    std::cerr << "  <limit>: Upper limit for prime numbers\n";
+    std::cerr << "  <threads>: Number of threads to use\n";
+    std::cerr << "Options:\n";
+    std::cerr << "  --warmup N        Untimed runs per engine before measuring (default: 2)\n";
+    std::cerr << "  --reps N          Timed repetitions per engine (default: 10)\n";
+    std::cerr << "  --confidence X    Coverage of the median confidence interval (default: 0.95)\n";
+    std::cerr << "  --extract MODE    Time 'list' (getPrimes) or 'count' (getPrimeCount) extraction\n";
+    std::cerr << "  --label TEXT      Tag stored with the results (e.g. a branch name)\n";
+    std::cerr << "  --json FILE       Write results as JSON ('-' for stdout)\n";
+    std::cerr << "  --csv FILE        Write results as CSV ('-' for stdout)\n";
+    std::cerr << "  --engines LIST    Comma-separated engines to run: basic,bit,wheel,wheel210,wheel2310,\n";
+    std::cerr << "                    atkin (default: all); running several wheels reports the fastest\n";
+    std::cerr << "  --sweep-threads M Run parallel engines at thread counts 1..<threads> (linear),\n";
+    std::cerr << "                    powers of two up to <threads> (pow2) or 1/physical/logical (cores)\n";
+    std::cerr << "  --sweep-limits S  Run each limit in S: a decade range FROM:TO (e.g. 1e6:1e11)\n";
+    std::cerr << "                    or a comma-separated list; <limit> is then ignored\n";
+    std::cerr << "  --affinity LIST   Comma-separated thread placements for the parallel engines: none,\n";
+    std::cerr << "                    physical, compact, scatter (default: none); pinned runs are\n";
+    std::cerr << "                    reported as a variant named after their placement\n";
+    std::cerr << "  --weak            With --sweep-threads, sieve <limit> * threads (weak scaling)\n";
+    std::cerr << "  --scaling-csv F   Write speedup, efficiency, Karp-Flatt and ns/integer as CSV\n";
+    std::cerr << "  --perf            Collect per-phase, per-thread hardware counters (perf_event_open)\n";
+    std::cerr << "  --validate        Check counts against known pi(10^k)/pi(2^k) and compare prime-set\n";
+    std::cerr << "                    digests across engines; exit with status 3 on any disagreement\n";
+    std::cerr << "  --baseline P      Compare with a results file written by --json, or DIR/<host class>.json\n";
+    std::cerr << "                    when P is a directory; exit with status 4 on a regression\n";
+    std::cerr << "  --save-baseline P Write the results as the baseline (file, or DIR/<host class>.json)\n";
+    std::cerr << "  --max-slowdown N  Throughput drop in percent that fails --baseline (default: 5)\n";
+    std::cerr << "  --max-memory N    Memory growth in percent that fails --baseline (default: 5)\n";
+    std::cerr << "  --alpha A         Significance level of the Mann-Whitney U test (default: 0.05)\n";
+}
+
+/**
+ * @brief Write harness output to a file, or stdout when the name is "-".
+ * @return True if successful, false otherwise.
+ */
+template <typename Writer>
+bool writeOutput(const std::string& filename, Writer write) {
+    if (filename == "-") {
+        write(std::cout);
+        return true;
+    }
+    std::ofstream out(filename);
+    if (!out) {
+        std::cerr << "Error: Could not open " << filename << "\n";
+        return false;
     }
+    write(out);
+    return static_cast<bool>(out);
 }
 
 /**
@@ -124,17 +298,223 @@ void runBenchmark(std::size_t limit, int threadCount) {
  */
 int main(int argc, char **argv) {
     if (argc < 3) {
-        std::cerr << "Usage: " << argv[0] << " <limit> <threads>\n";
-        std::cerr << "  <limit>: Upper limit for prime numbers\n";
-        std::cerr << "  <threads>: Number of threads to use\n";
+        printUsage(argv[0]);
         return 1;
     }
 
-    std::size_t limit = std::stoull(argv[1]);
-    int threadCount = std::stoi(argv[2]);
+    std::size_t limit = 0;
+    int threadCount = 0;
+    BenchmarkConfig config;
+    std::string jsonFile;
+    std::string csvFile;
+    std::string scalingCsvFile;
+    std::string engineList;
+    std::string threadSweepMode;
+    std::string limitSweepSpec;
+    std::string affinityList = "none";
+    std::string baselinePath;
+    std::string saveBaselinePath;
+    GateConfig gateConfig;
+    bool weak = false;
+
+    try {
+        limit = std::stoull(argv[1]);
+        threadCount = std::stoi(argv[2]);
+
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--weak") {
+                weak = true;
+                continue;
+            }
+            if (arg == "--perf") {
+                config.perfCounters = true;
+                continue;
+            }
+            if (arg == "--validate") {
+                config.validate = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Error: Missing value for " << arg << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+            std::string value = argv[++i];
+            if (arg == "--warmup") {
+                config.warmup = std::stoull(value);
+            } else if (arg == "--reps") {
+                config.repetitions = std::stoull(value);
+            } else if (arg == "--confidence") {
+                config.confidence = std::stod(value);
+            } else if (arg == "--extract") {
+                if (value != "list" && value != "count") {
+                    std::cerr << "Error: --extract must be 'list' or 'count'\n";
+                    return 1;
+                }
+                config.extractList = (value == "list");
+            } else if (arg == "--label") {
+                config.label = value;
+            } else if (arg == "--json") {
+                jsonFile = value;
+            } else if (arg == "--csv") {
+                csvFile = value;
+            } else if (arg == "--scaling-csv") {
+                scalingCsvFile = value;
+            } else if (arg == "--engines") {
+                engineList = value;
+            } else if (arg == "--sweep-threads") {
+                threadSweepMode = value;
+            } else if (arg == "--affinity") {
+                affinityList = value;
+            } else if (arg == "--sweep-limits") {
+                limitSweepSpec = value;
+            } else if (arg == "--baseline") {
+                baselinePath = value;
+            } else if (arg == "--save-baseline") {
+                saveBaselinePath = value;
+            } else if (arg == "--max-slowdown") {
+                gateConfig.throughputThreshold = std::stod(value) / 100.0;
+            } else if (arg == "--max-memory") {
+                gateConfig.memoryThreshold = std::stod(value) / 100.0;
+            } else if (arg == "--alpha") {
+                gateConfig.alpha = std::stod(value);
+            } else {
+                std::cerr << "Error: Unknown option " << arg << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Invalid argument (" << e.what() << ")\n";
+        printUsage(argv[0]);
+        return 1;
+    }
 
-    std::cout << "Running benchmarks...\n";
-    runBenchmark(limit, threadCount);
+    if (config.repetitions == 0 || config.confidence <= 0.0 || config.confidence >= 1.0) {
+        std::cerr << "Error: --reps must be positive and --confidence in (0, 1)\n";
+        return 1;
+    }
+
+    if (weak && threadSweepMode.empty()) {
+        std::cerr << "Error: --weak requires --sweep-threads\n";
+        return 1;
+    }
+    if (!threadSweepMode.empty()) {
+        config.scaling = weak ? ScalingMode::Weak : ScalingMode::Strong;
+    } else if (!limitSweepSpec.empty()) {
+        config.scaling = ScalingMode::Size;
+    }
+
+    BenchmarkHarness harness(config);
+    harness.printFrequencyGuidance(std::cerr);
+
+    std::vector<EngineSpec> engines;
+    std::vector<std::size_t> limits{limit};
+    std::vector<int> threadCounts{threadCount};
+    std::vector<AffinityPolicy> policies;
+    try {
+        std::stringstream items(affinityList);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            AffinityPolicy policy;
+            if (!CpuTopology::parsePolicy(item, policy)) {
+                throw std::invalid_argument("--affinity takes none, physical, compact or scatter");
+            }
+            policies.push_back(policy);
+        }
+        if (policies.empty()) {
+            throw std::invalid_argument("--affinity selected no placement");
+        }
+        for (auto& engine : makeEngineSpecs()) {
+            if (engineList.empty() || ("," + engineList + ",").find("," + engine.key + ",") != std::string::npos) {
+                engines.push_back(engine);
+            }
+        }
+        if (engines.empty()) {
+            throw std::invalid_argument("--engines selected no engines (use basic,bit,wheel,wheel210,wheel2310,atkin)");
+        }
+        if (!threadSweepMode.empty()) {
+            threadCounts = threadSweep(threadSweepMode, threadCount, harness.getHostInfo());
+        }
+        if (!limitSweepSpec.empty()) {
+            limits = limitSweep(limitSweepSpec);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    // Keep stdout machine-readable when a format is written there
+    bool quiet = jsonFile == "-" || csvFile == "-" || scalingCsvFile == "-";
+    std::ostream& log = quiet ? std::cerr : std::cout;
+
+    log << "Running benchmarks...\n";
+    runBenchmark(harness, engines, limits, threadCounts, policies, weak);
+    if (limits.size() == 1 && threadCounts.size() == 1) {
+        log << "Benchmark Results for limit " << limit << " with " << threadCount << " threads:\n\n";
+    } else {
+        log << "Benchmark Results for " << limits.size() << " limit(s) and "
+            << threadCounts.size() << " thread count(s):\n\n";
+    }
+    harness.writeTable(log);
+    writeWheelChoice(log, harness.getResults());
+
+    if (!jsonFile.empty() && !writeOutput(jsonFile, [&](std::ostream& os) { harness.writeJson(os); })) {
+        return 1;
+    }
+    if (!csvFile.empty() && !writeOutput(csvFile, [&](std::ostream& os) { harness.writeCsv(os); })) {
+        return 1;
+    }
+    if (!scalingCsvFile.empty() &&
+        !writeOutput(scalingCsvFile, [&](std::ostream& os) { harness.writeScalingCsv(os); })) {
+        return 1;
+    }
+
+    if (!saveBaselinePath.empty()) {
+        std::string file = RegressionGate::baselineFile(saveBaselinePath, harness.getHostInfo());
+        if (!writeOutput(file, [&](std::ostream& os) { harness.writeJson(os); })) {
+            return 1;
+        }
+        log << "Baseline saved to " << file << "\n";
+    }
+
+    bool regressed = false;
+    if (!baselinePath.empty()) {
+        std::string file = RegressionGate::baselineFile(baselinePath, harness.getHostInfo());
+        Baseline baseline;
+        std::string error;
+        if (!Baseline::load(file, baseline, error)) {
+            std::cerr << "Error: Could not read baseline " << file << " (" << error << ")\n";
+            return 1;
+        }
+        if (!baseline.hostClass.empty() && baseline.hostClass != harness.getHostInfo().hostClass()) {
+            std::cerr << "Warning: baseline was recorded on " << baseline.hostClass << ", this host is "
+                      << harness.getHostInfo().hostClass() << "\n";
+        }
+
+        RegressionGate gate(gateConfig);
+        auto diffs = gate.compare(baseline.results, harness.getResults());
+        log << "\nBaseline: " << file;
+        if (!baseline.revision.empty()) log << " (revision " << baseline.revision << ")";
+        log << "\n";
+        gate.writeTable(log, diffs);
+        regressed = RegressionGate::hasRegressions(diffs);
+    }
+
+    if (config.validate) {
+        harness.writeValidationReport(log);
+        if (harness.hasValidationFailures()) {
+            std::cerr << "\nVALIDATION FAILED: at least one engine produced wrong primes\n";
+            harness.writeValidationReport(std::cerr);
+            return 3;
+        }
+    }
+
+    if (regressed) {
+        std::cerr << "\nPERFORMANCE REGRESSION: see the comparison with the baseline above\n";
+        return 4;
+    }
 
     return 0;
-}
\ No newline at end of file
+}
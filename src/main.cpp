@@ -1,15 +1,300 @@
 #include "BasicSieve.hpp"
 #include "BitSieve.hpp"
 #include "WheelSieve.hpp"
+#include "AtkinSieve.hpp"
 #include "ParallelBasicSieve.hpp"
 #include "ParallelBitSieve.hpp"
 #include "ParallelWheelSieve.hpp"
+#include "ParallelAtkinSieve.hpp"
+#include "CacheTopology.hpp"
+#include "CpuBudget.hpp"
+#include "CpuTopology.hpp"
+#include "MemoryTracker.hpp"
+#include "MetricsRegistry.hpp"
+#include "PerfCounters.hpp"
+#include "PrimeOracle.hpp"
+#include "ProgressReporter.hpp"
+#include "TraceRecorder.hpp"
 #include <CLI/CLI.hpp>
 #include <fmt/format.h>
 #include <iostream>
+#include <fstream>
 #include <chrono>
+#include <memory>
 #include <string>
-#include <fstream>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @struct RunOptions
+ * @brief Output options shared by every sieve engine.
+ */
+struct RunOptions {
+    std::size_t limit;
+    bool showCount;
+    bool showTime;
+    bool showList;
+    std::string outputFile;
+    std::size_t perLine;
+    bool perfCounters;
+    std::string statsJsonFile;
+    std::string traceFile;
+    bool progress;
+    int progressIntervalMs;
+    std::string metricsFile;
+    bool validate;
+    AffinityPolicy affinity;
+};
+
+/**
+ * @brief Construct, run and report on one sieve engine.
+ * @param name Engine name used in the output (e.g. "Parallel BitSieve").
+ * @param makeSieve Factory returning a std::unique_ptr to a fresh engine.
+ * @param options Output options.
+ * @return Process exit code.
+ */
+template <typename Sieve, typename Factory>
+int runSieve(const std::string& name, Factory makeSieve, const RunOptions& options) {
+    constexpr bool isParallel = std::is_base_of<ParallelSieveBase, Sieve>::value;
+
+    // Counters are attached to the OpenMP team before the engine runs
+    std::unique_ptr<ThreadPerfCounters> counters;
+    if (options.perfCounters) {
+        int teamSize = isParallel ? omp_get_max_threads() : 1;
+        counters = std::make_unique<ThreadPerfCounters>(teamSize);
+    }
+
+    // Per-thread timeline, recorded by TraceScope inside the engines
+    std::unique_ptr<TraceRecorder> trace;
+    if (!options.traceFile.empty()) {
+        trace = std::make_unique<TraceRecorder>();
+        TraceRecorder::setActive(trace.get());
+    }
+    // Declared after trace, so early returns deactivate it before it is destroyed
+    struct TraceDeactivation {
+        bool active;
+        ~TraceDeactivation() {
+            if (active) TraceRecorder::setActive(nullptr);
+        }
+    } traceDeactivation{trace != nullptr};
+
+    std::unique_ptr<ProgressReporter> progress;
+    if (options.progress) {
+        progress = std::make_unique<ProgressReporter>(ProgressReporter::stderrPrinter(),
+                                                      std::chrono::milliseconds(options.progressIntervalMs));
+        if constexpr (!isParallel) {
+            fmt::print(stderr, "Warning: progress is only reported by the parallel engines\n");
+        }
+    }
+
+    // Live and peak heap per phase (allocator hook in MemoryTrackerHook.cpp)
+    MemoryTracker memory;
+
+    // Start timer
+    auto startTime = std::chrono::high_resolution_clock::now();
+
+    std::unique_ptr<Sieve> sieve;
+    {
+        TraceScope scope("construct", "phase");
+        if (counters) counters->beginPhase("construct");
+        memory.beginPhase("construct");
+        sieve = makeSieve();
+        memory.endPhase();
+        if (counters) counters->endPhase();
+    }
+
+    if constexpr (isParallel) {
+        sieve->setProgressReporter(progress.get());
+        sieve->setAffinityPolicy(options.affinity);
+        for (const auto& warning : CpuBudget::host().warnings(sieve->getThreadCount())) {
+            fmt::print(stderr, "Warning: {}\n", warning);
+        }
+    }
+
+    // The parallel BitSieve writes the file while it sieves; the other engines write it afterwards
+    constexpr bool streamsOutput = std::is_same<Sieve, ParallelBitSieve>::value;
+    OutputStats outputStats;
+    bool saved = true;
+
+    {
+        TraceScope scope("generate", "phase");
+        if (counters) counters->beginPhase("generate");
+        memory.beginPhase("generate");
+        if constexpr (streamsOutput) {
+            if (!options.outputFile.empty()) {
+                saved = sieve->generateToFile(options.outputFile, &outputStats);
+            } else {
+                sieve->generate();
+            }
+        } else {
+            sieve->generate();
+        }
+        memory.endPhase();
+        if (counters) counters->endPhase();
+    }
+    if (!saved) {
+        fmt::print(stderr, "Error: Could not save primes to {}\n", options.outputFile);
+        return 1;
+    }
+    
+    // Only count when a count is reported; lists and files stream from the sieve
+    bool needCount = options.showCount || options.validate || (!options.showList && options.outputFile.empty());
+    std::size_t primeCount = 0;
+    if (needCount) {
+        TraceScope scope("count", "phase");
+        if (counters) counters->beginPhase("count");
+        memory.beginPhase("count");
+        primeCount = sieve->getPrimeCount();
+        memory.endPhase();
+        if (counters) counters->endPhase();
+    }
+    std::size_t memoryUsage = sieve->getMemoryUsage();
+    
+    // Stop timer
+    auto endTime = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+    
+    // Output results
+    if (options.showCount || (!options.showList && options.outputFile.empty())) {
+        fmt::print("Found {} prime numbers up to {} (using {})\n", primeCount, options.limit, name);
+    }
+    
+    if (options.showTime) {
+        fmt::print("Execution time: {} ms\n", duration.count());
+        fmt::print("Memory usage: {} bytes\n", memoryUsage);
+        if constexpr (isParallel) {
+            fmt::print("Threads used: {}\n", sieve->getThreadCount());
+            fmt::print("Parallel processing: {}\n", sieve->isParallelEnabled() ? "Yes" : "No");
+        }
+    }
+    
+    if (options.showList) {
+        fmt::print("Prime numbers up to {} (using {}):\n", options.limit, name);
+        sieve->printPrimes(options.perLine);
+    }
+    
+    if (!options.outputFile.empty()) {
+        if (!streamsOutput) {
+            TraceScope scope("output", "phase");
+            if (counters) counters->beginPhase("output");
+            memory.beginPhase("output");
+            saved = sieve->savePrimesToFile(options.outputFile, &outputStats);
+            memory.endPhase();
+            if (counters) counters->endPhase();
+        }
+        if (saved) {
+            fmt::print("Primes saved to {}\n", options.outputFile);
+            if (options.showTime) {
+                fmt::print("Output: {} bytes in {:.3f} s ({:.1f} MB/s, {})\n",
+                           outputStats.bytesWritten, outputStats.seconds,
+                           outputStats.throughputMBps(), outputStats.backend);
+            }
+        } else {
+            fmt::print(stderr, "Error: Could not save primes to {}\n", options.outputFile);
+            return 1;
+        }
+    }
+
+    if (options.showTime) {
+        fmt::print("Phase breakdown:\n{}", sieve->getStats().toText());
+        fmt::print("Memory breakdown:\n{}", memory.toText());
+    }
+
+    if (!options.statsJsonFile.empty()) {
+        std::ofstream statsFile(options.statsJsonFile);
+        if (!statsFile) {
+            fmt::print(stderr, "Error: Could not write statistics to {}\n", options.statsJsonFile);
+            return 1;
+        }
+        statsFile << sieve->getStats().toJson() << "\n";
+    }
+
+    if (counters) {
+        fmt::print("{}", counters->toText());
+    }
+
+    if (!options.metricsFile.empty()) {
+        MetricsRegistry& registry = MetricsRegistry::global();
+        registry.gauge("prime_sieve_memory_bytes", "Sieve storage of the engine in use")
+            .set(static_cast<double>(memoryUsage));
+        registry.gauge("prime_sieve_peak_heap_bytes", "Peak live heap over all phases of the run")
+            .set(static_cast<double>(memory.overallPeakBytes()));
+        if (!registry.writeOpenMetrics(options.metricsFile)) {
+            fmt::print(stderr, "Error: Could not write metrics to {}\n", options.metricsFile);
+            return 1;
+        }
+    }
+
+    if (trace) {
+        TraceRecorder::setActive(nullptr);
+        if (!trace->writeJson(options.traceFile)) {
+            fmt::print(stderr, "Error: Could not write trace to {}\n", options.traceFile);
+            return 1;
+        }
+        std::size_t dropped = trace->droppedEvents();
+        if (dropped > 0) {
+            fmt::print(stderr, "Warning: trace ring buffers overflowed, {} oldest events dropped\n", dropped);
+        }
+    }
+
+    // Runs last so the reference sieve stays out of the metrics and trace
+    if (options.validate) {
+        std::string message;
+        bool countOk = PrimeOracle::checkCount(options.limit, primeCount, message);
+        fmt::print("Validation: {}\n", message);
+
+        PrimeDigest digest = PrimeDigest::of(sieve->getPrimes());
+        if (digest.count != primeCount) {
+            countOk = false;
+            message = fmt::format("getPrimeCount() returned {} but getPrimes() listed {} primes",
+                                  primeCount, digest.count);
+        }
+        bool digestOk = true;
+        std::string verdict = "reference engine";
+        if constexpr (!std::is_same<Sieve, BitSieve>::value) {
+            // Cross-check the prime set against the sequential bit sieve
+            BitSieve reference(options.limit);
+            PrimeDigest expected = PrimeDigest::of(reference.getPrimes());
+            digestOk = digest == expected;
+            verdict = digestOk ? "matches BitSieve" : "MISMATCH";
+            if (!digestOk) {
+                fmt::print(stderr, "Error: {} found {}, BitSieve found {}\n", name,
+                           digest.toString(), expected.toString());
+            }
+        }
+        fmt::print("Validation: prime set {} ({})\n", digest.toString(), verdict);
+
+        if (!countOk || !digestOk) {
+            fmt::print(stderr, "VALIDATION FAILED for {} up to {}: {}\n", name, options.limit,
+                       countOk ? "prime set differs from BitSieve" : message);
+            return 2;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Run the wheel engine of one modulus, sequential or parallel.
+ * @tparam Modulus Wheel modulus (30, 210 or 2310).
+ * @param name Engine name shown in the output.
+ * @param useParallel Run the parallel variant.
+ * @param threadCount Threads for the parallel variant (0 for auto-detect).
+ * @param options The run options.
+ * @return Process exit code.
+ */
+template <std::size_t Modulus>
+int runWheelSieve(const std::string& name, bool useParallel, int threadCount, const RunOptions& options) {
+    std::size_t limit = options.limit;
+    if (useParallel) {
+        // Create and run parallel wheel-optimized sieve
+        return runSieve<ParallelModWheelSieve<Modulus>>("Parallel " + name,
+            [&] { return std::make_unique<ParallelModWheelSieve<Modulus>>(limit, threadCount); }, options);
+    }
+    // Use sequential wheel-optimized sieve
+    return runSieve<ModWheelSieve<Modulus>>(name,
+        [&] { return std::make_unique<ModWheelSieve<Modulus>>(limit); }, options);
+}
 
 int main(int argc, char** argv) {
     std::size_t limit = 1000000;  // Default limit: 1,000,000
@@ -20,10 +305,20 @@ int main(int argc, char** argv) {
     bool useSegmented = false;
     bool useBitSieve = false;
     bool useWheelSieve = false;
-    std::size_t segmentSize = 1000000;  // Default segment size: 1,000,000
+    std::size_t wheelModulus = 30;
+    bool useAtkinSieve = false;
+    std::size_t segmentSize = 0;  // Default: derived from the L2 cache size
     std::size_t perLine = 10;  // Default primes per line for output
     int threadCount = 0;  // Default: auto-detect
     bool useParallel = true;  // Default: enable parallel processing
+    std::string affinityName = "none";  // Default: placement left to the OS
+    bool perfCounters = false;
+    std::string statsJsonFile;
+    std::string traceFile;
+    bool showProgress = false;
+    int progressIntervalMs = 1000;
+    std::string metricsFile;
+    bool validate = false;
 
     CLI::App app{"Prime Number Finder using Sieve of Eratosthenes"};
 
@@ -41,7 +336,8 @@ int main(int argc, char** argv) {
     
     app.add_flag("--segmented", useSegmented, "Use segmented sieve for large ranges");
     
-    app.add_option("--segment-size", segmentSize, "Segment size for segmented sieve")
+    app.add_option("--segment-size", segmentSize,
+                   "Integers per segment/block of the segmented and parallel engines (default: L2 share in bits)")
         ->check(CLI::PositiveNumber);
     
     app.add_option("--per-line", perLine, "Number of primes to print per line")
@@ -49,258 +345,110 @@ int main(int argc, char** argv) {
     
     app.add_flag("--bit-sieve", useBitSieve, "Use bit-optimized sieve for memory efficiency");
     
-    app.add_flag("--wheel-sieve", useWheelSieve, "Use 2,3,5-wheel factorization for performance");
+    app.add_flag("--wheel-sieve", useWheelSieve, "Use wheel factorization for performance");
+    
+    app.add_option("--wheel", wheelModulus, "Wheel modulus for --wheel-sieve: 30, 210 or 2310")
+        ->check(CLI::IsMember(std::vector<std::size_t>{30, 210, 2310}));
+    
+    app.add_flag("--atkin-sieve", useAtkinSieve, "Use the segmented Sieve of Atkin");
     
     app.add_option("--threads", threadCount, "Number of threads to use (0 for auto-detect)")
         ->check(CLI::PositiveNumber);
     
-    app.add_flag("--parallel", useParallel, "Enable parallel processing (default)")
-        ->default_val(true);
+    app.add_flag("--parallel,!--no-parallel", useParallel,
+                 "Enable (default) or disable parallel processing");
+    
+    app.add_option("--affinity", affinityName,
+                   "Pin threads: none (default), physical (one per core, no SMT siblings), "
+                   "compact (fill a core's siblings first) or scatter (spread over cores first)")
+        ->check(CLI::IsMember(std::vector<std::string>{"none", "physical", "compact", "scatter"}));
+    
+    app.add_flag("--perf-counters", perfCounters,
+                 "Report per-phase hardware counters (cycles, cache/TLB/branch misses) via perf_event_open");
+    
+    app.add_option("--stats-json", statsJsonFile,
+                   "Write per-phase timings and cross-off counts as JSON to a file");
+    
+    app.add_option("--trace", traceFile,
+                   "Write a per-thread timeline in Chrome trace format (open in Perfetto)");
+    
+    app.add_flag("--progress", showProgress,
+                 "Report percent done, primes found, rate and ETA to stderr while sieving");
+    
+    app.add_option("--progress-interval", progressIntervalMs, "Milliseconds between progress updates")
+        ->check(CLI::PositiveNumber);
+    
+    app.add_option("--metrics", metricsFile,
+                   "Write counters and histograms in OpenMetrics text format to a file ('-' for stdout)");
     
-    app.add_flag("--no-parallel", [](bool no_parallel) { return !no_parallel; }, "Disable parallel processing");
+    app.add_flag("--validate", validate,
+                 "Check the count against known pi(10^k)/pi(2^k) and the prime set against BitSieve");
     
     app.add_flag("--thread-info", [](bool) { 
         std::cout << "System information:\n";
         std::cout << "  Logical cores: " << std::thread::hardware_concurrency() << "\n";
         std::cout << "  Max OpenMP threads: " << omp_get_max_threads() << "\n";
+        std::cout << CpuBudget::host().toText();
+        std::cout << CpuTopology::host().toText();
+        std::cout << CacheTopology::host().toText();
         return true; 
-    }, "Display thread information and exit");
+    }, "Display thread and cache information and exit");
 
     CLI11_PARSE(app, argc, argv);
 
-    // Start timer
-    auto startTime = std::chrono::high_resolution_clock::now();
+    if (segmentSize > 0) {
+        CacheTopology::setSegmentOverride(segmentSize);
+    }
+
+    AffinityPolicy affinity = AffinityPolicy::None;
+    CpuTopology::parsePolicy(affinityName, affinity);
+    if (affinity == AffinityPolicy::Physical && threadCount == 0) {
+        // One thread per physical core the budget leaves us
+        threadCount = std::min(CpuTopology::host().physicalCores(), CpuBudget::host().availableCpus());
+    }
+
+    RunOptions options{limit, showCount, showTime, showList, outputFile, perLine, perfCounters,
+                       statsJsonFile, traceFile, showProgress, progressIntervalMs,
+                       metricsFile, validate, affinity};
 
     try {
-        std::vector<std::size_t> primes;
-        std::size_t memoryUsage = 0;
-        
         if (useBitSieve) {
             if (useParallel) {
                 // Create and run parallel bit-optimized sieve
-                ParallelBitSieve sieve(limit, threadCount);
-                sieve.generate();
-                
-                // Get primes and memory usage
-                primes = sieve.getPrimes();
-                memoryUsage = sieve.getMemoryUsage();
-                
-                // Stop timer
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-                
-                // Output results
-                if (showCount || (!showList && outputFile.empty())) {
-                    fmt::print("Found {} prime numbers up to {} (using Parallel BitSieve)\n", primes.size(), limit);
-                }
-                
-                if (showTime) {
-                    fmt::print("Execution time: {} ms\n", duration.count());
-                    fmt::print("Memory usage: {} bytes\n", memoryUsage);
-                    fmt::print("Threads used: {}\n", threadCount);
-                    fmt::print("Parallel processing: {}\n", useParallel ? "Yes" : "No");
-                }
-                
-                if (showList) {
-                    fmt::print("Prime numbers up to {} (using Parallel BitSieve):\n", limit);
-                    sieve.printPrimes(perLine);
-                }
-                
-                if (!outputFile.empty()) {
-                    if (sieve.savePrimesToFile(outputFile)) {
-                        fmt::print("Primes saved to {}\n", outputFile);
-                    } else {
-                        fmt::print(stderr, "Error: Could not save primes to {}\n", outputFile);
-                        return 1;
-                    }
-                }
-            } else {
-                // Use sequential bit-optimized sieve
-                BitSieve sieve(limit);
-                sieve.generate();
-                
-                // Get primes and memory usage
-                primes = sieve.getPrimes();
-                memoryUsage = sieve.getMemoryUsage();
-                
-                // Stop timer
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-                
-                // Output results
-                if (showCount || (!showList && outputFile.empty())) {
-                    fmt::print("Found {} prime numbers up to {} (using BitSieve)\n", primes.size(), limit);
-                }
-                
-                if (showTime) {
-                    fmt::print("Execution time: {} ms\n", duration.count());
-                    fmt::print("Memory usage: {} bytes\n", memoryUsage);
-                }
-                
-                if (showList) {
-                    fmt::print("Prime numbers up to {} (using BitSieve):\n", limit);
-                    sieve.printPrimes(perLine);
-                }
-                
-                if (!outputFile.empty()) {
-                    if (sieve.savePrimesToFile(outputFile)) {
-                        fmt::print("Primes saved to {}\n", outputFile);
-                    } else {
-                        fmt::print(stderr, "Error: Could not save primes to {}\n", outputFile);
-                        return 1;
-                    }
-                }
+                return runSieve<ParallelBitSieve>("Parallel BitSieve",
+                    [&] { return std::make_unique<ParallelBitSieve>(limit, threadCount); }, options);
             }
+            // Use sequential bit-optimized sieve
+            return runSieve<BitSieve>("BitSieve",
+                [&] { return std::make_unique<BitSieve>(limit); }, options);
         } else if (useWheelSieve) {
+            switch (wheelModulus) {
+            case 210:
+                return runWheelSieve<210>("Wheel210Sieve", useParallel, threadCount, options);
+            case 2310:
+                return runWheelSieve<2310>("Wheel2310Sieve", useParallel, threadCount, options);
+            default:
+                return runWheelSieve<30>("WheelSieve", useParallel, threadCount, options);
+            }
+        } else if (useAtkinSieve) {
             if (useParallel) {
-                // Create and run parallel wheel-optimized sieve
-                ParallelWheelSieve sieve(limit, threadCount);
-                sieve.generate();
-                
-                // Get primes and memory usage
-                primes = sieve.getPrimes();
-                memoryUsage = sieve.getMemoryUsage();
-                
-                // Stop timer
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-                
-                // Output results
-                if (showCount || (!showList && outputFile.empty())) {
-                    fmt::print("Found {} prime numbers up to {} (using Parallel WheelSieve)\n", primes.size(), limit);
-                }
-                
-                if (showTime) {
-                    fmt::print("Execution time: {} ms\n", duration.count());
-                    fmt::print("Memory usage: {} bytes\n", memoryUsage);
-                    fmt::print("Threads used: {}\n", threadCount);
-                    fmt::print("Parallel processing: {}\n", useParallel ? "Yes" : "No");
-                }
-                
-                if (showList) {
-                    fmt::print("Prime numbers up to {} (using Parallel WheelSieve):\n", limit);
-                    sieve.printPrimes(perLine);
-                }
-                
-                if (!outputFile.empty()) {
-                    if (sieve.savePrimesToFile(outputFile)) {
-                        fmt::print("Primes saved to {}\n", outputFile);
-                    } else {
-                        fmt::print(stderr, "Error: Could not save primes to {}\n", outputFile);
-                        return 1;
-                    }
-                }
-            } else {
-                // Use sequential wheel-optimized sieve
-                WheelSieve sieve(limit);
-                sieve.generate();
-                
-                // Get primes and memory usage
-                primes = sieve.getPrimes();
-                memoryUsage = sieve.getMemoryUsage();
-                
-                // Stop timer
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-                
-                // Output results
-                if (showCount || (!showList && outputFile.empty())) {
-                    fmt::print("Found {} prime numbers up to {} (using WheelSieve)\n", primes.size(), limit);
-                }
-                
-                if (showTime) {
-                    fmt::print("Execution time: {} ms\n", duration.count());
-                    fmt::print("Memory usage: {} bytes\n", memoryUsage);
-                }
-                
-                if (showList) {
-                    fmt::print("Prime numbers up to {} (using WheelSieve):\n", limit);
-                    sieve.printPrimes(perLine);
-                }
-                
-                if (!outputFile.empty()) {
-                    if (sieve.savePrimesToFile(outputFile)) {
-                        fmt::print("Primes saved to {}\n", outputFile);
-                    } else {
-                        fmt::print(stderr, "Error: Could not save primes to {}\n", outputFile);
-                        return 1;
-                    }
-                }
+                // Create and run parallel Sieve of Atkin
+                return runSieve<ParallelAtkinSieve>("Parallel AtkinSieve",
+                    [&] { return std::make_unique<ParallelAtkinSieve>(limit, threadCount); }, options);
             }
+            // Use sequential Sieve of Atkin
+            return runSieve<AtkinSieve>("AtkinSieve",
+                [&] { return std::make_unique<AtkinSieve>(limit); }, options);
         } else {
             if (useParallel) {
                 // Create and run parallel basic sieve
-                ParallelBasicSieve sieve(limit, threadCount);
-                sieve.generate();
-                
-                // Get primes
-                primes = sieve.getPrimes();
-                
-                // Stop timer
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-                
-                // Output results
-                if (showCount || (!showList && outputFile.empty())) {
-                    fmt::print("Found {} prime numbers up to {} (using Parallel BasicSieve)\n", primes.size(), limit);
-                }
-                
-                if (showTime) {
-                    fmt::print("Execution time: {} ms\n", duration.count());
-                    fmt::print("Threads used: {}\n", threadCount);
-                    fmt::print("Parallel processing: {}\n", useParallel ? "Yes" : "No");
-                }
-                
-                if (showList) {
-                    fmt::print("Prime numbers up to {} (using Parallel BasicSieve):\n", limit);
-                    sieve.printPrimes(perLine);
-                }
-                
-                if (!outputFile.empty()) {
-                    if (sieve.savePrimesToFile(outputFile)) {
-                        fmt::print("Primes saved to {}\n", outputFile);
-                    } else {
-                        fmt::print(stderr, "Error: Could not save primes to {}\n", outputFile);
-                        return 1;
-                    }
-                }
-            } else {
-                // Use sequential basic sieve
-                BasicSieve sieve(limit);
-                sieve.generate();
-                
-                // Get primes
-                primes = sieve.getPrimes();
-                
-                // Stop timer
-                auto endTime = std::chrono::high_resolution_clock::now();
-                auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
-                
-                // Output results
-                if (showCount || (!showList && outputFile.empty())) {
-                    fmt::print("Found {} prime numbers up to {} (using BasicSieve)\n", primes.size(), limit);
-                }
-                
-                if (showTime) {
-                    fmt::print("Execution time: {} ms\n", duration.count());
-                }
-                
-                if (showList) {
-                    fmt::print("Prime numbers up to {} (using BasicSieve):\n", limit);
-                    sieve.printPrimes(perLine);
-                }
-                
-                if (!outputFile.empty()) {
-                    if (sieve.savePrimesToFile(outputFile)) {
-                        fmt::print("Primes saved to {}\n", outputFile);
-                    } else {
-                        fmt::print(stderr, "Error: Could not save primes to {}\n", outputFile);
-                        return 1;
-                    }
-                }
+                return runSieve<ParallelBasicSieve>("Parallel BasicSieve",
+                    [&] { return std::make_unique<ParallelBasicSieve>(limit, threadCount); }, options);
             }
+            // Use sequential basic sieve
+            return runSieve<BasicSieve>("BasicSieve",
+                [&] { return std::make_unique<BasicSieve>(limit); }, options);
         }
-
     } catch (const std::exception& e) {
         fmt::print(stderr, "Error: {}\n", e.what());
         return 1;
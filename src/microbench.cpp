@@ -0,0 +1,216 @@
+#include "BasicSieve.hpp"
+#include "BitSieve.hpp"
+#include "WheelSieve.hpp"
+#include "AtkinSieve.hpp"
+#include "AsyncPrimeWriter.hpp"
+#include "CacheTopology.hpp"
+#include "SieveStats.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Microbenchmarks for the individual sieve kernels. Crossing-off cases are
+// parameterized by prime size class relative to a segment, using the same
+// tier limits the engines derive from this host's caches (CacheTopology).
+
+namespace {
+
+// Primes crossed off per iteration in the crossing-off cases
+constexpr std::size_t PRIMES_PER_CLASS = 256;
+
+/**
+ * @brief Exposes the protected BasicSieve storage to the kernels.
+ */
+class BasicKernels : public BasicSieve {
+public:
+    using BasicSieve::BasicSieve;
+    using BasicSieve::getSieve;
+};
+
+/**
+ * @brief Exposes the protected BitSieve bit operations to the kernels.
+ */
+class BitKernels : public BitSieve {
+public:
+    using BitSieve::BitSieve;
+    using BitSieve::clearBit;
+    using BitSieve::getBit;
+};
+
+/**
+ * @brief Exposes the protected WheelSieve stepping to the kernels.
+ */
+class WheelKernels : public WheelSieve {
+public:
+    using WheelSieve::WheelSieve;
+    using WheelSieve::getNextWheelNumber;
+};
+
+/**
+ * @brief Get sieving primes of one size class.
+ * @param sizeClass 0 = small, 1 = medium, 2 = large (SieveStats tiers).
+ * @return The first PRIMES_PER_CLASS primes of the class.
+ */
+const std::vector<std::size_t>& classPrimes(int sizeClass) {
+    static std::vector<std::size_t> classes[SieveStats::TIER_COUNT];
+    std::vector<std::size_t>& primes = classes[sizeClass];
+    if (primes.empty()) {
+        const CacheTopology& topology = CacheTopology::host();
+        const std::size_t lowerBounds[SieveStats::TIER_COUNT] = {
+            7, topology.smallPrimeLimit(), topology.mediumPrimeLimit()};
+        std::size_t low = lowerBounds[sizeClass];
+        BitSieve sieve(low + 64 * PRIMES_PER_CLASS * 32);
+        for (std::size_t p : sieve.getPrimes()) {
+            if (p >= low && primes.size() < PRIMES_PER_CLASS) {
+                primes.push_back(p);
+            }
+        }
+    }
+    return primes;
+}
+
+/**
+ * @brief Cross off one segment of vector<bool> storage.
+ */
+void BM_CrossOffBool(benchmark::State& state) {
+    const auto& primes = classPrimes(static_cast<int>(state.range(0)));
+    std::size_t segmentSize = CacheTopology::host().segmentIndices();
+    std::size_t low = segmentSize * 8;  // A few segments away from the start of the sieve
+    std::size_t high = low + segmentSize - 1;
+    BasicKernels sieve(high);
+    std::vector<bool>& bits = sieve.getSieve();
+
+    std::size_t crossOffs = 0;
+    for (auto _ : state) {
+        for (std::size_t p : primes) {
+            for (std::size_t i = (low + p - 1) / p * p; i <= high; i += p) {
+                bits[i] = false;
+            }
+            crossOffs += SieveStats::multiplesInRange((low + p - 1) / p * p, high, p);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(crossOffs));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * segmentSize / 8));
+    state.SetLabel(SieveStats::tierName(static_cast<std::size_t>(state.range(0))));
+}
+BENCHMARK(BM_CrossOffBool)->DenseRange(0, 2);
+
+/**
+ * @brief Cross off one segment of uint64_t words with BitSieve::clearBit.
+ */
+void BM_CrossOffBits(benchmark::State& state) {
+    const auto& primes = classPrimes(static_cast<int>(state.range(0)));
+    std::size_t segmentSize = CacheTopology::host().segmentIndices();
+    std::size_t low = segmentSize * 8;
+    std::size_t high = low + segmentSize - 1;
+    BitKernels sieve(high);
+
+    std::size_t crossOffs = 0;
+    for (auto _ : state) {
+        for (std::size_t p : primes) {
+            for (std::size_t i = (low + p - 1) / p * p; i <= high; i += p) {
+                sieve.clearBit(i);
+            }
+            crossOffs += SieveStats::multiplesInRange((low + p - 1) / p * p, high, p);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(crossOffs));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * segmentSize / 8));
+    state.SetLabel(SieveStats::tierName(static_cast<std::size_t>(state.range(0))));
+}
+BENCHMARK(BM_CrossOffBits)->DenseRange(0, 2);
+
+/**
+ * @brief Step through the 2,3,5 wheel with WheelSieve::getNextWheelNumber.
+ */
+void BM_WheelStepping(benchmark::State& state) {
+    std::size_t limit = static_cast<std::size_t>(state.range(0));
+    WheelKernels sieve(limit);
+
+    std::size_t steps = 0;
+    for (auto _ : state) {
+        std::size_t n = 7;
+        while (n <= limit) {
+            n = sieve.getNextWheelNumber(n);
+            ++steps;
+        }
+        benchmark::DoNotOptimize(n);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(steps));
+}
+BENCHMARK(BM_WheelStepping)->RangeMultiplier(10)->Range(100000, 10000000);
+
+/**
+ * @brief Extract the prime list from a generated sieve.
+ */
+template <typename Sieve>
+void BM_Extraction(benchmark::State& state) {
+    std::size_t limit = static_cast<std::size_t>(state.range(0));
+    Sieve sieve(limit);
+    sieve.generate();
+
+    for (auto _ : state) {
+        std::vector<std::size_t> primes = sieve.getPrimes();
+        benchmark::DoNotOptimize(primes.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (limit + 1)));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sieve.getMemoryUsage()));
+}
+BENCHMARK_TEMPLATE(BM_Extraction, BasicSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_Extraction, BitSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_Extraction, WheelSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_Extraction, AtkinSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+
+/**
+ * @brief Count the primes of a generated sieve.
+ */
+template <typename Sieve>
+void BM_Counting(benchmark::State& state) {
+    std::size_t limit = static_cast<std::size_t>(state.range(0));
+    Sieve sieve(limit);
+    sieve.generate();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sieve.getPrimeCount());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (limit + 1)));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * sieve.getMemoryUsage()));
+}
+BENCHMARK_TEMPLATE(BM_Counting, BasicSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_Counting, BitSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_Counting, WheelSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+BENCHMARK_TEMPLATE(BM_Counting, AtkinSieve)->RangeMultiplier(10)->Range(100000, 10000000);
+
+/**
+ * @brief Format primes into AsyncPrimeWriter buffers (written to /dev/null).
+ */
+void BM_Formatting(benchmark::State& state) {
+    std::size_t limit = static_cast<std::size_t>(state.range(0));
+    BitSieve sieve(limit);
+    std::vector<std::size_t> primes = sieve.getPrimes();
+
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        AsyncPrimeWriter writer(AsyncPrimeWriter::DEFAULT_BUFFER_SIZE, AsyncPrimeWriter::DEFAULT_BUFFER_COUNT,
+                                AsyncPrimeWriter::Backend::Thread);
+        if (!writer.open("/dev/null")) {
+            state.SkipWithError("could not open /dev/null");
+            break;
+        }
+        for (std::size_t p : primes) {
+            writer.write(p);
+        }
+        writer.close();
+        bytes += writer.getStats().bytesWritten;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * primes.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_Formatting)->RangeMultiplier(10)->Range(1000000, 100000000)->Unit(benchmark::kMillisecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
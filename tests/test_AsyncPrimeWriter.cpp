@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "../include/AsyncPrimeWriter.hpp"
+#include "../include/BitSieve.hpp"
+#include "../include/ParallelBitSieve.hpp"
+#include "../include/SieveStats.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+class AsyncPrimeWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test file saving with output statistics and buffer rollover
+TEST_F(AsyncPrimeWriterTest, FileSavingReportsOutputStats) {
+    BitSieve sieve(10000);
+    sieve.generate();
+    
+    std::string filename = "test_bit_primes_stats.txt";
+    OutputStats stats;
+    ASSERT_TRUE(sieve.savePrimesToFile(filename, &stats));
+    ASSERT_EQ(stats.primesWritten, sieve.getPrimeCount());
+    ASSERT_FALSE(stats.backend.empty());
+    
+    // Write the same primes through a writer with tiny buffers so that
+    // many buffers are cycled through the background backend
+    std::string smallBufferFile = "test_bit_primes_small_buffers.txt";
+    AsyncPrimeWriter writer(64, 2, AsyncPrimeWriter::Backend::Thread);
+    ASSERT_TRUE(writer.open(smallBufferFile));
+    for (std::size_t prime : sieve.getPrimes()) {
+        writer.write(prime);
+    }
+    ASSERT_TRUE(writer.close());
+    ASSERT_EQ(writer.getStats().bytesWritten, stats.bytesWritten);
+    
+    std::ifstream first(filename);
+    std::ifstream second(smallBufferFile);
+    std::string firstContents((std::istreambuf_iterator<char>(first)), std::istreambuf_iterator<char>());
+    std::string secondContents((std::istreambuf_iterator<char>(second)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(firstContents.size(), stats.bytesWritten);
+    ASSERT_EQ(firstContents, secondContents);
+    
+    // Clean up
+    std::remove(filename.c_str());
+    std::remove(smallBufferFile.c_str());
+}
+
+// Test that writing while sieving produces the same file as writing afterwards
+TEST_F(AsyncPrimeWriterTest, FileSavingWhileSieving) {
+    BitSieve reference(1000000);
+    reference.generate();
+    std::string expectedFile = "test_bit_primes_after.txt";
+    ASSERT_TRUE(reference.savePrimesToFile(expectedFile));
+    
+    std::string streamedFile = "test_bit_primes_streamed.txt";
+    ParallelBitSieve sieve(1000000, 2);
+    OutputStats stats;
+    ASSERT_TRUE(sieve.generateToFile(streamedFile, &stats));
+    ASSERT_TRUE(sieve.isGenerated());
+    ASSERT_EQ(stats.primesWritten, reference.getPrimeCount());
+    
+    std::ifstream expected(expectedFile);
+    std::ifstream streamed(streamedFile);
+    std::string expectedContents((std::istreambuf_iterator<char>(expected)), std::istreambuf_iterator<char>());
+    std::string streamedContents((std::istreambuf_iterator<char>(streamed)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(streamedContents, expectedContents);
+    
+    // Clean up
+    std::remove(expectedFile.c_str());
+    std::remove(streamedFile.c_str());
+}
+
+// Test that a file that cannot be opened fails before any sieving
+TEST_F(AsyncPrimeWriterTest, FileSavingWhileSievingToBadPath) {
+    ParallelBitSieve sieve(1000000, 2);
+    ASSERT_FALSE(sieve.generateToFile("no_such_directory/primes.txt"));
+    ASSERT_FALSE(sieve.isGenerated());
+    
+    AsyncPrimeWriter writer;
+    ASSERT_FALSE(writer.open("no_such_directory/primes.txt"));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "../include/AtkinSieve.hpp"
+#include "../include/ParallelAtkinSieve.hpp"
+#include "../include/BasicSieve.hpp"
+#include "../include/PrimeOracle.hpp"
+#include <vector>
+#include <fstream>
+#include <cstdio>
+
+class AtkinSieveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test that the Atkin sieve correctly identifies small primes, including 2 and 3
+TEST_F(AtkinSieveTest, IdentifiesSmallPrimes) {
+    AtkinSieve sieve(30);
+    sieve.generate();
+
+    std::vector<std::size_t> expectedPrimes = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29};
+    ASSERT_EQ(sieve.getPrimes(), expectedPrimes);
+}
+
+// Test that isPrime rejects squares of primes and other non-square-free candidates
+TEST_F(AtkinSieveTest, IsPrimeCorrectness) {
+    AtkinSieve sieve(100000);
+    sieve.generate();
+
+    for (std::size_t p : {2, 3, 5, 7, 11, 13, 97, 65537, 99991}) {
+        ASSERT_TRUE(sieve.isPrime(p)) << p;
+    }
+    // Squares of primes solve a quadratic form an odd number of times and must be cleared
+    for (std::size_t n : {0, 1, 4, 9, 25, 49, 121, 169, 245, 289, 65535, 99999}) {
+        ASSERT_FALSE(sieve.isPrime(n)) << n;
+    }
+    ASSERT_THROW(sieve.isPrime(100001), std::invalid_argument);
+}
+
+// Test the prime count against pi(10^k)
+TEST_F(AtkinSieveTest, CountsMatchKnownValues) {
+    for (std::size_t limit : {10, 100, 1000, 10000, 100000, 1000000, 10000000}) {
+        AtkinSieve sieve(limit);
+        ASSERT_EQ(sieve.getPrimeCount(), PrimeOracle::knownPrimeCount(limit).value()) << "limit " << limit;
+    }
+}
+
+// Test agreement with BasicSieve around segment boundaries and small limits
+TEST_F(AtkinSieveTest, MatchesBasicSieve) {
+    // Small segments so that the forms and squares cross many segment boundaries
+    const std::size_t segment = 4096;
+    CacheTopology::setSegmentOverride(segment);
+    for (std::size_t limit : std::vector<std::size_t>{0, 1, 2, 3, 4, 5, 11, 12, 13, 63, 64, 65, 1000,
+                                                      segment - 1, segment, segment + 1, 2 * segment + 12345, 1000003}) {
+        BasicSieve basic(limit);
+        AtkinSieve atkin(limit);
+        EXPECT_EQ(atkin.getPrimes(), basic.getPrimes()) << "limit " << limit;
+    }
+    CacheTopology::setSegmentOverride(0);
+}
+
+// Test that the parallel variant agrees with the sequential one for several thread counts
+TEST_F(AtkinSieveTest, ParallelMatchesSequential) {
+    AtkinSieve sequential(3000000);
+    std::vector<std::size_t> expected = sequential.getPrimes();
+
+    for (int threads : {1, 2, 3, 8}) {
+        ParallelAtkinSieve parallel(3000000, threads);
+        ASSERT_EQ(parallel.getPrimes(), expected) << threads << " threads";
+        ASSERT_EQ(parallel.getStats().toggles, sequential.getStats().toggles);
+        ASSERT_EQ(parallel.getStats().totalCrossOffs(), sequential.getStats().totalCrossOffs());
+    }
+}
+
+// Test saving primes to file
+TEST_F(AtkinSieveTest, SaveToFile) {
+    AtkinSieve sieve(1000);
+    sieve.generate();
+
+    std::string filename = "test_atkin_primes.txt";
+    ASSERT_TRUE(sieve.savePrimesToFile(filename));
+
+    std::ifstream file(filename);
+    std::vector<std::size_t> filePrimes;
+    std::size_t prime;
+    while (file >> prime) {
+        filePrimes.push_back(prime);
+    }
+    file.close();
+    std::remove(filename.c_str());
+
+    ASSERT_EQ(filePrimes, sieve.getPrimes());
+}
+
+// Test memory usage calculation and the recorded phase statistics
+TEST_F(AtkinSieveTest, MemoryUsageAndStats) {
+    AtkinSieve sieve(1000);
+    ASSERT_EQ(sieve.getMemoryUsage(), (1000 / 64 + 1) * sizeof(uint64_t));
+
+    sieve.generate();
+    const SieveStats& stats = sieve.getStats();
+    ASSERT_GT(stats.toggles, 0u);
+    ASSERT_EQ(stats.basePrimeCount, 9u);  // 5, 7, ..., 31
+    ASSERT_NE(stats.toText().find("Quadratic forms"), std::string::npos);
+}
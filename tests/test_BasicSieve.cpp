@@ -170,6 +170,14 @@ TEST_F(BasicSieveTest, IsGenerated) {
     ASSERT_TRUE(sieve.isGenerated());
 }
 
+// Test memory usage
+TEST_F(BasicSieveTest, MemoryUsage) {
+    BasicSieve sieve(1000);
+    
+    // std::vector<bool> stores one bit per integer in [0, 1000]
+    ASSERT_EQ(sieve.getMemoryUsage(), (1001u + 7) / 8);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 #include "../include/BitSieve.hpp"
 #include "../include/BasicSieve.hpp"
+#include "../include/CacheTopology.hpp"
+#include "../include/PrimeTables.hpp"
+#include "../include/SieveStats.hpp"
+#include "../include/TieredCrossOff.hpp"
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -171,6 +175,23 @@ TEST_F(BitSieveTest, IsGenerated) {
     ASSERT_TRUE(sieve.isGenerated());
 }
 
+// Test that small queries are answered from the compile-time tables without sieving
+TEST_F(BitSieveTest, SmallPrimeFastPath) {
+    BitSieve sieve(PrimeTables::SMALL_LIMIT + 1000);
+    for (std::size_t n : {0, 1, 2, 3, 4, 97, 7919, 65521, 65535}) {
+        ASSERT_EQ(sieve.isPrime(n), PrimeTables::isPrime(n)) << n;
+    }
+    ASSERT_FALSE(sieve.isGenerated());
+    
+    // The tables agree with the sieve, including trial division above the bitmap
+    std::vector<std::size_t> primes = sieve.getPrimes();
+    ASSERT_TRUE(std::equal(PrimeTables::PRIMES.begin(), PrimeTables::PRIMES.end(), primes.begin()));
+    ASSERT_EQ(PrimeTables::countUpTo(PrimeTables::SMALL_LIMIT - 1), PrimeTables::SMALL_PRIME_COUNT);
+    for (std::size_t n = 0; n <= sieve.getLimit(); ++n) {
+        ASSERT_EQ(PrimeTables::isPrime(n), sieve.isPrime(n)) << n;
+    }
+}
+
 // Test memory usage
 TEST_F(BitSieveTest, MemoryUsage) {
     BitSieve sieve(1000);
@@ -203,6 +224,131 @@ TEST_F(BitSieveTest, CompareWithBasicSieve) {
     ASSERT_EQ(bitPrimes, basicPrimes);
 }
 
+// Test per-phase statistics recorded during generation
+TEST_F(BitSieveTest, PhaseStatistics) {
+    BitSieve sieve(1000000);
+    sieve.generate();
+    
+    const SieveStats& stats = sieve.getStats();
+    
+    // The sieving primes are the 168 primes up to sqrt(1000000) = 1000
+    ASSERT_EQ(stats.basePrimeCount, 168u);
+    
+    // Every sieving prime is below the small-prime limit
+    ASSERT_GT(stats.crossOffs[0], 0u);
+    ASSERT_EQ(stats.crossOffs[1], 0u);
+    ASSERT_EQ(stats.crossOffs[2], 0u);
+    
+    // Each prime crosses off its multiples from max(p*p, 1001) to the limit
+    std::size_t expected = 0;
+    for (std::size_t p : BasicSieve(1000).getPrimes()) {
+        std::size_t start = std::max(p * p, (1000 / p + 1) * p);
+        expected += SieveStats::multiplesInRange(start, 1000000, p);
+    }
+    ASSERT_EQ(stats.totalCrossOffs(), expected);
+    
+    ASSERT_GE(stats.sievingSeconds(), 0.0);
+    ASSERT_NE(stats.toJson().find("\"base_prime_count\": 168"), std::string::npos);
+}
+
+// Test that all three crossing-off tiers, including the bucketed large primes, sieve correctly
+TEST_F(BitSieveTest, TieredCrossOffMatchesBasicSieve) {
+    // 4096-integer segments: small < 256 <= medium < 4096 <= large
+    CacheTopology::setSegmentOverride(4096);
+    BitSieve sieve(30000000);
+    sieve.generate();
+    CacheTopology::setSegmentOverride(0);
+    
+    const SieveStats& stats = sieve.getStats();
+    ASSERT_EQ(stats.smallPrimeLimit, 256u);
+    ASSERT_EQ(stats.mediumPrimeLimit, 4096u);
+    ASSERT_GT(stats.crossOffs[0], 0u);
+    ASSERT_GT(stats.crossOffs[1], 0u);
+    ASSERT_GT(stats.crossOffs[2], 0u);
+    
+    BasicSieve basic(30000000);
+    ASSERT_EQ(sieve.getPrimes(), basic.getPrimes());
+}
+
+// Test that every tier clears bits only inside the segment being sieved
+TEST_F(BitSieveTest, TieredCrossOffStaysInSegment) {
+    // 1024-integer segments: primes from 1024 up to sqrt(high) are large, and
+    // most of their squares lie far beyond the ring of buckets
+    SieveStats stats;
+    stats.smallPrimeLimit = 64;
+    stats.mediumPrimeLimit = 1024;
+    const std::size_t low = 1000003;
+    const std::size_t high = 4000000;
+    std::vector<std::size_t> primes;
+    BasicSieve base(2000);
+    for (std::size_t p : base.getPrimes()) {
+        primes.push_back(p);
+    }
+    
+    std::vector<uint64_t> bits(high / 64 + 1, ~0ULL);
+    TieredCrossOff crossOff(primes, stats);
+    std::size_t segments = 0;
+    crossOff.sieve(bits, low, high, [&](std::size_t, std::size_t segmentHigh) {
+        ++segments;
+        // Nothing above the segment may have been touched yet
+        std::size_t first = segmentHigh + 1;
+        if (first > high) return;
+        uint64_t mask = ~0ULL << (first % 64);
+        ASSERT_EQ(bits[first / 64] & mask, mask) << "segment ending at " << segmentHigh;
+        for (std::size_t w = first / 64 + 1; w < bits.size(); ++w) {
+            ASSERT_EQ(bits[w], ~0ULL) << "segment ending at " << segmentHigh << ", word " << w;
+        }
+    });
+    EXPECT_GT(segments, 2000u);
+    
+    // The large tier clears each multiple of each large prime in range exactly once
+    std::size_t expectedLarge = 0;
+    for (std::size_t p : primes) {
+        if (p < stats.mediumPrimeLimit) continue;
+        std::size_t start = std::max(p * p, (low + p - 1) / p * p);
+        if (start <= high) expectedLarge += (high - start) / p + 1;
+    }
+    EXPECT_EQ(crossOff.getCrossOffs()[2], expectedLarge);
+}
+
+// Test that generateStep() resumes where it stopped and answers queries below its frontier
+TEST_F(BitSieveTest, TimeSlicedGeneration) {
+    CacheTopology::setSegmentOverride(4096);
+    const std::size_t limit = 1000003;
+    BitSieve stepped(limit);
+    BitSieve timed(limit);
+    BitSieve finished(limit);
+    CacheTopology::setSegmentOverride(0);
+    BasicSieve basic(limit);
+    std::vector<std::size_t> expected = basic.getPrimes();
+    
+    std::size_t steps = 0;
+    std::size_t frontier = 0;
+    while (!stepped.generateStep(StepBudget::ofSegments(3))) {
+        ++steps;
+        ASSERT_GT(stepped.getFrontier(), frontier);
+        ASSERT_LT(stepped.getFrontier(), limit);
+        frontier = stepped.getFrontier();
+        EXPECT_EQ(stepped.isPrime(frontier), basic.isPrime(frontier));
+        EXPECT_EQ(stepped.isPrime(frontier - 1), basic.isPrime(frontier - 1));
+        ASSERT_FALSE(stepped.isGenerated());
+    }
+    EXPECT_GT(steps, 50u);
+    EXPECT_EQ(stepped.getFrontier(), limit);
+    EXPECT_EQ(stepped.getPrimes(), expected);
+    
+    while (!timed.generateStep(StepBudget::ofTime(std::chrono::microseconds(50)))) {
+    }
+    EXPECT_EQ(timed.getPrimes(), expected);
+    
+    // generate() finishes a pass that was started in steps
+    ASSERT_FALSE(finished.generateStep(StepBudget::ofSegments(1)));
+    finished.generate();
+    EXPECT_TRUE(finished.isGenerated());
+    EXPECT_EQ(finished.getPrimes(), expected);
+    EXPECT_TRUE(finished.generateStep(StepBudget::ofSegments(1)));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
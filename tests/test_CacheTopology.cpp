@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include "../include/BitSieve.hpp"
+#include "../include/CacheTopology.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+class CacheTopologyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test that cache sizes are parsed from sysfs and drive the segment size and tier limits
+TEST_F(CacheTopologyTest, CacheTopologyFromSysfs) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "prime_sieve_test_cache";
+    fs::remove_all(dir);
+    auto writeCache = [&](int index, const char* level, const char* type, const char* size, const char* shared) {
+        fs::path entry = dir / ("index" + std::to_string(index));
+        fs::create_directories(entry);
+        std::ofstream(entry / "level") << level << "\n";
+        std::ofstream(entry / "type") << type << "\n";
+        std::ofstream(entry / "size") << size << "\n";
+        std::ofstream(entry / "coherency_line_size") << "64\n";
+        std::ofstream(entry / "shared_cpu_list") << shared << "\n";
+    };
+    writeCache(0, "1", "Data", "48K", "0,64");
+    writeCache(1, "1", "Instruction", "32K", "0,64");
+    writeCache(2, "2", "Unified", "2048K", "0,64");
+    writeCache(3, "3", "Unified", "105M", "0-31,64-95");
+
+    CacheTopology topology = CacheTopology::fromSysfs(dir.string());
+    fs::remove_all(dir);
+
+    ASSERT_EQ(topology.getSource(), "sysfs");
+    ASSERT_EQ(topology.getCaches().size(), 4u);
+    ASSERT_EQ(topology.l1dBytes(), 48u * 1024);
+    ASSERT_EQ(topology.l2BytesPerCpu(), 1024u * 1024);  // Shared by two SMT siblings
+    ASSERT_EQ(topology.l3BytesPerCpu(), 105u * 1024 * 1024 / 64);
+    ASSERT_EQ(topology.blockIndices(), 48u * 1024 * 8);
+    ASSERT_EQ(topology.segmentIndices(), 1024u * 1024 * 8);
+    ASSERT_EQ(topology.smallPrimeLimit(), 48u * 1024 * 8 / 16);
+
+    // A missing directory leaves the defaults
+    CacheTopology none = CacheTopology::fromSysfs((dir / "missing").string());
+    ASSERT_TRUE(none.getCaches().empty());
+    ASSERT_EQ(none.segmentIndices(), CacheTopology::DEFAULT_L2_BYTES * 8);
+
+    // The engines take their tier limits from the host
+    BitSieve sieve(1000);
+    ASSERT_EQ(sieve.getStats().mediumPrimeLimit, CacheTopology::host().segmentIndices());
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "../include/CpuBudget.hpp"
+#include <filesystem>
+#include <fstream>
+
+class CpuBudgetTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test that cgroup quotas, the affinity mask and OMP_NUM_THREADS bound the default thread count
+TEST_F(CpuBudgetTest, CpuBudgetFromCgroups) {
+    namespace fs = std::filesystem;
+    fs::path root = fs::temp_directory_path() / "prime_sieve_test_cgroup";
+    fs::remove_all(root);
+    fs::create_directories(root / "kubepods" / "pod1");
+    fs::create_directories(root / "cpu,cpuacct" / "docker");
+    std::ofstream(root / "kubepods" / "cpu.max") << "600000 100000\n";
+    std::ofstream(root / "kubepods" / "pod1" / "cpu.max") << "400000 100000\n";
+    std::ofstream(root / "cpu.max") << "max 100000\n";
+    std::ofstream(root / "cpu,cpuacct" / "docker" / "cpu.cfs_quota_us") << "150000\n";
+    std::ofstream(root / "cpu,cpuacct" / "docker" / "cpu.cfs_period_us") << "100000\n";
+    std::ofstream(root / "v2") << "0::/kubepods/pod1\n";
+    std::ofstream(root / "v1") << "4:memory:/docker\n3:cpu,cpuacct:/docker\n";
+    std::ofstream(root / "none") << "0::/\n";
+
+    // cgroup v2: the pod's 4-CPU quota is tighter than its parent's 6 on a 128-CPU node
+    CpuBudget pod = CpuBudget::fromSources(128, 128, root.string(), (root / "v2").string(), nullptr);
+    ASSERT_DOUBLE_EQ(pod.getQuotaCpus(), 4.0);
+    ASSERT_EQ(pod.availableCpus(), 4);
+    ASSERT_EQ(pod.recommendedThreads(), 4);
+    ASSERT_TRUE(pod.warnings(4).empty());
+    ASSERT_EQ(pod.warnings(128).size(), 1u);
+
+    // cgroup v1: a 1.5-CPU quota rounds up, and a tighter affinity mask wins
+    CpuBudget docker = CpuBudget::fromSources(16, 16, root.string(), (root / "v1").string(), nullptr);
+    ASSERT_EQ(docker.availableCpus(), 2);
+    CpuBudget pinned = CpuBudget::fromSources(16, 1, root.string(), (root / "v1").string(), nullptr);
+    ASSERT_EQ(pinned.availableCpus(), 1);
+    ASSERT_EQ(pinned.limitedBy(), "affinity mask");
+
+    // No quota: the affinity mask and OMP_NUM_THREADS decide
+    CpuBudget open = CpuBudget::fromSources(8, 0, root.string(), (root / "none").string(), "3,2");
+    fs::remove_all(root);
+    ASSERT_DOUBLE_EQ(open.getQuotaCpus(), 0.0);
+    ASSERT_EQ(open.availableCpus(), 8);
+    ASSERT_EQ(open.recommendedThreads(), 3);
+    ASSERT_EQ(CpuBudget::parseOmpNumThreads("abc"), 0);
+    ASSERT_EQ(CpuBudget::parseOmpNumThreads("12"), 12);
+    ASSERT_GE(CpuBudget::host().availableCpus(), 1);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
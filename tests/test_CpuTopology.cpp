@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "../include/BitSieve.hpp"
+#include "../include/CpuTopology.hpp"
+#include "../include/ParallelBitSieve.hpp"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class CpuTopologyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test that the SMT topology is read from sysfs and each placement policy orders the CPUs
+TEST_F(CpuTopologyTest, CpuTopologyPlacement) {
+    namespace fs = std::filesystem;
+    fs::path dir = fs::temp_directory_path() / "prime_sieve_test_cpus";
+    fs::remove_all(dir);
+    // Two packages of two cores with two SMT siblings each; cpu k and k + 4 share a core
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        fs::path topology = dir / ("cpu" + std::to_string(cpu)) / "topology";
+        fs::create_directories(topology);
+        std::ofstream(topology / "core_id") << (cpu % 2) << "\n";
+        std::ofstream(topology / "physical_package_id") << (cpu % 4) / 2 << "\n";
+    }
+    CpuTopology topology = CpuTopology::fromSysfs(dir.string(), {0, 1, 2, 3, 4, 5, 6, 7});
+    fs::remove_all(dir);
+
+    ASSERT_EQ(topology.getSource(), "sysfs");
+    ASSERT_EQ(topology.physicalCores(), 4);
+    ASSERT_EQ(topology.packages(), 2);
+    ASSERT_EQ(topology.threadsPerCore(), 2);
+
+    ASSERT_TRUE(topology.placement(AffinityPolicy::None, 4).empty());
+    ASSERT_EQ(topology.placement(AffinityPolicy::Compact, 4), (std::vector<int>{0, 4, 1, 5}));
+    ASSERT_EQ(topology.placement(AffinityPolicy::Scatter, 6), (std::vector<int>{0, 2, 1, 3, 4, 6}));
+    // Physical never uses a second sibling, even with more threads than cores
+    ASSERT_EQ(topology.placement(AffinityPolicy::Physical, 6), (std::vector<int>{0, 2, 1, 3, 0, 2}));
+
+    AffinityPolicy policy = AffinityPolicy::None;
+    ASSERT_TRUE(CpuTopology::parsePolicy("scatter", policy));
+    ASSERT_EQ(policy, AffinityPolicy::Scatter);
+    ASSERT_FALSE(CpuTopology::parsePolicy("spread", policy));
+
+    // Pinned parallel runs find the same primes and leave the caller's mask alone
+    std::vector<int> before = CpuTopology::allowedCpus();
+    ParallelBitSieve pinned(2000000, 3);
+    pinned.setAffinityPolicy(AffinityPolicy::Compact);
+    BitSieve reference(2000000);
+    ASSERT_EQ(pinned.getPrimes(), reference.getPrimes());
+    ASSERT_EQ(CpuTopology::allowedCpus(), before);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "../include/BasicSieve.hpp"
+#include "../include/BitSieve.hpp"
+#include "../include/WheelSieve.hpp"
+#include "../include/AtkinSieve.hpp"
+#include "../include/ParallelBasicSieve.hpp"
+#include "../include/ParallelBitSieve.hpp"
+#include "../include/ParallelWheelSieve.hpp"
+#include "../include/ParallelAtkinSieve.hpp"
+#include "../include/CacheTopology.hpp"
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Differential property test: every engine, sequential and parallel, must
+// agree with an independent reference sieve on random limits, windows and
+// thread counts. The seed and iteration count can be overridden with
+// PRIME_SIEVE_FUZZ_SEED and PRIME_SIEVE_FUZZ_ITERATIONS; build with
+// -DPRIME_SIEVE_SANITIZE=thread to run the parallel engines under TSan.
+
+namespace {
+
+// Segment size pinned by the fixture, so the parallel engines split a limit
+// into the same blocks on every host whatever its L2 size
+constexpr std::size_t SEGMENT_INDICES = 256 * 1024;
+
+/**
+ * @brief What one engine reports for a limit and a window [low, high].
+ */
+struct Observation {
+    std::size_t count = 0;
+    std::vector<std::size_t> primes;
+    std::vector<bool> window;  // isPrime(n) for n in [low, high]
+};
+
+/**
+ * @brief One test case.
+ */
+struct Case {
+    std::size_t limit;
+    int threads;
+    std::size_t low;
+    std::size_t high;
+
+    std::string describe(std::uint64_t seed, int iteration) const {
+        std::ostringstream oss;
+        oss << "seed " << seed << ", iteration " << iteration << ": limit " << limit << ", threads "
+            << threads << ", window [" << low << ", " << high << "]";
+        return oss.str();
+    }
+};
+
+using Engine = std::function<Observation(const Case&)>;
+
+/**
+ * @brief Generate once, then query the count, the listing and a window of isPrime().
+ */
+template <typename Sieve>
+Observation observe(Sieve& sieve, const Case& c) {
+    Observation obs;
+    sieve.generate();
+    obs.count = sieve.getPrimeCount();
+    obs.primes = sieve.getPrimes();
+    for (std::size_t n = c.low; n <= c.high; ++n) {
+        obs.window.push_back(sieve.isPrime(n));
+    }
+    return obs;
+}
+
+template <typename Sieve>
+Engine sequential() {
+    return [](const Case& c) {
+        Sieve sieve(c.limit);
+        return observe(sieve, c);
+    };
+}
+
+template <typename Sieve>
+Engine parallel() {
+    return [](const Case& c) {
+        Sieve sieve(c.limit, c.threads);
+        return observe(sieve, c);
+    };
+}
+
+/**
+ * @brief Independent reference: plain sieve over a byte array.
+ */
+Observation reference(const Case& c) {
+    std::vector<char> composite(c.limit + 1, 0);
+    Observation obs;
+    for (std::size_t n = 2; n <= c.limit; ++n) {
+        if (composite[n]) continue;
+        obs.primes.push_back(n);
+        if (n > c.limit / n) continue;
+        for (std::size_t m = n * n; m <= c.limit; m += n) {
+            composite[m] = 1;
+        }
+    }
+    obs.count = obs.primes.size();
+    for (std::size_t n = c.low; n <= c.high; ++n) {
+        obs.window.push_back(n >= 2 && !composite[n]);
+    }
+    return obs;
+}
+
+std::uint64_t envOr(const char* name, std::uint64_t fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+/**
+ * @brief Draw a limit, biased towards the boundaries the engines special-case.
+ */
+std::size_t randomLimit(std::mt19937_64& rng) {
+    static const std::size_t smallPrimes[] = {2, 3, 5, 7, 11, 13, 31, 61, 127, 251, 1021, 2039};
+    std::uniform_int_distribution<int> kind(0, 5);
+    std::uniform_int_distribution<int> offset(-2, 2);
+    switch (kind(rng)) {
+    case 0:  // Tiny limits, including 0 and 1
+        return std::uniform_int_distribution<std::size_t>(0, 130)(rng);
+    case 1: {  // Around a 64-bit word boundary
+        std::size_t words = std::uniform_int_distribution<std::size_t>(1, 20000)(rng);
+        return static_cast<std::size_t>(static_cast<long long>(words * 64) + offset(rng));
+    }
+    case 2: {  // Around the square of a prime (sqrtLimit changes)
+        std::size_t p = smallPrimes[std::uniform_int_distribution<std::size_t>(0, 11)(rng)];
+        return static_cast<std::size_t>(static_cast<long long>(p * p) + offset(rng));
+    }
+    case 3: {  // Around a multiple of the 2,3,5 wheel
+        std::size_t turns = std::uniform_int_distribution<std::size_t>(1, 40000)(rng);
+        return static_cast<std::size_t>(static_cast<long long>(turns * 30) + offset(rng));
+    }
+    case 4:  // Several parallel blocks
+        return std::uniform_int_distribution<std::size_t>(SEGMENT_INDICES / 2, SEGMENT_INDICES * 2)(rng);
+    default:
+        return std::uniform_int_distribution<std::size_t>(0, 200000)(rng);
+    }
+}
+
+Case randomCase(std::mt19937_64& rng) {
+    Case c;
+    c.limit = randomLimit(rng);
+    c.threads = std::uniform_int_distribution<int>(1, 8)(rng);
+    std::size_t width = std::uniform_int_distribution<std::size_t>(0, 256)(rng);
+    c.low = std::uniform_int_distribution<std::size_t>(0, c.limit)(rng);
+    c.high = std::min(c.limit, c.low + width);
+    return c;
+}
+
+} // namespace
+
+class DifferentialTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        CacheTopology::setSegmentOverride(SEGMENT_INDICES);
+    }
+
+    void TearDown() override {
+        CacheTopology::setSegmentOverride(0);
+    }
+
+    std::vector<std::pair<std::string, Engine>> engines = {
+        {"BasicSieve", sequential<BasicSieve>()},
+        {"BitSieve", sequential<BitSieve>()},
+        {"WheelSieve", sequential<WheelSieve>()},
+        {"Wheel210Sieve", sequential<Wheel210Sieve>()},
+        {"Wheel2310Sieve", sequential<Wheel2310Sieve>()},
+        {"AtkinSieve", sequential<AtkinSieve>()},
+        {"ParallelBasicSieve", parallel<ParallelBasicSieve>()},
+        {"ParallelBitSieve", parallel<ParallelBitSieve>()},
+        {"ParallelWheelSieve", parallel<ParallelWheelSieve>()},
+        {"ParallelWheel210Sieve", parallel<ParallelWheel210Sieve>()},
+        {"ParallelWheel2310Sieve", parallel<ParallelWheel2310Sieve>()},
+        {"ParallelAtkinSieve", parallel<ParallelAtkinSieve>()},
+    };
+
+    void check(const Case& c, const std::string& trace) {
+        Observation expected = reference(c);
+        for (const auto& engine : engines) {
+            SCOPED_TRACE(engine.first + ", " + trace);
+            Observation actual = engine.second(c);
+            ASSERT_EQ(actual.count, expected.count);
+            ASSERT_EQ(actual.primes, expected.primes);
+            ASSERT_EQ(actual.window, expected.window);
+        }
+    }
+};
+
+// Test every engine on fixed edge cases before the random ones
+TEST_F(DifferentialTest, EdgeCases) {
+    const std::size_t limits[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 24, 25, 29, 30, 31, 63, 64, 65, 127, 128, 129};
+    for (std::size_t limit : limits) {
+        for (int threads : {1, 2, 3, 8}) {
+            check(Case{limit, threads, 0, limit}, "edge case");
+        }
+    }
+}
+
+// Test every engine against the reference on random limits, windows and thread counts
+TEST_F(DifferentialTest, RandomCasesAgree) {
+    std::uint64_t seed = envOr("PRIME_SIEVE_FUZZ_SEED", std::random_device{}());
+    int iterations = static_cast<int>(envOr("PRIME_SIEVE_FUZZ_ITERATIONS", 40));
+    std::mt19937_64 rng(seed);
+    RecordProperty("seed", std::to_string(seed));
+
+    for (int i = 0; i < iterations; ++i) {
+        Case c = randomCase(rng);
+        check(c, c.describe(seed, i));
+        if (HasFatalFailure()) {
+            return;
+        }
+    }
+}
+
+// Test that the sieving state carried from block to block stays exact over many small blocks
+TEST_F(DifferentialTest, CarriedStateAcrossSmallSegments) {
+    // 4096-integer segments put every chunk of every engine over several blocks
+    CacheTopology::setSegmentOverride(4096);
+    for (std::size_t limit : {40000u, 1000003u}) {
+        for (int threads : {1, 2, 3}) {
+            check(Case{limit, threads, limit / 2, limit}, "small segments");
+        }
+    }
+}
+
+// Test that repeated parallel runs of one engine are deterministic
+TEST_F(DifferentialTest, ParallelRunsAreStable) {
+    const std::size_t limit = SEGMENT_INDICES * 3 + 17;
+    ParallelBitSieve first(limit, 4);
+    std::vector<std::size_t> expected = first.getPrimes();
+    for (int run = 0; run < 5; ++run) {
+        ParallelBitSieve again(limit, 4);
+        ASSERT_EQ(again.getPrimes(), expected) << "run " << run;
+    }
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
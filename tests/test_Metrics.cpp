@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "../include/BasicSieve.hpp"
+#include "../include/MetricsRegistry.hpp"
+#include <cstdint>
+#include <string>
+
+class MetricsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test that generate() is published to the metrics registry
+TEST_F(MetricsTest, MetricsExport) {
+    MetricsRegistry& registry = MetricsRegistry::global();
+    Counter& sieved = registry.counter("prime_sieve_integers_sieved", "");
+    std::uint64_t before = sieved.value();
+    
+    BasicSieve sieve(1000);
+    sieve.generate();
+    
+    ASSERT_EQ(sieved.value() - before, 1001u);
+    
+    std::string text = registry.toOpenMetrics();
+    ASSERT_NE(text.find("# TYPE prime_sieve_integers_sieved counter"), std::string::npos);
+    ASSERT_NE(text.find("prime_sieve_generate_seconds_bucket{le=\"+Inf\"}"), std::string::npos);
+    ASSERT_NE(text.find("process_resident_memory_bytes"), std::string::npos);
+    ASSERT_EQ(text.substr(text.size() - 6), "# EOF\n");
+}
+
+// Test histogram bucketing
+TEST_F(MetricsTest, HistogramBuckets) {
+    Histogram histogram({1.0, 2.0, 4.0});
+    histogram.observe(0.5);
+    histogram.observe(2.0);
+    histogram.observe(3.0);
+    histogram.observe(10.0);
+    
+    ASSERT_EQ(histogram.bucketCount(0), 1u);
+    ASSERT_EQ(histogram.bucketCount(1), 1u);
+    ASSERT_EQ(histogram.bucketCount(2), 1u);
+    ASSERT_EQ(histogram.bucketCount(3), 1u);
+    ASSERT_EQ(histogram.getCount(), 4u);
+    ASSERT_DOUBLE_EQ(histogram.getSum(), 15.5);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include "../include/BitSieve.hpp"
+#include "../include/PrimeOracle.hpp"
+#include <string>
+#include <vector>
+
+class PrimeOracleTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test the oracle table against the sieve at every tabulated limit it can reach quickly
+TEST_F(PrimeOracleTest, OracleKnownCounts) {
+    for (std::size_t limit = 1; limit <= 10000000; limit *= 10) {
+        BitSieve sieve(limit);
+        std::string message;
+        ASSERT_TRUE(PrimeOracle::checkCount(limit, sieve.getPrimeCount(), message)) << message;
+    }
+    for (std::size_t limit = 2; limit <= (1u << 24); limit *= 2) {
+        BitSieve sieve(limit);
+        ASSERT_EQ(PrimeOracle::knownPrimeCount(limit).value(), sieve.getPrimeCount());
+    }
+    
+    std::string message;
+    ASSERT_FALSE(PrimeOracle::checkCount(1000, 167, message));
+    ASSERT_TRUE(PrimeOracle::checkCount(1001, 0, message));  // Not tabulated
+    ASSERT_EQ(PrimeOracle::describeLimit(1024), "2^10");
+}
+
+// Test that the prime-set digest ignores order but detects a changed set
+TEST_F(PrimeOracleTest, PrimeDigest) {
+    BitSieve sieve(10000);
+    std::vector<std::size_t> primes = sieve.getPrimes();
+    PrimeDigest digest = PrimeDigest::of(primes);
+    ASSERT_EQ(digest.count, 1229u);
+    
+    std::vector<std::size_t> reversed(primes.rbegin(), primes.rend());
+    ASSERT_EQ(PrimeDigest::of(reversed), digest);
+    
+    PrimeDigest halves = PrimeDigest::of(std::vector<std::size_t>(primes.begin(), primes.begin() + 600));
+    halves.merge(PrimeDigest::of(std::vector<std::size_t>(primes.begin() + 600, primes.end())));
+    ASSERT_EQ(halves, digest);
+    
+    primes.back() += 2;  // Same count, wrong prime
+    ASSERT_NE(PrimeDigest::of(primes), digest);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "../include/ProgressReporter.hpp"
+#include "../include/ParallelBitSieve.hpp"
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ProgressReporterTest : public ::testing::Test {
+protected:
+    std::mutex mutex;
+    std::vector<ProgressInfo> snapshots;
+
+    void SetUp() override {
+        snapshots.clear();
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+
+    /**
+     * @brief Callback that keeps every snapshot it is given.
+     */
+    ProgressReporter::Callback capture() {
+        return [this](const ProgressInfo& info) {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshots.push_back(info);
+        };
+    }
+
+    /**
+     * @brief Copy the snapshots delivered so far.
+     */
+    std::vector<ProgressInfo> delivered() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return snapshots;
+    }
+};
+
+// Test that published blocks add up across threads and finish() delivers one final snapshot
+TEST_F(ProgressReporterTest, BeginAddCompletedFinish) {
+    ProgressReporter reporter(capture(), std::chrono::milliseconds(1));
+    reporter.begin(101, 1100, 2, 25);
+
+    reporter.addCompleted(0, 400, 40);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    reporter.addCompleted(1, 350, 30);
+    reporter.addCompleted(1, 250, 13);
+
+    ProgressInfo running = reporter.sample();
+    EXPECT_EQ(running.total, 1000u);
+    EXPECT_EQ(running.completed, 1000u);
+    EXPECT_EQ(running.current, 1100u);
+    EXPECT_EQ(running.primesFound, 108u);
+    EXPECT_FALSE(running.finished);
+
+    reporter.finish();
+    std::vector<ProgressInfo> seen = delivered();
+    ASSERT_FALSE(seen.empty());
+    const ProgressInfo& last = seen.back();
+    EXPECT_TRUE(last.finished);
+    EXPECT_EQ(last.completed, 1000u);
+    EXPECT_EQ(last.primesFound, 108u);
+    EXPECT_DOUBLE_EQ(last.fraction(), 1.0);
+    EXPECT_DOUBLE_EQ(last.etaSeconds, 0.0);
+
+    // Periodic snapshots come before the final one and never go backwards
+    std::size_t completed = 0;
+    for (std::size_t i = 0; i + 1 < seen.size(); ++i) {
+        EXPECT_FALSE(seen[i].finished);
+        EXPECT_GE(seen[i].completed, completed);
+        completed = seen[i].completed;
+    }
+
+    // A second finish() has nothing left to report
+    reporter.finish();
+    EXPECT_EQ(delivered().size(), seen.size());
+}
+
+// Test that a parallel engine reports its whole range and ends at the full prime count
+TEST_F(ProgressReporterTest, ParallelSieveReportsWholeRange) {
+    ProgressReporter reporter(capture(), std::chrono::milliseconds(1));
+    ParallelBitSieve sieve(1000000, 2);
+    sieve.setProgressReporter(&reporter);
+    sieve.generate();
+
+    std::vector<ProgressInfo> seen = delivered();
+    ASSERT_FALSE(seen.empty());
+    const ProgressInfo& last = seen.back();
+    EXPECT_TRUE(last.finished);
+    EXPECT_EQ(last.total, 1000000u - 1000u);
+    EXPECT_EQ(last.completed, last.total);
+    EXPECT_EQ(last.primesFound, sieve.getPrimeCount());
+}
+
+// Test that a reporter on a sieve with parallel processing disabled still sees the whole range
+TEST_F(ProgressReporterTest, DisabledParallelismReportsWholeRange) {
+    ProgressReporter reporter(capture(), std::chrono::milliseconds(1));
+    ParallelBitSieve sieve(1000000, 4);
+    sieve.setParallelEnabled(false);
+    sieve.setProgressReporter(&reporter);
+    sieve.generate();
+
+    std::vector<ProgressInfo> seen = delivered();
+    ASSERT_FALSE(seen.empty());
+    EXPECT_TRUE(seen.back().finished);
+    EXPECT_EQ(seen.back().completed, seen.back().total);
+    EXPECT_EQ(sieve.getPrimeCount(), 78498u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "../include/RegressionGate.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class RegressionGateTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+
+    /**
+     * @brief Build a result whose repetitions spent the given times in generate().
+     */
+    static EngineResult makeResult(const std::string& engine, int threads, const std::vector<double>& generateMs) {
+        EngineResult result;
+        result.engine = engine;
+        result.variant = threads > 1 ? "parallel" : "sequential";
+        result.limit = 1000000;
+        result.threads = threads;
+        result.memoryBytes = 125008;
+        for (double ms : generateMs) {
+            PhaseSample sample;
+            sample.generate = ms;
+            result.samples.push_back(sample);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Find the single-threaded entry of one metric, or nullptr.
+     */
+    static const MetricDiff* find(const std::vector<MetricDiff>& diffs, const std::string& engine,
+                                  const std::string& metric) {
+        auto it = std::find_if(diffs.begin(), diffs.end(), [&](const MetricDiff& d) {
+            return d.engine == engine && d.metric == metric && d.threads == 1;
+        });
+        return it == diffs.end() ? nullptr : &*it;
+    }
+};
+
+// Test the U test's normal approximation against a hand-computed p-value
+TEST_F(RegressionGateTest, MannWhitneyNormalApproximation) {
+    // Ranks of b: 4, 7, 8, 9, 10, so U = 23 against a mean of 12.5 and a variance of 275 / 12
+    std::vector<double> a = {10, 11, 12, 13, 14};
+    std::vector<double> b = {12.5, 15, 16, 17, 18};
+    EXPECT_NEAR(RegressionGate::mannWhitneyGreater(a, b), 0.0184, 1e-4);
+
+    // The test is one-sided: b is not smaller than a
+    EXPECT_GT(RegressionGate::mannWhitneyGreater(b, a), 0.95);
+    EXPECT_DOUBLE_EQ(RegressionGate::mannWhitneyGreater({}, b), 1.0);
+}
+
+// Test that tied samples share their average rank and shrink the variance
+TEST_F(RegressionGateTest, MannWhitneyTies) {
+    // The two 3s both take rank 3.5; the tie correction gives a variance of 5.1 instead of 5.25
+    EXPECT_NEAR(RegressionGate::mannWhitneyGreater({1, 2, 3}, {3, 4, 5}), 0.0606, 1e-4);
+
+    // All samples tied leaves no variance and no evidence of a difference
+    EXPECT_DOUBLE_EQ(RegressionGate::mannWhitneyGreater({7, 7, 7}, {7, 7, 7}), 1.0);
+}
+
+// Test that compare() separates significant regressions from noise and new configurations
+TEST_F(RegressionGateTest, CompareVerdicts) {
+    std::vector<double> before = {100, 101, 102, 103, 104};
+    std::vector<EngineResult> baseline = {
+        makeResult("BitSieve", 1, before),
+        makeResult("WheelSieve", 1, before),
+    };
+    std::vector<EngineResult> current = {
+        makeResult("BitSieve", 1, {120, 121, 122, 123, 124}),   // 16% slower, no overlap
+        makeResult("WheelSieve", 1, {90, 108, 109, 112, 140}),  // 6% slower by the median, overlapping
+        makeResult("BitSieve", 4, {30, 31, 32}),                // Not in the baseline
+    };
+
+    RegressionGate gate;
+    std::vector<MetricDiff> diffs = gate.compare(baseline, current);
+
+    const MetricDiff* regressed = find(diffs, "BitSieve", "generate");
+    ASSERT_NE(regressed, nullptr);
+    EXPECT_EQ(regressed->verdict, MetricDiff::Verdict::Regression);
+    EXPECT_NEAR(regressed->change, 102.0 / 122.0 - 1.0, 1e-9);
+    EXPECT_LT(regressed->pValue, 0.05);
+
+    const MetricDiff* noisy = find(diffs, "WheelSieve", "generate");
+    ASSERT_NE(noisy, nullptr);
+    EXPECT_EQ(noisy->verdict, MetricDiff::Verdict::Noise);
+    EXPECT_LT(noisy->change, -0.05);
+    EXPECT_GE(noisy->pValue, 0.05);
+
+    auto added = std::find_if(diffs.begin(), diffs.end(), [](const MetricDiff& d) { return d.threads == 4; });
+    ASSERT_NE(added, diffs.end());
+    EXPECT_EQ(added->verdict, MetricDiff::Verdict::New);
+    EXPECT_EQ(std::count_if(diffs.begin(), diffs.end(), [](const MetricDiff& d) { return d.threads == 4; }), 1);
+
+    // Unchanged memory passes, and one regression fails the gate
+    const MetricDiff* memory = find(diffs, "BitSieve", "memory");
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(memory->verdict, MetricDiff::Verdict::Ok);
+    EXPECT_TRUE(RegressionGate::hasRegressions(diffs));
+    diffs.erase(std::remove_if(diffs.begin(), diffs.end(), [](const MetricDiff& d) {
+        return d.verdict == MetricDiff::Verdict::Regression;
+    }), diffs.end());
+    EXPECT_FALSE(RegressionGate::hasRegressions(diffs));
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "../include/BitSieve.hpp"
+#include "../include/CacheTopology.hpp"
+#include "../include/ParallelBitSieve.hpp"
+#include "../include/RingBuffer.hpp"
+#include "../include/SegmentPipeline.hpp"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+class SegmentPipelineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Small segments, so a modest limit streams many of them
+        CacheTopology::setSegmentOverride(4096);
+    }
+
+    void TearDown() override {
+        CacheTopology::setSegmentOverride(0);
+    }
+};
+
+// Test that the rings deliver every element exactly once, in order per producer
+TEST_F(SegmentPipelineTest, RingsUnderConcurrentProducers) {
+    const std::size_t perProducer = 20000;
+    SpscRing<std::size_t> spsc(8);
+    EXPECT_EQ(spsc.capacity(), 8u);
+    std::thread single([&] {
+        for (std::size_t i = 0; i < perProducer; ++i) {
+            std::size_t value = i;
+            while (!spsc.tryPush(value)) std::this_thread::yield();
+        }
+    });
+    for (std::size_t expected = 0; expected < perProducer;) {
+        std::size_t value = 0;
+        if (spsc.tryPop(value)) {
+            ASSERT_EQ(value, expected++);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    single.join();
+
+    const int producers = 3;
+    MpscRing<std::size_t> mpsc(5);
+    EXPECT_EQ(mpsc.capacity(), 8u);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (std::size_t i = 0; i < perProducer; ++i) {
+                std::size_t value = i * producers + p;
+                while (!mpsc.tryPush(value)) std::this_thread::yield();
+            }
+        });
+    }
+    std::vector<std::size_t> nextOf(producers, 0);
+    for (std::size_t received = 0; received < perProducer * producers;) {
+        std::size_t value = 0;
+        if (mpsc.tryPop(value)) {
+            ASSERT_EQ(value / producers, nextOf[value % producers]++);
+            ++received;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    for (auto& thread : threads) thread.join();
+    std::size_t value = 0;
+    EXPECT_FALSE(mpsc.tryPop(value));
+}
+
+// Test that streamed segments arrive in order, bounded, and hold exactly the primes
+TEST_F(SegmentPipelineTest, StreamedSegmentsMatchSequential) {
+    const std::size_t limit = 300007;
+    BitSieve reference(limit);
+    std::vector<std::size_t> expected = reference.getPrimes();
+    for (int threads : {1, 2, 3}) {
+        ParallelBitSieve sieve(limit, threads);
+        std::vector<std::size_t> primes;
+        std::size_t nextSequence = 0;
+        sieve.generateStreaming([&](const FinishedSegment& segment) {
+            ASSERT_EQ(segment.sequence, nextSequence++);
+            // A slow consumer makes the producers hit the in-flight bound
+            if (segment.sequence % 8 == 0) std::this_thread::yield();
+            segment.forEachPrime([&](std::size_t prime) { primes.push_back(prime); });
+        }, 2);
+        EXPECT_EQ(primes, expected) << threads << " threads";
+        EXPECT_EQ(sieve.getPrimes(), expected) << threads << " threads";
+
+        // A generated sieve replays the same segments
+        std::size_t replayed = 0;
+        sieve.generateStreaming([&](const FinishedSegment& segment) { replayed += segment.count(); });
+        EXPECT_EQ(replayed, expected.size());
+    }
+
+    ParallelBitSieve failing(limit, 2);
+    EXPECT_THROW(failing.generateStreaming([](const FinishedSegment& segment) {
+        if (segment.sequence == 3) throw std::runtime_error("consumer failed");
+    }), std::runtime_error);
+}
+
+// Test that streaming a sieve stepped part of the way finishes the pass before replaying it
+TEST_F(SegmentPipelineTest, StreamingFinishesSteppedPass) {
+    const std::size_t limit = 300007;
+    std::vector<std::size_t> expected = BitSieve(limit).getPrimes();
+    ParallelBitSieve sieve(limit, 2);
+    ASSERT_FALSE(sieve.generateStep(StepBudget::ofSegments(3)));
+    ASSERT_GT(sieve.getFrontier(), 0u);
+
+    // The finished sieve is replayed on the calling thread rather than re-sieved through the pipeline
+    std::thread::id caller = std::this_thread::get_id();
+    std::vector<std::size_t> primes;
+    std::size_t nextSequence = 0;
+    sieve.generateStreaming([&](const FinishedSegment& segment) {
+        ASSERT_EQ(segment.sequence, nextSequence++);
+        ASSERT_EQ(std::this_thread::get_id(), caller);
+        segment.forEachPrime([&](std::size_t prime) { primes.push_back(prime); });
+    });
+    EXPECT_EQ(primes, expected);
+    EXPECT_TRUE(sieve.isGenerated());
+    EXPECT_EQ(sieve.getFrontier(), limit);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
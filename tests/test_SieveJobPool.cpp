@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "../include/BitSieve.hpp"
+#include "../include/CacheTopology.hpp"
+#include "../include/CancellationToken.hpp"
+#include "../include/ParallelBitSieve.hpp"
+#include "../include/ParallelWheelSieve.hpp"
+#include "../include/SieveJobPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class SieveJobPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Fixed segments, so a streamed limit splits the same way on every host
+        CacheTopology::setSegmentOverride(256 * 1024);
+    }
+
+    void TearDown() override {
+        CacheTopology::setSegmentOverride(0);
+    }
+};
+
+// Test that pooled jobs of every engine deliver the same primes and run their callbacks
+TEST_F(SieveJobPoolTest, AsyncJobsComplete) {
+    const std::size_t limit = 200003;
+    std::vector<std::size_t> expected = BitSieve(limit).getPrimes();
+    SieveJobPool pool(2);
+    std::atomic<int> callbacks{0};
+    std::vector<SieveJob> jobs;
+    for (SieveEngine engine : {SieveEngine::Basic, SieveEngine::Bit, SieveEngine::Wheel, SieveEngine::Atkin}) {
+        SieveJobRequest request;
+        request.engine = engine;
+        request.limit = limit;
+        request.threads = 2;
+        jobs.push_back(pool.submit(request, [&](const SieveJobResult& result) {
+            if (result.status == JobStatus::Completed) ++callbacks;
+        }));
+    }
+    for (const auto& job : jobs) {
+        const SieveJobResult& result = job.get();
+        ASSERT_EQ(result.status, JobStatus::Completed) << result.error;
+        EXPECT_EQ(result.primes, expected);
+        EXPECT_EQ(result.primeCount, expected.size());
+    }
+    SieveJobRequest countOnly;
+    countOnly.limit = limit;
+    countOnly.keepPrimes = false;
+    SieveJobResult counted = pool.submit(countOnly).future().get();
+    EXPECT_TRUE(counted.primes.empty());
+    EXPECT_EQ(counted.primeCount, expected.size());
+
+    // Callbacks run before the result is published, so get() already waited for them
+    EXPECT_EQ(callbacks.load(), 4);
+}
+
+// Test that cancel(), deadlines and abandoned handles stop jobs between blocks
+TEST_F(SieveJobPoolTest, AsyncJobsStop) {
+    SieveJobRequest large;
+    large.limit = 400000000;
+    large.threads = 1;
+    SieveJobPool pool(1);
+
+    // Cancelled while running
+    SieveJob running = pool.submit(large);
+    SieveJob queued = pool.submit(large);
+    while (running.status() == JobStatus::Queued) std::this_thread::yield();
+    EXPECT_EQ(queued.status(), JobStatus::Queued);
+    queued.cancel();
+    EXPECT_EQ(queued.status(), JobStatus::Cancelled);
+    running.cancel();
+    EXPECT_EQ(running.get().status, JobStatus::Cancelled);
+    EXPECT_TRUE(running.get().primes.empty());
+
+    // Past its deadline
+    SieveJobRequest hurried = large;
+    hurried.timeout = std::chrono::milliseconds(1);
+    EXPECT_EQ(pool.submit(hurried).get().status, JobStatus::TimedOut);
+
+    // Every handle dropped: the callback still reports the outcome
+    auto outcome = std::make_shared<std::promise<JobStatus>>();
+    std::future<JobStatus> reported = outcome->get_future();
+    pool.submit(large, [outcome](const SieveJobResult& result) { outcome->set_value(result.status); });
+    ASSERT_EQ(reported.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+    EXPECT_EQ(reported.get(), JobStatus::Cancelled);
+}
+
+// Test that an empty handle reports no state instead of dereferencing it
+TEST_F(SieveJobPoolTest, EmptyHandleHasNoState) {
+    SieveJob empty;
+    EXPECT_FALSE(empty.valid());
+    EXPECT_EQ(empty.status(), JobStatus::Cancelled);
+    EXPECT_THROW(empty.get(), std::future_error);
+    EXPECT_THROW(empty.waitFor(std::chrono::milliseconds(1)), std::future_error);
+    EXPECT_THROW(empty.future(), std::future_error);
+    empty.cancel();
+    empty.detach();
+}
+
+// Test that a cancellation token stops the engines a job runs, and leaves them alone until it fires
+TEST_F(SieveJobPoolTest, CancellationTokenStopsSieves) {
+    // Cancelled sieves throw from generate()
+    CancellationToken token;
+    token.cancel();
+    ParallelBitSieve sieve(1000000, 2);
+    sieve.setCancellationToken(&token);
+    EXPECT_THROW(sieve.generate(), SieveCancelled);
+    EXPECT_FALSE(sieve.isGenerated());
+
+    // A token that never fires leaves a sequential run sequential and complete
+    CancellationToken idle;
+    ParallelWheelSieve sequential(1000000, 4);
+    sequential.setParallelEnabled(false);
+    sequential.setCancellationToken(&idle);
+    sequential.generate();
+    EXPECT_EQ(sequential.getPrimeCount(), 78498u);
+
+    // Streaming stops too, after handing the consumer a prefix of the segments
+    CancellationToken midway;
+    std::size_t expected = 0;
+    bool inOrder = true;
+    ParallelBitSieve streamed(1 << 24, 2);
+    streamed.setCancellationToken(&midway);
+    EXPECT_THROW(streamed.generateStreaming([&](const FinishedSegment& segment) {
+        inOrder = inOrder && segment.sequence == expected++;
+        if (expected == 3) midway.cancel();
+    }, 2), SieveCancelled);
+    EXPECT_TRUE(inOrder);
+    EXPECT_GE(expected, 3u);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "../include/BitSieve.hpp"
+#include "../include/TraceRecorder.hpp"
+#include <string>
+
+class TraceRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Setup code
+    }
+
+    void TearDown() override {
+        // Cleanup code
+    }
+};
+
+// Test that an active trace recorder captures the sieve phases
+TEST_F(TraceRecorderTest, TraceRecordsPhases) {
+    TraceRecorder recorder;
+    TraceRecorder::setActive(&recorder);
+    
+    BitSieve sieve(100000);
+    sieve.generate();
+    
+    TraceRecorder::setActive(nullptr);
+    
+    std::string json = recorder.toJson();
+    ASSERT_NE(json.find("\"traceEvents\""), std::string::npos);
+    ASSERT_NE(json.find("\"base primes\""), std::string::npos);
+    ASSERT_NE(json.find("\"small\""), std::string::npos);
+    ASSERT_EQ(recorder.droppedEvents(), 0u);
+    
+    // Nothing is recorded once the recorder is inactive
+    BitSieve untraced(1000);
+    untraced.generate();
+    ASSERT_EQ(recorder.toJson(), json);
+}
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include "../include/WheelSieve.hpp"
 #include "../include/BasicSieve.hpp"
+#include "../include/PrimeTables.hpp"
 #include <vector>
 #include <algorithm>
 #include <fstream>
@@ -184,10 +185,35 @@ TEST_F(WheelSieveTest, MemoryUsage) {
     WheelSieve sieve(1000);
     sieve.generate();
     
-    // Calculate expected memory usage
-    std::size_t expectedMemory = (1000 + 1) * sizeof(bool);
+    // Only the numbers coprime to 30 are stored, one bit each: 8 per 30 numbers
+    std::size_t expectedMemory = (1000 / 30 * 8 + 2 + 7) / 8;  // Plus 991 and 997
     
     ASSERT_EQ(sieve.getMemoryUsage(), expectedMemory);
+    
+    // Larger wheels store fewer candidates
+    Wheel210Sieve sieve210(1000000);
+    Wheel2310Sieve sieve2310(1000000);
+    WheelSieve sieve30(1000000);
+    ASSERT_LT(sieve210.getMemoryUsage(), sieve30.getMemoryUsage());
+    ASSERT_LT(sieve2310.getMemoryUsage(), sieve210.getMemoryUsage());
+}
+
+// Test that the mod 210 and mod 2310 wheels agree with BasicSieve, including the primes they skip
+TEST_F(WheelSieveTest, LargerWheelsMatchBasicSieve) {
+    for (std::size_t limit : {0, 1, 2, 6, 7, 10, 11, 12, 13, 120, 121, 210, 211, 2310, 2311, 100000}) {
+        BasicSieve basic(limit);
+        std::vector<std::size_t> expected = basic.getPrimes();
+        
+        Wheel210Sieve sieve210(limit);
+        Wheel2310Sieve sieve2310(limit);
+        ASSERT_EQ(sieve210.getPrimes(), expected) << "mod 210, limit " << limit;
+        ASSERT_EQ(sieve2310.getPrimes(), expected) << "mod 2310, limit " << limit;
+        ASSERT_EQ(sieve210.getPrimeCount(), expected.size());
+        ASSERT_EQ(sieve2310.getPrimeCount(), expected.size());
+        for (std::size_t n = 0; n <= std::min<std::size_t>(limit, 2400); ++n) {
+            ASSERT_EQ(sieve2310.isPrime(n), basic.isPrime(n)) << n;
+        }
+    }
 }
 
 // Test that WheelSieve produces the same results as BasicSieve
@@ -231,6 +257,36 @@ TEST_F(WheelSieveTest, WheelFactorizationEfficiency) {
     }
 }
 
+// Test the compile-time wheel tables against a direct computation
+TEST_F(WheelSieveTest, WheelTablesMatchCoprimeResidues) {
+    auto check = [](auto table, const std::vector<std::size_t>& factors) {
+        using Table = decltype(table);
+        std::vector<std::size_t> residues;
+        for (std::size_t r = 0; r < Table::MODULUS; ++r) {
+            bool coprime = std::none_of(factors.begin(), factors.end(), [r](std::size_t p) { return r % p == 0; });
+            if (coprime) residues.push_back(r);
+        }
+        ASSERT_EQ(std::vector<std::size_t>(Table::PRIMES.begin(), Table::PRIMES.end()), factors);
+        ASSERT_EQ(std::vector<std::size_t>(Table::RESIDUES.begin(), Table::RESIDUES.end()), residues);
+        
+        // Stepping through two turns of the wheel visits every coprime number
+        std::size_t n = 1;
+        for (std::size_t k = 0; k < 2 * Table::COUNT; ++k) {
+            ASSERT_EQ(Table::valueAt(k), n);
+            ASSERT_EQ(Table::indexOf(n), k);
+            std::size_t next = Table::next(n);
+            ASSERT_EQ(next, n + Table::STEPS[k % Table::COUNT]);
+            for (std::size_t m = n + 1; m < next; ++m) {
+                ASSERT_EQ(Table::next(m), next) << m;
+            }
+            n = next;
+        }
+    };
+    check(WheelTable<30>(), {2, 3, 5});
+    check(WheelTable<210>(), {2, 3, 5, 7});
+    check(WheelTable<2310>(), {2, 3, 5, 7, 11});
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();